@@ -62,6 +62,20 @@ typedef struct spAnimation {
 spAnimation* spAnimation_create (const char* name, int timelinesCount);
 void spAnimation_dispose (spAnimation* self);
 
+/** Animations read with spSkeletonJson lazyAnimations have only their name and duration until their timelines are decoded. This
+ * happens when spSkeletonData_findAnimation returns them, when they are played by an spAnimationState or when this is called, for
+ * example to prefetch them during a loading screen. Does nothing for other animations. Returns false if the timelines could not be
+ * decoded. May be called on any thread.
+ *
+ * Decoded timelines that are not acquired can be evicted to stay within the budget when another animation is decoded or released.
+ * When skeletons are posed with spAnimation_apply directly, use spAnimation_acquire so the timelines are kept. */
+int/*bool*/spAnimation_decode (const spAnimation* self);
+/** Decodes the timelines and keeps them from being evicted until spAnimation_release. Each call must be matched by a call to
+ * spAnimation_release, even if it returns false because the timelines could not be decoded. spAnimationState acquires the
+ * animation of each track entry. May be called on any thread. */
+int/*bool*/spAnimation_acquire (const spAnimation* self);
+void spAnimation_release (const spAnimation* self);
+
 /** Poses the skeleton at the specified time for this animation.
  * @param lastTime The last time the animation was applied.
  * @param events Any triggered events are added. */
@@ -75,12 +89,23 @@ void spAnimation_apply (const spAnimation* self, struct spSkeleton* skeleton, fl
 void spAnimation_mix (const spAnimation* self, struct spSkeleton* skeleton, float lastTime, float time, int loop,
 		spEvent** events, int* eventsCount, float alpha);
 
+/** Like spAnimation_mix, but only applies the timelines that can affect the bones set in the mask: rotate, translate, scale
+ * and flip timelines for masked bones, plus all IK constraint and event timelines. Slot, draw order and FFD timelines are
+ * skipped. Use with spSkeleton_maskBone and spSkeleton_updateBoneWorldTransform when only a few bones are needed.
+ * @param bonesMask Has an entry for each bone in the skeleton, nonzero for bones to pose. */
+void spAnimation_mixMasked (const spAnimation* self, struct spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount, float alpha, const int* bonesMask);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spAnimation Animation;
 #define Animation_create(...) spAnimation_create(__VA_ARGS__)
 #define Animation_dispose(...) spAnimation_dispose(__VA_ARGS__)
+#define Animation_decode(...) spAnimation_decode(__VA_ARGS__)
+#define Animation_acquire(...) spAnimation_acquire(__VA_ARGS__)
+#define Animation_release(...) spAnimation_release(__VA_ARGS__)
 #define Animation_apply(...) spAnimation_apply(__VA_ARGS__)
 #define Animation_mix(...) spAnimation_mix(__VA_ARGS__)
+#define Animation_mixMasked(...) spAnimation_mixMasked(__VA_ARGS__)
 #endif
 
 /**/
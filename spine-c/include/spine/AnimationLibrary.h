@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_ANIMATIONLIBRARY_H_
+#define SPINE_ANIMATIONLIBRARY_H_
+
+#include <spine/SkeletonData.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shares the animations of one skeleton data with other skeleton data that use the same bone, slot and IK constraint names,
+ * so the keys of animations common to many skeletons are stored and parsed once. */
+typedef struct spAnimationLibrary {
+	spSkeletonData* const skeletonData;
+
+#ifdef __cplusplus
+	spAnimationLibrary() :
+		skeletonData(0) {
+	}
+#endif
+} spAnimationLibrary;
+
+/* The library keeps the animations of the skeleton data decoded. The skeleton data is not owned and must outlive the library. */
+spAnimationLibrary* spAnimationLibrary_create (spSkeletonData* skeletonData);
+/* Must not be called before the skeleton data bound to the library are disposed. */
+void spAnimationLibrary_dispose (spAnimationLibrary* self);
+
+/* Adds the library's animations to the skeleton data, where they can be found with spSkeletonData_findAnimation and played by an
+ * spAnimationState like its own. Animations named like one the skeleton data already has are skipped. The bound animations share
+ * the keys of the library's animations and only store the bone, slot and IK constraint indices of the skeleton data, found by
+ * name. FFD timelines are bound to the attachment with the same skin, slot and name, events to the event with the same name if
+ * there is one. Timelines for bones, slots, IK constraints or attachments the skeleton data doesn't have are left out, as are draw
+ * order timelines unless the skeleton data has the same slots. Returns the number of timelines left out.
+ *
+ * Call before skeletons for the skeleton data are animated. */
+int spAnimationLibrary_bind (const spAnimationLibrary* self, spSkeletonData* skeletonData);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spAnimationLibrary AnimationLibrary;
+#define AnimationLibrary_create(...) spAnimationLibrary_create(__VA_ARGS__)
+#define AnimationLibrary_dispose(...) spAnimationLibrary_dispose(__VA_ARGS__)
+#define AnimationLibrary_bind(...) spAnimationLibrary_bind(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_ANIMATIONLIBRARY_H_ */
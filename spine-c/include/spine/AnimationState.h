@@ -105,6 +105,10 @@ void spAnimationState_dispose (spAnimationState* self);
 
 void spAnimationState_update (spAnimationState* self, float delta);
 void spAnimationState_apply (spAnimationState* self, struct spSkeleton* skeleton);
+/** Like spAnimationState_apply, but only applies the timelines that can affect the bones set in the mask. Events and listeners
+ * are processed as usual. See spAnimation_mixMasked.
+ * @param bonesMask Has an entry for each bone in the skeleton, nonzero for bones to pose. */
+void spAnimationState_applyMasked (spAnimationState* self, struct spSkeleton* skeleton, const int* bonesMask);
 
 void spAnimationState_clearTracks (spAnimationState* self);
 void spAnimationState_clearTrack (spAnimationState* self, int trackIndex);
@@ -123,6 +127,16 @@ spTrackEntry* spAnimationState_addAnimation (spAnimationState* self, int trackIn
 
 spTrackEntry* spAnimationState_getCurrent (spAnimationState* self, int trackIndex);
 
+/** Returns the number of bytes spAnimationState_snapshot needs. Changes when animations are set, queued or finish. */
+int spAnimationState_getSnapshotSize (const spAnimationState* self);
+/** Copies the time scale and the state of the current, queued and mixing entries of every track into the buffer, which must be
+ * at least spAnimationState_getSnapshotSize bytes and aligned for an int. Returns the number of bytes written. */
+int spAnimationState_snapshot (const spAnimationState* self, void* buffer);
+/** Replaces all tracks with the entries stored by spAnimationState_snapshot. No listener events are fired. The existing entries
+ * are reused in order and keep their rendererObject, entries are only created if the snapshot has more and disposed if it has
+ * fewer. Returns the number of bytes read. */
+int spAnimationState_restore (spAnimationState* self, const void* buffer);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spEventType EventType;
 #define ANIMATION_START SP_ANIMATION_START
@@ -136,6 +150,7 @@ typedef spAnimationState AnimationState;
 #define AnimationState_dispose(...) spAnimationState_dispose(__VA_ARGS__)
 #define AnimationState_update(...) spAnimationState_update(__VA_ARGS__)
 #define AnimationState_apply(...) spAnimationState_apply(__VA_ARGS__)
+#define AnimationState_applyMasked(...) spAnimationState_applyMasked(__VA_ARGS__)
 #define AnimationState_clearTracks(...) spAnimationState_clearTracks(__VA_ARGS__)
 #define AnimationState_clearTrack(...) spAnimationState_clearTrack(__VA_ARGS__)
 #define AnimationState_setAnimationByName(...) spAnimationState_setAnimationByName(__VA_ARGS__)
@@ -143,6 +158,9 @@ typedef spAnimationState AnimationState;
 #define AnimationState_addAnimationByName(...) spAnimationState_addAnimationByName(__VA_ARGS__)
 #define AnimationState_addAnimation(...) spAnimationState_addAnimation(__VA_ARGS__)
 #define AnimationState_getCurrent(...) spAnimationState_getCurrent(__VA_ARGS__)
+#define AnimationState_getSnapshotSize(...) spAnimationState_getSnapshotSize(__VA_ARGS__)
+#define AnimationState_snapshot(...) spAnimationState_snapshot(__VA_ARGS__)
+#define AnimationState_restore(...) spAnimationState_restore(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_ASSETCACHE_H_
+#define SPINE_ASSETCACHE_H_
+
+#include <spine/Atlas.h>
+#include <spine/SkeletonData.h>
+#include <spine/SkeletonJson.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shares atlases and skeleton data between skeletons so each file is only read once. Assets are reference counted and stay
+ * cached when no longer referenced until spAssetCache_purge, so they can be reused. Must only be used by one thread at a time. */
+typedef struct spAssetCache {
+	spParallelFor parallelFor; /* Passed to the spSkeletonJson. May be 0. */
+	int const atlasesCount;
+	int const skeletonDataCount;
+	int const hits; /* Acquires that found the asset already loaded. */
+	int const misses; /* Acquires that read the asset's file. */
+	const char* const error; /* Set when an acquire returns 0. */
+
+#ifdef __cplusplus
+	spAssetCache() :
+		parallelFor(0),
+		atlasesCount(0),
+		skeletonDataCount(0),
+		hits(0),
+		misses(0),
+		error(0) {
+	}
+#endif
+} spAssetCache;
+
+spAssetCache* spAssetCache_create ();
+/* Disposes of all the cached assets. None may still be in use. */
+void spAssetCache_dispose (spAssetCache* self);
+
+/* Returns the atlas for the path, reading it if it is not cached, or 0 if it could not be read. Must be matched by a call to
+ * spAssetCache_releaseAtlas. */
+spAtlas* spAssetCache_acquireAtlas (spAssetCache* self, const char* atlasPath);
+void spAssetCache_releaseAtlas (spAssetCache* self, spAtlas* atlas);
+
+/* Returns the skeleton data for the path and scale, reading it and its atlas if they are not cached, or 0 if either could not be
+ * read. Must be matched by a call to spAssetCache_releaseSkeletonData. */
+spSkeletonData* spAssetCache_acquireSkeletonData (spAssetCache* self, const char* skeletonPath, const char* atlasPath,
+		float scale);
+void spAssetCache_releaseSkeletonData (spAssetCache* self, spSkeletonData* skeletonData);
+
+/* Reads the skeleton data and its atlas if they are not cached, without referencing them. Returns false on failure. */
+int/*bool*/spAssetCache_preload (spAssetCache* self, const char* skeletonPath, const char* atlasPath, float scale);
+/* Disposes of the cached assets that are not referenced. */
+void spAssetCache_purge (spAssetCache* self);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spAssetCache AssetCache;
+#define AssetCache_create(...) spAssetCache_create(__VA_ARGS__)
+#define AssetCache_dispose(...) spAssetCache_dispose(__VA_ARGS__)
+#define AssetCache_acquireAtlas(...) spAssetCache_acquireAtlas(__VA_ARGS__)
+#define AssetCache_releaseAtlas(...) spAssetCache_releaseAtlas(__VA_ARGS__)
+#define AssetCache_acquireSkeletonData(...) spAssetCache_acquireSkeletonData(__VA_ARGS__)
+#define AssetCache_releaseSkeletonData(...) spAssetCache_releaseSkeletonData(__VA_ARGS__)
+#define AssetCache_preload(...) spAssetCache_preload(__VA_ARGS__)
+#define AssetCache_purge(...) spAssetCache_purge(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_ASSETCACHE_H_ */
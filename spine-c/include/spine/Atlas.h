@@ -145,18 +145,27 @@ struct spAtlas {
 
 /* Image files referenced in the atlas file will be prefixed with dir. */
 spAtlas* spAtlas_create (const char* data, int length, const char* dir, void* rendererObject);
-/* Image files referenced in the atlas file will be prefixed with the directory containing the atlas file. */
+/* Creates an atlas from data written by spAtlas_writeBinary. Returns 0 if the data is not a valid binary atlas. */
+spAtlas* spAtlas_createFromBinary (const unsigned char* data, int length, const char* dir, void* rendererObject);
+/* Image files referenced in the atlas file will be prefixed with the directory containing the atlas file. The file may be a text
+ * atlas or a binary atlas. */
 spAtlas* spAtlas_createFromFile (const char* path, void* rendererObject);
 void spAtlas_dispose (spAtlas* atlas);
 
-/* Returns 0 if the region was not found. */
+/* Returns the atlas in a binary format that loads without parsing text. The caller must free the data with _free. */
+unsigned char* spAtlas_writeBinary (const spAtlas* self, int* length);
+
+/* Returns 0 if the region was not found. Regions read from the atlas data are found using a hash index, regions added to the list
+ * afterward are searched linearly. */
 spAtlasRegion* spAtlas_findRegion (const spAtlas* self, const char* name);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spAtlas Atlas;
 #define Atlas_create(...) spAtlas_create(__VA_ARGS__)
+#define Atlas_createFromBinary(...) spAtlas_createFromBinary(__VA_ARGS__)
 #define Atlas_createFromFile(...) spAtlas_createFromFile(__VA_ARGS__)
 #define Atlas_dispose(...) spAtlas_dispose(__VA_ARGS__)
+#define Atlas_writeBinary(...) spAtlas_writeBinary(__VA_ARGS__)
 #define Atlas_findRegion(...) spAtlas_findRegion(__VA_ARGS__)
 #endif
 
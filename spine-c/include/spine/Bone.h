@@ -75,6 +75,8 @@ struct spBone {
 #endif
 };
 
+/* The yDown value of skeletons created afterward. Process wide, so it should be set once before loading. Renderers set the
+ * skeleton's yDown instead, so ones expecting y up and y down can coexist. */
 void spBone_setYDown (int/*bool*/yDown);
 int/*bool*/spBone_isYDown ();
 
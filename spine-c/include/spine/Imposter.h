@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_IMPOSTER_H_
+#define SPINE_IMPOSTER_H_
+
+#include <spine/Skeleton.h>
+#include <spine/SkeletonData.h>
+#include <spine/Atlas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns the RGBA pixels of an atlas page, 4 bytes per pixel, width * height pixels, first row first. The context is the one
+ * passed to spImposter_addAnimation. */
+typedef const unsigned char* (*spImposterPixelsProvider) (void* context, spAtlasPage* page);
+
+/* A pre-rendered animation frame. Row 0 of the frame holds the lowest skeleton y coordinates. */
+typedef struct spImposterFrame {
+	int page;
+	int x, y, width, height; /* Pixels in the page. */
+	float offsetX, offsetY; /* The skeleton position of the frame's first pixel corner, relative to the skeleton's x and y. */
+
+#ifdef __cplusplus
+	spImposterFrame() :
+		page(0),
+		x(0), y(0), width(0), height(0),
+		offsetX(0), offsetY(0) {
+	}
+#endif
+} spImposterFrame;
+
+typedef struct spImposterAnimation {
+	const spAnimation* animation;
+	int framesCount;
+	spImposterFrame* frames;
+
+#ifdef __cplusplus
+	spImposterAnimation() :
+		animation(0),
+		framesCount(0),
+		frames(0) {
+	}
+#endif
+} spImposterAnimation;
+
+typedef struct spImposterPage {
+	int width, height;
+	unsigned char* pixels; /* RGBA, 4 bytes per pixel, first row first. */
+	void* rendererObject;
+
+#ifdef __cplusplus
+	spImposterPage() :
+		width(0), height(0),
+		pixels(0),
+		rendererObject(0) {
+	}
+#endif
+} spImposterPage;
+
+/* Flipbooks of animations rendered on the CPU, drawn as a single textured quad instead of the skeleton when the skeleton is too
+ * small on screen for its meshes to matter. The renderer sets each page's rendererObject to a texture made from its pixels.
+ * Rendering is slow, so imposters are usually rendered once, written with spImposter_writeBinary and loaded with
+ * spImposter_createFromFile afterward. */
+typedef struct spImposter {
+	float const framesPerSecond;
+	float const scale; /* Pixels per skeleton unit. */
+	int pageSize; /* Width and height of new pages. A frame larger than this gets a page of its own. */
+	int padding; /* Transparent pixels around each frame. */
+	int/*bool*/premultipliedAlpha; /* Whether the atlas pages and the rendered pages use premultiplied alpha. */
+
+	int const animationsCount;
+	spImposterAnimation* const animations;
+	int const pagesCount;
+	spImposterPage* const pages;
+
+#ifdef __cplusplus
+	spImposter() :
+		framesPerSecond(0),
+		scale(0),
+		pageSize(0),
+		padding(0),
+		premultipliedAlpha(0),
+		animationsCount(0),
+		animations(0),
+		pagesCount(0),
+		pages(0) {
+	}
+#endif
+} spImposter;
+
+spImposter* spImposter_create (float framesPerSecond, float scale);
+/* Creates an imposter from data written by spImposter_writeBinary. Its animations are found by name in the skeleton data.
+ * Returns 0 if the data is not a valid imposter or an animation is not found. */
+spImposter* spImposter_createFromBinary (const unsigned char* data, int length, const spSkeletonData* skeletonData);
+/* Returns 0 if the file can't be read or spImposter_createFromBinary fails. */
+spImposter* spImposter_createFromFile (const char* path, const spSkeletonData* skeletonData);
+/* Frees the pages' pixels. The renderer must dispose of any rendererObjects first. */
+void spImposter_dispose (spImposter* self);
+
+/* Renders the animation at framesPerSecond, from time 0 up to its duration, and packs the frames into the pages. Each frame
+ * starts from the setup pose with the skeleton at 0,0, so the skeleton's pose and position are lost. Region and mesh attachments
+ * are drawn with nearest sampling and the skeleton's skin, color and flip.
+ * @param getPixels Provides the pixels of the atlas pages the attachments use.
+ * @param context Passed to getPixels, eg to keep the last page's pixels. */
+spImposterAnimation* spImposter_addAnimation (spImposter* self, spSkeleton* skeleton, const spAnimation* animation,
+		spImposterPixelsProvider getPixels, void* context);
+
+/* Returns the frames, animation names and page pixels in a binary format, so the imposter can be loaded without rendering it
+ * again. The pixels are not compressed. The caller must free the data with _free. */
+unsigned char* spImposter_writeBinary (const spImposter* self, int* length);
+
+/* Returns 0 if the animation was not added. */
+spImposterAnimation* spImposter_findAnimation (const spImposter* self, const spAnimation* animation);
+/* Returns the frame shown at the specified animation time, or 0 if the animation was not added. */
+const spImposterFrame* spImposter_getFrame (const spImposter* self, const spAnimation* animation, float time, int/*bool*/loop);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spImposterPixelsProvider ImposterPixelsProvider;
+typedef spImposterFrame ImposterFrame;
+typedef spImposterAnimation ImposterAnimation;
+typedef spImposterPage ImposterPage;
+typedef spImposter Imposter;
+#define Imposter_create(...) spImposter_create(__VA_ARGS__)
+#define Imposter_createFromBinary(...) spImposter_createFromBinary(__VA_ARGS__)
+#define Imposter_createFromFile(...) spImposter_createFromFile(__VA_ARGS__)
+#define Imposter_dispose(...) spImposter_dispose(__VA_ARGS__)
+#define Imposter_addAnimation(...) spImposter_addAnimation(__VA_ARGS__)
+#define Imposter_writeBinary(...) spImposter_writeBinary(__VA_ARGS__)
+#define Imposter_findAnimation(...) spImposter_findAnimation(__VA_ARGS__)
+#define Imposter_getFrame(...) spImposter_getFrame(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_IMPOSTER_H_ */
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_LOADJOB_H_
+#define SPINE_LOADJOB_H_
+
+#include <spine/Atlas.h>
+#include <spine/SkeletonData.h>
+#include <spine/SkeletonJson.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	SP_LOAD_JOB_PENDING, /* spLoadJob_run has not been called. */
+	SP_LOAD_JOB_LOADING, /* spLoadJob_run is reading the files. */
+	SP_LOAD_JOB_LOADED, /* Waiting for spLoadJob_update to create the textures. */
+	SP_LOAD_JOB_COMPLETE,
+	SP_LOAD_JOB_FAILED,
+	SP_LOAD_JOB_CANCELED
+} spLoadJobState;
+
+typedef struct spLoadJob spLoadJob;
+
+typedef void (*spLoadJobListener) (spLoadJob* job);
+
+/* Loads an atlas and the skeleton data using it without blocking the main thread. spLoadJob_run reads and parses the files and
+ * decodes the page images on any thread, then spLoadJob_update, called on the main thread each frame, creates the textures and
+ * reports completion. spine-c does not start threads, the application runs spLoadJob_run on its own worker. */
+struct spLoadJob {
+	const char* const atlasPath;
+	const char* const skeletonPath;
+	float scale; /* Passed to the spSkeletonJson. */
+	spParallelFor parallelFor; /* Passed to the spSkeletonJson. May be 0. */
+	void* rendererObject; /* The atlas' rendererObject. */
+
+	/* Called by spLoadJob_run to decode a page's image into memory. Must set the page's width and height if the atlas file doesn't
+	 * have them. Returns 0 on failure. When 0, spLoadJob_update creates the textures with _spAtlasPage_createTexture, decoding
+	 * the images on the main thread, and the atlas file must have the page sizes. */
+	void* (*decodePage) (spLoadJob* self, spAtlasPage* page, const char* path);
+	/* Called by spLoadJob_update to create a page's texture from its decoded image and set the page's rendererObject. */
+	void (*uploadPage) (spLoadJob* self, spAtlasPage* page, void* image);
+	/* Frees a decoded image, after it was uploaded or if the job failed or was canceled. */
+	void (*disposeImage) (spLoadJob* self, void* image);
+
+	/* Called by spLoadJob_update once the job is complete, failed or was canceled. May be 0. */
+	spLoadJobListener listener;
+
+	/* Set once complete, the caller then owns them. */
+	spAtlas* const atlas;
+	spSkeletonData* const skeletonData;
+	/* Set once failed. */
+	const char* const error;
+
+#ifdef __cplusplus
+	spLoadJob() :
+		atlasPath(0),
+		skeletonPath(0),
+		scale(0),
+		parallelFor(0),
+		rendererObject(0),
+		decodePage(0),
+		uploadPage(0),
+		disposeImage(0),
+		listener(0),
+		atlas(0),
+		skeletonData(0),
+		error(0) {
+	}
+#endif
+};
+
+spLoadJob* spLoadJob_create (const char* atlasPath, const char* skeletonPath);
+/* Must not be called while spLoadJob_run is running. Disposes of the atlas and skeleton data unless the job is complete. */
+void spLoadJob_dispose (spLoadJob* self);
+
+/* Reads the atlas and skeleton data and decodes the page images. May be called on any thread, once. */
+void spLoadJob_run (spLoadJob* self);
+/* Creates the textures once spLoadJob_run is done and calls the listener when the job is finished. Must be called on the main
+ * thread, usually each frame. Returns true once the job is complete, failed or was canceled. */
+int/*bool*/spLoadJob_update (spLoadJob* self);
+/* Stops the job as soon as possible. It is canceled once spLoadJob_update returns true, unless it finished first. May be called
+ * on any thread. */
+void spLoadJob_cancel (spLoadJob* self);
+
+/* May be called on any thread. */
+spLoadJobState spLoadJob_getState (spLoadJob* self);
+/* Returns 0 to 1. May be called on any thread. */
+float spLoadJob_getProgress (spLoadJob* self);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spLoadJobState LoadJobState;
+#define LOAD_JOB_PENDING SP_LOAD_JOB_PENDING
+#define LOAD_JOB_LOADING SP_LOAD_JOB_LOADING
+#define LOAD_JOB_LOADED SP_LOAD_JOB_LOADED
+#define LOAD_JOB_COMPLETE SP_LOAD_JOB_COMPLETE
+#define LOAD_JOB_FAILED SP_LOAD_JOB_FAILED
+#define LOAD_JOB_CANCELED SP_LOAD_JOB_CANCELED
+typedef spLoadJobListener LoadJobListener;
+typedef spLoadJob LoadJob;
+#define LoadJob_create(...) spLoadJob_create(__VA_ARGS__)
+#define LoadJob_dispose(...) spLoadJob_dispose(__VA_ARGS__)
+#define LoadJob_run(...) spLoadJob_run(__VA_ARGS__)
+#define LoadJob_update(...) spLoadJob_update(__VA_ARGS__)
+#define LoadJob_cancel(...) spLoadJob_cancel(__VA_ARGS__)
+#define LoadJob_getState(...) spLoadJob_getState(__VA_ARGS__)
+#define LoadJob_getProgress(...) spLoadJob_getProgress(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_LOADJOB_H_ */
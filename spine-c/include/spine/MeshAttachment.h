@@ -49,10 +49,11 @@ typedef struct spMeshAttachment {
 	int hullLength;
 
 	float* regionUVs;
-	float* uvs;
+	float* uvs; /* 0 for compact meshes, see spMeshAttachment_computeUVs. */
 
 	int trianglesCount;
 	int* triangles;
+	unsigned short* shortTriangles; /* Set instead of triangles for compact meshes. */
 
 	float r, g, b, a;
 
@@ -71,13 +72,25 @@ typedef struct spMeshAttachment {
 
 spMeshAttachment* spMeshAttachment_create (const char* name);
 void spMeshAttachment_updateUVs (spMeshAttachment* self);
+/* Writes verticesCount uvs computed from the regionUVs, for meshes without uvs. */
+void spMeshAttachment_computeUVs (const spMeshAttachment* self, float* uvs);
+/* Stores the triangles as unsigned shorts and frees the uvs. Compact meshes can be drawn with spRenderList, renderers that read
+ * triangles and uvs directly can't draw them. See spSkeletonJson compactMeshes. */
+void spMeshAttachment_compact (spMeshAttachment* self);
 void spMeshAttachment_computeWorldVertices (spMeshAttachment* self, spSlot* slot, float* worldVertices);
+/* Writes each vertex stride floats after the previous one, starting at worldVertices[start]. See
+ * spRegionAttachment_computeWorldVerticesStrided. */
+void spMeshAttachment_computeWorldVerticesStrided (spMeshAttachment* self, spSlot* slot, float* worldVertices, int start,
+		int stride);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spMeshAttachment MeshAttachment;
 #define MeshAttachment_create(...) spMeshAttachment_create(__VA_ARGS__)
 #define MeshAttachment_updateUVs(...) spMeshAttachment_updateUVs(__VA_ARGS__)
+#define MeshAttachment_computeUVs(...) spMeshAttachment_computeUVs(__VA_ARGS__)
+#define MeshAttachment_compact(...) spMeshAttachment_compact(__VA_ARGS__)
 #define MeshAttachment_computeWorldVertices(...) spMeshAttachment_computeWorldVertices(__VA_ARGS__)
+#define MeshAttachment_computeWorldVerticesStrided(...) spMeshAttachment_computeWorldVerticesStrided(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_POSECACHE_H_
+#define SPINE_POSECACHE_H_
+
+#include <spine/AnimationState.h>
+#include <spine/Skeleton.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shares computed poses between skeletons that play the same animations at the same (quantized) times, such as crowds of
+ * characters walking or idling. A pose is keyed by the skeleton data, skin, flip, the animations, times and mix of every track.
+ * It stores the local and world bone transforms, slot colors, attachments and FFD vertices, the draw order and the IK
+ * constraint mix and bend direction.
+ *
+ * The cached pose replaces the skeleton's pose entirely, so it is only correct when the pose is fully determined by the key,
+ * for example when the skeleton is reset to the setup pose before being posed or when the animations key all bones. */
+typedef struct spPoseCache {
+	float timeStep; /* Track times within the same step share a pose. 0 only shares poses for identical times. */
+	int memoryBudget; /* The least recently used poses are discarded when the cached poses exceed this many bytes. */
+	int const memoryUsed;
+	int const posesCount;
+
+	int hits, misses, evictions;
+
+#ifdef __cplusplus
+	spPoseCache() :
+		timeStep(0),
+		memoryBudget(0),
+		memoryUsed(0),
+		posesCount(0),
+		hits(0), misses(0), evictions(0) {
+	}
+#endif
+} spPoseCache;
+
+spPoseCache* spPoseCache_create (float timeStep, int memoryBudget);
+void spPoseCache_dispose (spPoseCache* self);
+
+/* Discards all cached poses. The counters are not reset. */
+void spPoseCache_clear (spPoseCache* self);
+
+/* Equivalent to spAnimationState_apply followed by spSkeleton_updateWorldTransform. If a pose for the state is cached it is
+ * copied to the skeleton, else the state is applied and the resulting pose is cached. Events and listeners are processed in
+ * both cases. Returns 1 if the pose came from the cache. */
+int/*bool*/spPoseCache_apply (spPoseCache* self, spAnimationState* state, spSkeleton* skeleton);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spPoseCache PoseCache;
+#define PoseCache_create(...) spPoseCache_create(__VA_ARGS__)
+#define PoseCache_dispose(...) spPoseCache_dispose(__VA_ARGS__)
+#define PoseCache_clear(...) spPoseCache_clear(__VA_ARGS__)
+#define PoseCache_apply(...) spPoseCache_apply(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_POSECACHE_H_ */
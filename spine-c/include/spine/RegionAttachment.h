@@ -63,6 +63,11 @@ spRegionAttachment* spRegionAttachment_create (const char* name);
 void spRegionAttachment_setUVs (spRegionAttachment* self, float u, float v, float u2, float v2, int/*bool*/rotate);
 void spRegionAttachment_updateOffset (spRegionAttachment* self);
 void spRegionAttachment_computeWorldVertices (spRegionAttachment* self, spBone* bone, float* vertices);
+/* Like spRegionAttachment_computeWorldVertices, but writes the x and y of the 4 vertices to vertices[start],
+ * vertices[start + 1], then to vertices[start + stride] and so on, so they can be written directly into an interleaved
+ * vertex buffer. start and stride are in floats. */
+void spRegionAttachment_computeWorldVerticesStrided (spRegionAttachment* self, spBone* bone, float* vertices, int start,
+		int stride);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spVertexIndex VertexIndex;
@@ -79,6 +84,7 @@ typedef spRegionAttachment RegionAttachment;
 #define RegionAttachment_setUVs(...) spRegionAttachment_setUVs(__VA_ARGS__)
 #define RegionAttachment_updateOffset(...) spRegionAttachment_updateOffset(__VA_ARGS__)
 #define RegionAttachment_computeWorldVertices(...) spRegionAttachment_computeWorldVertices(__VA_ARGS__)
+#define RegionAttachment_computeWorldVerticesStrided(...) spRegionAttachment_computeWorldVerticesStrided(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
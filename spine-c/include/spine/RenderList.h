@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_RENDERLIST_H_
+#define SPINE_RENDERLIST_H_
+
+#include <spine/Skeleton.h>
+#include <spine/Atlas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	SP_VERTEX_COLOR_NONE, /* No color is written. */
+	SP_VERTEX_COLOR_BYTES, /* 4 unsigned bytes, r, g, b, a, 0-255. */
+	SP_VERTEX_COLOR_FLOATS /* 4 floats, r, g, b, a, 0-1. */
+} spVertexColor;
+
+/* Describes the interleaved vertices written by spRenderList. Offsets are in bytes from the start of each vertex. The stride and
+ * the position and UV offsets must be multiples of 4, so world vertices can be computed directly into the vertex buffer. Bytes
+ * not described by the format, such as a z coordinate, are zero. */
+typedef struct spVertexFormat {
+	int stride; /* Bytes from one vertex to the next. */
+	int positionOffset; /* 2 floats, x and y. */
+	int uvOffset; /* 2 floats, u and v. -1 for none. */
+	int colorOffset; /* Ignored if color is SP_VERTEX_COLOR_NONE. */
+	spVertexColor color;
+	int/*bool*/premultipliedAlpha; /* Multiplies r, g and b by a. */
+	int/*bool*/pixelUVs; /* Multiplies u and v by the atlas page size. Cached per attachment. */
+	int/*bool*/triangleList; /* Writes 3 vertices per triangle and no indices. */
+	int indexSize; /* 2 or 4 bytes. Ignored if triangleList is set. */
+	/* A new batch is started rather than exceed this many vertices, eg 65536 for 2 byte indices. 0 for no limit. An attachment
+	 * with more vertices gets a batch of its own. */
+	int maxBatchVertices;
+	/* A new batch is started rather than exceed this many indices, eg the size of the renderer's index buffer. 0 for no limit.
+	 * Ignored if triangleList is set. An attachment with more indices gets a batch of its own. */
+	int maxBatchIndices;
+
+#ifdef __cplusplus
+	spVertexFormat() :
+		stride(0),
+		positionOffset(0),
+		uvOffset(0),
+		colorOffset(0),
+		color(SP_VERTEX_COLOR_NONE),
+		premultipliedAlpha(0),
+		pixelUVs(0),
+		triangleList(0),
+		indexSize(0),
+		maxBatchVertices(0),
+		maxBatchIndices(0) {
+	}
+#endif
+} spVertexFormat;
+
+/* A range of vertices and indices that can be drawn with one draw call. Indices are relative to firstVertex. */
+typedef struct spRenderBatch {
+	spAtlasPage* page;
+	void* rendererObject; /* The page's rendererObject, usually the texture. */
+	spBlendMode blendMode;
+	int firstVertex, verticesCount;
+	int firstIndex, indicesCount;
+
+#ifdef __cplusplus
+	spRenderBatch() :
+		page(0),
+		rendererObject(0),
+		blendMode(SP_BLEND_MODE_NORMAL),
+		firstVertex(0), verticesCount(0),
+		firstIndex(0), indicesCount(0) {
+	}
+#endif
+} spRenderBatch;
+
+/* Builds the vertices, indices and draw batches for the region and mesh attachments of one or more skeletons, in draw order.
+ * Consecutive attachments with the same atlas page and blend mode share a batch. The vertices use the world transform, so
+ * spSkeleton_updateWorldTransform must be called first. */
+typedef struct spRenderList {
+	const spVertexFormat format;
+
+	int const verticesCount;
+	void* const vertices;
+	int const indicesCount;
+	void* const indices;
+
+	int const batchesCount;
+	spRenderBatch* const batches;
+
+	/* The bounds of all vertices added since the list was cleared. min is greater than max if the list is empty. */
+	float const minX, minY, maxX, maxY;
+
+#ifdef __cplusplus
+	spRenderList() :
+		format(),
+		verticesCount(0),
+		vertices(0),
+		indicesCount(0),
+		indices(0),
+		batchesCount(0),
+		batches(0),
+		minX(0), minY(0), maxX(0), maxY(0) {
+	}
+#endif
+} spRenderList;
+
+spRenderList* spRenderList_create (const spVertexFormat* format);
+void spRenderList_dispose (spRenderList* self);
+
+/* Removes all vertices, indices and batches. The buffers are kept for reuse. */
+void spRenderList_clear (spRenderList* self);
+
+/* Appends the attachments of the skeleton. Attachments without an atlas region are skipped. */
+void spRenderList_addSkeleton (spRenderList* self, const spSkeleton* skeleton);
+
+/* Makes the list hold only the skeleton, reusing what was built by the previous call for the same skeleton. If the skeleton's
+ * topology version did not change since then, only the vertex positions, colors and bounds are rewritten and the UVs, indices
+ * and batches are kept. Otherwise, or if the skeleton data or the number of vertices changed, the list is cleared and rebuilt. Attachments must not be modified while they are retained this
+ * way. See spSkeleton_getTopologyVersion.
+ * @return 1 if the list was rebuilt, 0 if only the positions and colors changed. */
+int spRenderList_updateSkeleton (spRenderList* self, const spSkeleton* skeleton);
+
+/* Ensures the buffers can hold the specified number of vertices and indices without being reallocated. */
+void spRenderList_reserve (spRenderList* self, int verticesCount, int indicesCount);
+/* Reserves space for the specified number of skeletons of the skeleton data, in addition to the current vertices and indices.
+ * Each slot counts its largest attachment in any skin, so no skin or attachment change needs more space. */
+void spRenderList_reserveForSkeletonData (spRenderList* self, const spSkeletonData* skeletonData, int skeletonsCount);
+
+/* Discards the pixel UVs cached for each attachment drawn with the pixelUVs format. Must be called before the attachments are
+ * disposed if the render list is used with other attachments afterward. */
+void spRenderList_clearUVCache (spRenderList* self);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spVertexColor VertexColor;
+#define VERTEX_COLOR_NONE SP_VERTEX_COLOR_NONE
+#define VERTEX_COLOR_BYTES SP_VERTEX_COLOR_BYTES
+#define VERTEX_COLOR_FLOATS SP_VERTEX_COLOR_FLOATS
+typedef spVertexFormat VertexFormat;
+typedef spRenderBatch RenderBatch;
+typedef spRenderList RenderList;
+#define RenderList_create(...) spRenderList_create(__VA_ARGS__)
+#define RenderList_dispose(...) spRenderList_dispose(__VA_ARGS__)
+#define RenderList_clear(...) spRenderList_clear(__VA_ARGS__)
+#define RenderList_addSkeleton(...) spRenderList_addSkeleton(__VA_ARGS__)
+#define RenderList_updateSkeleton(...) spRenderList_updateSkeleton(__VA_ARGS__)
+#define RenderList_reserve(...) spRenderList_reserve(__VA_ARGS__)
+#define RenderList_reserveForSkeletonData(...) spRenderList_reserveForSkeletonData(__VA_ARGS__)
+#define RenderList_clearUVCache(...) spRenderList_clearUVCache(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_RENDERLIST_H_ */
@@ -59,6 +59,7 @@ typedef struct spSkeleton {
 	float r, g, b, a;
 	float time;
 	int/*bool*/flipX, flipY;
+	int/*bool*/yDown; /* True if the y axis points down, as in most screen coordinates. Defaults to spBone_isYDown. */
 	float x, y;
 
 #ifdef __cplusplus
@@ -79,6 +80,7 @@ typedef struct spSkeleton {
 		time(0),
 		flipX(0),
 		flipY(0),
+		yDown(0),
 		x(0), y(0) {
 	}
 #endif
@@ -91,6 +93,23 @@ void spSkeleton_dispose (spSkeleton* self);
 void spSkeleton_updateCache (const spSkeleton* self);
 void spSkeleton_updateWorldTransform (const spSkeleton* self);
 
+/* Computes the world transform of a single bone by walking its ancestors and any IK constraints that affect them, leaving all
+ * other bones untouched. Results are memoized, so querying several bones of the same pose only computes each bone once. */
+void spSkeleton_updateBoneWorldTransform (const spSkeleton* self, int boneIndex);
+/* Discards the world transforms memoized by spSkeleton_updateBoneWorldTransform. Must be called whenever the pose changes. */
+void spSkeleton_invalidateWorldTransform (const spSkeleton* self);
+/* Sets to 1 the entry for each bone that spSkeleton_updateBoneWorldTransform uses to compute the specified bone.
+ * @param bonesMask Has an entry for each bone in the skeleton. See spAnimationState_applyMasked. */
+void spSkeleton_maskBone (const spSkeleton* self, int boneIndex, int* bonesMask);
+
+/* Returns a number that changes whenever a slot's attachment or the draw order changes, so renderers can reuse their batches and
+ * indices while it stays the same. spSlot_setAttachment, draw order timelines, spSkeleton_setSkin and
+ * spSkeleton_setSlotsToSetupPose change it. Versions come from a counter shared by all skeletons, so two skeletons never have
+ * the same version, even if one is created at the address of a disposed one. */
+int spSkeleton_getTopologyVersion (const spSkeleton* self);
+/* Changes the topology version. Must be called after modifying drawOrder directly. */
+void spSkeleton_invalidateTopology (const spSkeleton* self);
+
 void spSkeleton_setToSetupPose (const spSkeleton* self);
 void spSkeleton_setBonesToSetupPose (const spSkeleton* self);
 void spSkeleton_setSlotsToSetupPose (const spSkeleton* self);
@@ -127,11 +146,27 @@ spIkConstraint* spSkeleton_findIkConstraint (const spSkeleton* self, const char*
 
 void spSkeleton_update (spSkeleton* self, float deltaTime);
 
+/* Returns the number of bytes spSkeleton_snapshot needs. Changes when attachments with vertices are set. */
+int spSkeleton_getSnapshotSize (const spSkeleton* self);
+/* Copies the skin, color, time, flip, position and the bone, slot, IK constraint and draw order state into the buffer, which
+ * must be at least spSkeleton_getSnapshotSize bytes and aligned for a pointer. World transforms are not stored. Returns the
+ * number of bytes written. */
+int spSkeleton_snapshot (const spSkeleton* self, void* buffer);
+/* Restores the state stored by spSkeleton_snapshot for this skeleton or another skeleton of the same skeleton data. Call
+ * spSkeleton_updateWorldTransform afterward. Returns the number of bytes read, or 0 if the snapshot is for a skeleton with
+ * different bones, slots or IK constraints. */
+int spSkeleton_restore (spSkeleton* self, const void* buffer);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeleton Skeleton;
 #define Skeleton_create(...) spSkeleton_create(__VA_ARGS__)
 #define Skeleton_dispose(...) spSkeleton_dispose(__VA_ARGS__)
 #define Skeleton_updateWorldTransform(...) spSkeleton_updateWorldTransform(__VA_ARGS__)
+#define Skeleton_updateBoneWorldTransform(...) spSkeleton_updateBoneWorldTransform(__VA_ARGS__)
+#define Skeleton_invalidateWorldTransform(...) spSkeleton_invalidateWorldTransform(__VA_ARGS__)
+#define Skeleton_maskBone(...) spSkeleton_maskBone(__VA_ARGS__)
+#define Skeleton_getTopologyVersion(...) spSkeleton_getTopologyVersion(__VA_ARGS__)
+#define Skeleton_invalidateTopology(...) spSkeleton_invalidateTopology(__VA_ARGS__)
 #define Skeleton_setToSetupPose(...) spSkeleton_setToSetupPose(__VA_ARGS__)
 #define Skeleton_setBonesToSetupPose(...) spSkeleton_setBonesToSetupPose(__VA_ARGS__)
 #define Skeleton_setSlotsToSetupPose(...) spSkeleton_setSlotsToSetupPose(__VA_ARGS__)
@@ -145,6 +180,9 @@ typedef spSkeleton Skeleton;
 #define Skeleton_getAttachmentForSlotIndex(...) spSkeleton_getAttachmentForSlotIndex(__VA_ARGS__)
 #define Skeleton_setAttachment(...) spSkeleton_setAttachment(__VA_ARGS__)
 #define Skeleton_update(...) spSkeleton_update(__VA_ARGS__)
+#define Skeleton_getSnapshotSize(...) spSkeleton_getSnapshotSize(__VA_ARGS__)
+#define Skeleton_snapshot(...) spSkeleton_snapshot(__VA_ARGS__)
+#define Skeleton_restore(...) spSkeleton_restore(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
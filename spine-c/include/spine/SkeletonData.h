@@ -71,6 +71,12 @@ typedef struct spSkeletonData {
 spSkeletonData* spSkeletonData_create ();
 void spSkeletonData_dispose (spSkeletonData* self);
 
+/* Caches the setup pose, setup pose attachments, bone hierarchy and bone update order used to create skeletons quickly. Called by
+ * spSkeletonJson. Must be called after changing any bone data, slot data, IK constraint data or the default skin, otherwise
+ * skeletons created afterward use the old values. Only adding or removing bones, slots or IK constraints is detected by
+ * spSkeleton_create. */
+void spSkeletonData_updateCache (spSkeletonData* self);
+
 spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName);
 int spSkeletonData_findBoneIndex (const spSkeletonData* self, const char* boneName);
 
@@ -81,7 +87,13 @@ spSkin* spSkeletonData_findSkin (const spSkeletonData* self, const char* skinNam
 
 spEventData* spSkeletonData_findEvent (const spSkeletonData* self, const char* eventName);
 
+/* Decodes the animation's timelines if it was read with spSkeletonJson lazyAnimations, see spAnimation_decode. */
 spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const char* animationName);
+/* Returns the estimated bytes used by the decoded timelines of animations read with spSkeletonJson lazyAnimations, else 0. */
+int spSkeletonData_getAnimationsMemory (const spSkeletonData* self);
+/* Returns the estimated bytes used by the attachments of the type in all skins, not counting their names and paths. Use to compare
+ * mesh memory with and without spSkeletonJson compactMeshes. */
+int spSkeletonData_getAttachmentsMemory (const spSkeletonData* self, spAttachmentType type);
 
 spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self, const char* ikConstraintName);
 
@@ -89,6 +101,7 @@ spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self,
 typedef spSkeletonData SkeletonData;
 #define SkeletonData_create(...) spSkeletonData_create(__VA_ARGS__)
 #define SkeletonData_dispose(...) spSkeletonData_dispose(__VA_ARGS__)
+#define SkeletonData_updateCache(...) spSkeletonData_updateCache(__VA_ARGS__)
 #define SkeletonData_findBone(...) spSkeletonData_findBone(__VA_ARGS__)
 #define SkeletonData_findBoneIndex(...) spSkeletonData_findBoneIndex(__VA_ARGS__)
 #define SkeletonData_findSlot(...) spSkeletonData_findSlot(__VA_ARGS__)
@@ -96,6 +109,8 @@ typedef spSkeletonData SkeletonData;
 #define SkeletonData_findSkin(...) spSkeletonData_findSkin(__VA_ARGS__)
 #define SkeletonData_findEvent(...) spSkeletonData_findEvent(__VA_ARGS__)
 #define SkeletonData_findAnimation(...) spSkeletonData_findAnimation(__VA_ARGS__)
+#define SkeletonData_getAnimationsMemory(...) spSkeletonData_getAnimationsMemory(__VA_ARGS__)
+#define SkeletonData_getAttachmentsMemory(...) spSkeletonData_getAttachmentsMemory(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
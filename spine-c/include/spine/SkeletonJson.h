@@ -42,9 +42,28 @@
 extern "C" {
 #endif
 
+typedef void (*spParallelTask) (void* context, int index);
+/* Calls task(context, index) once for each index from 0 to count - 1, on any threads, and returns once all the calls returned. */
+typedef void (*spParallelFor) (int count, spParallelTask task, void* context);
+
 typedef struct spSkeletonJson {
 	float scale;
 	spAttachmentLoader* attachmentLoader;
+	/* When not 0, the animations are read in parallel with it once the setup data is read. The skeleton data is the same as when
+	 * reading them one after another. */
+	spParallelFor parallelFor;
+	/* When true, only the name and duration of each animation are read and the skeleton data keeps the animations' JSON to decode
+	 * their timelines when they are first needed, see spAnimation_decode. Errors in the animations are not reported. */
+	int/*bool*/lazyAnimations;
+	/* With lazyAnimations, the estimated bytes of decoded timelines above which the least recently used animations that are not
+	 * acquired are evicted. 0 for no limit. */
+	int animationsBudget;
+	/* When true, meshes are stored with 16-bit triangle and bone indices, quantized weights and without uvs, see
+	 * spMeshAttachment_compact and spSkinnedMeshAttachment_compact. Compact meshes can only be drawn with spRenderList. */
+	int/*bool*/compactMeshes;
+	/* With compactMeshes, the bits of each skinned mesh weight, 8 or 16. Vertices far from their bones can move by a pixel or
+	 * more with 8 bits. */
+	int meshWeightBits;
 	const char* const error;
 } spSkeletonJson;
 
@@ -56,6 +75,8 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 spSkeletonData* spSkeletonJson_readSkeletonDataFile (spSkeletonJson* self, const char* path);
 
 #ifdef SPINE_SHORT_NAMES
+typedef spParallelTask ParallelTask;
+typedef spParallelFor ParallelFor;
 typedef spSkeletonJson SkeletonJson;
 #define SkeletonJson_createWithLoader(...) spSkeletonJson_createWithLoader(__VA_ARGS__)
 #define SkeletonJson_create(...) spSkeletonJson_create(__VA_ARGS__)
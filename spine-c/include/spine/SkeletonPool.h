@@ -29,36 +29,53 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *****************************************************************************/
 
-#ifndef SPINE_POLYGONBATCH_H_
-#define SPINE_POLYGONBATCH_H_
+#ifndef SPINE_SKELETONPOOL_H_
+#define SPINE_SKELETONPOOL_H_
 
-#include "cocos2d.h"
+#include <spine/Skeleton.h>
 
-namespace spine {
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-class PolygonBatch : public cocos2d::Ref {
-public:
-	static PolygonBatch* createWithCapacity (ssize_t capacity);
+/* Recycles skeletons for a skeleton data, so spawning many short lived instances doesn't allocate. */
+typedef struct spSkeletonPool {
+	spSkeletonData* const data;
+	int const freeCount;
+	int max; /* The maximum number of free skeletons kept by the pool. */
 
-	void add (const cocos2d::Texture2D* texture,
-		const float* vertices, const float* uvs, int verticesCount,
-		const int* triangles, int trianglesCount,
-		cocos2d::Color4B* color);
-	void flush ();
+#ifdef __cplusplus
+	spSkeletonPool() :
+		data(0),
+		freeCount(0),
+		max(0) {
+	}
+#endif
+} spSkeletonPool;
 
-protected:
-	PolygonBatch();
-	virtual ~PolygonBatch();
-	bool initWithCapacity (ssize_t capacity);
+spSkeletonPool* spSkeletonPool_create (spSkeletonData* data, int max);
+/* Disposes the free skeletons. Skeletons obtained from the pool are not disposed. */
+void spSkeletonPool_dispose (spSkeletonPool* self);
 
-	ssize_t _capacity;
-	cocos2d::V2F_C4B_T2F* _vertices;
-	int _verticesCount;
-	GLushort* _triangles;
-	int _trianglesCount;
-	const cocos2d::Texture2D* _texture;
-};
+/* Returns a free skeleton, or a new one if there are none. The skeleton is in the setup pose, without a skin, with default
+ * color, position, flip and time. */
+spSkeleton* spSkeletonPool_obtain (spSkeletonPool* self);
+/* Returns a skeleton to the pool, resetting it. If the pool already has max free skeletons, the skeleton is disposed. */
+void spSkeletonPool_free (spSkeletonPool* self, spSkeleton* skeleton);
+/* Creates free skeletons until the pool has the specified number, for example to avoid creating them while spawning. */
+void spSkeletonPool_fill (spSkeletonPool* self, int freeCount);
 
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonPool SkeletonPool;
+#define SkeletonPool_create(...) spSkeletonPool_create(__VA_ARGS__)
+#define SkeletonPool_dispose(...) spSkeletonPool_dispose(__VA_ARGS__)
+#define SkeletonPool_obtain(...) spSkeletonPool_obtain(__VA_ARGS__)
+#define SkeletonPool_free(...) spSkeletonPool_free(__VA_ARGS__)
+#define SkeletonPool_fill(...) spSkeletonPool_fill(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
 }
+#endif
 
-#endif // SPINE_POLYGONBATCH_H_
+#endif /* SPINE_SKELETONPOOL_H_ */
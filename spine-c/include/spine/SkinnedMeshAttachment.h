@@ -54,9 +54,16 @@ typedef struct spSkinnedMeshAttachment {
 
 	int uvsCount;
 	float* regionUVs;
-	float* uvs;
+	float* uvs; /* 0 for compact meshes, see spSkinnedMeshAttachment_computeUVs. */
 	int hullLength;
 
+	/* Set instead of bones, weights and triangles for compact meshes. weightsCount is still 3 per weight. */
+	unsigned short* shortBones;
+	float* weightVertices; /* x, y for each weight. */
+	unsigned char* byteWeights; /* Each weight times 255, or 0 if shortWeights is used. */
+	unsigned short* shortWeights; /* Each weight times 65535. */
+	unsigned short* shortTriangles;
+
 	float r, g, b, a;
 
 	void* rendererObject;
@@ -74,13 +81,26 @@ typedef struct spSkinnedMeshAttachment {
 
 spSkinnedMeshAttachment* spSkinnedMeshAttachment_create (const char* name);
 void spSkinnedMeshAttachment_updateUVs (spSkinnedMeshAttachment* self);
+/* Writes uvsCount uvs computed from the regionUVs, for meshes without uvs. */
+void spSkinnedMeshAttachment_computeUVs (const spSkinnedMeshAttachment* self, float* uvs);
+/* Stores the bones and triangles as unsigned shorts, quantizes the weights to 8 or 16 bits and frees the uvs. The weights of each
+ * vertex still add up to 1. Compact meshes can be drawn with spRenderList, renderers that read triangles and uvs directly can't
+ * draw them. See spSkeletonJson compactMeshes. */
+void spSkinnedMeshAttachment_compact (spSkinnedMeshAttachment* self, int weightBits);
 void spSkinnedMeshAttachment_computeWorldVertices (spSkinnedMeshAttachment* self, spSlot* slot, float* worldVertices);
+/* Writes each vertex stride floats after the previous one, starting at worldVertices[start]. See
+ * spRegionAttachment_computeWorldVerticesStrided. */
+void spSkinnedMeshAttachment_computeWorldVerticesStrided (spSkinnedMeshAttachment* self, spSlot* slot, float* worldVertices,
+		int start, int stride);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spSkinnedMeshAttachment SkinnedMeshAttachment;
 #define SkinnedMeshAttachment_create(...) spSkinnedMeshAttachment_create(__VA_ARGS__)
 #define SkinnedMeshAttachment_updateUVs(...) spSkinnedMeshAttachment_updateUVs(__VA_ARGS__)
+#define SkinnedMeshAttachment_computeUVs(...) spSkinnedMeshAttachment_computeUVs(__VA_ARGS__)
+#define SkinnedMeshAttachment_compact(...) spSkinnedMeshAttachment_compact(__VA_ARGS__)
 #define SkinnedMeshAttachment_computeWorldVertices(...) spSkinnedMeshAttachment_computeWorldVertices(__VA_ARGS__)
+#define SkinnedMeshAttachment_computeWorldVerticesStrided(...) spSkinnedMeshAttachment_computeWorldVerticesStrided(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -77,6 +77,19 @@
 #define ACOS(A) (float)acos(A)
 #endif
 
+/* If SPINE_FAST_MATH is defined, polynomial approximations replace the libm trigonometry. See _spMath_sin. SQRT is left to libm
+ * because it is a single instruction on all supported targets. */
+#ifdef SPINE_FAST_MATH
+#undef ATAN2
+#undef SIN
+#undef COS
+#undef ACOS
+#define ATAN2(A,B) _spMath_atan2(A, B)
+#define SIN(A) _spMath_sin(A)
+#define COS(A) _spMath_cos(A)
+#define ACOS(A) _spMath_acos(A)
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -116,11 +129,245 @@ void* _malloc (size_t size, const char* file, int line);
 void* _calloc (size_t num, size_t size, const char* file, int line);
 void _free (void* ptr);
 
+/* Process wide, so these must be called before spine-c is used on other threads. */
 void _setMalloc (void* (*_malloc) (size_t size));
 void _setDebugMalloc (void* (*_malloc) (size_t size, const char* file, int line));
 void _setFree (void (*_free) (void* ptr));
 
 char* _readFile (const char* path, int* length);
+/* Returns the values as unsigned shorts allocated with MALLOC, or 0 if one doesn't fit. */
+unsigned short* _toShorts (const int* values, int count);
+/* Returns value1 followed by value2, if not 0, truncated to 255 characters and allocated with MALLOC. */
+char* _formatError (const char* value1, const char* value2);
+
+/* Reads the big endian values of binary formats. Reading past the end sets error and returns 0. */
+typedef struct _spBinaryInput {
+	const unsigned char* cursor;
+	const unsigned char* end;
+	int/*bool*/error;
+} _spBinaryInput;
+int _spBinaryInput_readInt (_spBinaryInput* self);
+float _spBinaryInput_readFloat (_spBinaryInput* self);
+/* Writes a big endian value and advances the output past it. */
+void _spBinary_writeInt (unsigned char** output, int value);
+void _spBinary_writeFloat (unsigned char** output, float value);
+
+/* Access to an int shared between threads, with full memory barriers. Compilers without atomic operations are an error unless
+ * SPINE_SINGLE_THREADED is defined, which makes these plain accesses. spLoadJob, lazy animations and parallel reading of
+ * animations must then only be used by one thread. */
+int _spAtomic_get (volatile int* value);
+void _spAtomic_set (volatile int* value, int newValue);
+/* Returns true if value was expected and was replaced. */
+int/*bool*/_spAtomic_compareAndSet (volatile int* value, int expected, int newValue);
+/* Returns the new value. */
+int _spAtomic_add (volatile int* value, int delta);
+
+/* Defines a function in a header so it can be inlined. C89 has no inline keyword, so the compiler's own is used if it has one. */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define _SP_INLINE static inline
+#elif defined(__GNUC__)
+#define _SP_INLINE static __inline__
+#elif defined(_MSC_VER)
+#define _SP_INLINE static __inline
+#else
+#define _SP_INLINE static
+#endif
+
+/* Approximations used for SPINE_FAST_MATH. They use no tables or loops, only a few multiplies and selects, plus a division for
+ * _spMath_atan2 and a square root for _spMath_acos. spine-bench measures their speed and spine-check checks these maximum
+ * absolute errors compared to the double precision libm functions:
+ * _spMath_sin, _spMath_cos: 9e-7 for |radians| < 1000. Precision degrades for larger angles, which must stay below 1e9.
+ * _spMath_atan2: 2e-6 radians.
+ * _spMath_acos: 5e-7 radians. */
+
+/* Reduces to [-PI, PI]. PI * 2 is split in two parts so the reduction stays precise for larger angles. */
+_SP_INLINE float _spMath_reduce (float radians) {
+	float turns = (float)(int)(radians * (1 / (PI * 2)) + (radians < 0 ? -0.5f : 0.5f));
+	return radians - turns * 6.28125f - turns * 1.9353071795864769e-3f;
+}
+
+/* Expects [-PI * 1.5, PI * 1.5]. */
+_SP_INLINE float _spMath_sinReduced (float radians) {
+	float x2;
+	/* Fold to [-PI/2, PI/2] using sin(PI - x) = sin(x). */
+	if (radians > PI / 2)
+		radians = PI - radians;
+	else if (radians < -PI / 2) /**/
+		radians = -PI - radians;
+	/* Minimax polynomial of degree 7. */
+	x2 = radians * radians;
+	return radians * (0.99999662f + x2 * (-0.16664832f + x2 * (0.0083063573f + x2 * -0.00018364522f)));
+}
+
+_SP_INLINE float _spMath_sin (float radians) {
+	return _spMath_sinReduced(_spMath_reduce(radians));
+}
+
+_SP_INLINE float _spMath_cos (float radians) {
+	return _spMath_sinReduced(_spMath_reduce(radians) + PI / 2);
+}
+
+_SP_INLINE float _spMath_atan2 (float y, float x) {
+	float ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+	float t, t2, result;
+	if (ax == 0 && ay == 0) return 0;
+	/* Reduce to [0, 1] using atan(t) = PI/2 - atan(1/t). */
+	t = ax > ay ? ay / ax : ax / ay;
+	/* Minimax polynomial of degree 11. */
+	t2 = t * t;
+	result = t * (0.99997728f + t2 * (-0.33262430f + t2 * (0.19355011f + t2 * (-0.11645212f + t2 * (0.052676382f
+			+ t2 * -0.011730925f)))));
+	if (ay > ax) result = PI / 2 - result;
+	if (x < 0) result = PI - result;
+	return y < 0 ? -result : result;
+}
+
+_SP_INLINE float _spMath_acos (float x) {
+	/* Abramowitz and Stegun 4.4.46. */
+	float ax = x < 0 ? -x : x;
+	float result = SQRT(1 - ax) * (1.5707963050f + ax * (-0.2145988016f + ax * (0.0889789874f + ax * (-0.0501743046f
+			+ ax * (0.0308918810f + ax * (-0.0170881256f + ax * (0.0066700901f + ax * -0.0012624911f)))))));
+	return x < 0 ? PI - result : result;
+}
+
+/**/
+
+/* Stores each distinct string once, so two strings of a pool are equal only if they are the same pointer. The strings are freed
+ * when the pool is disposed. Adding strings must not overlap with other use of the pool, any number of threads can find strings
+ * at once. */
+typedef struct _spStringPool _spStringPool;
+
+_spStringPool* _spStringPool_create ();
+void _spStringPool_dispose (_spStringPool* self);
+/* Returns the pooled string, adding it if it isn't pooled yet. */
+const char* _spStringPool_add (_spStringPool* self, const char* string);
+const char* _spStringPool_addLength (_spStringPool* self, const char* string, int length);
+/* Returns the pooled string, or 0 if it isn't pooled. */
+const char* _spStringPool_find (const _spStringPool* self, const char* string);
+/* Returns true if the string is stored in the pool. The pool may be 0. */
+int/*bool*/_spStringPool_owns (const _spStringPool* self, const char* string);
+/* Replaces a string allocated with MALLOC with the pooled string. */
+void _spStringPool_intern (_spStringPool* self, const char** string);
+/* Sets the string to 0 if it is stored in the pool, so disposing the object that references it doesn't free it. */
+void _spStringPool_release (const _spStringPool* self, const char** string);
+/* Returns the bytes allocated by the pool. */
+int _spStringPool_getMemory (const _spStringPool* self);
+
+/**/
+
+/* Reads an atlas like spAtlas_createFromFile without creating the page textures, so it can be called on any thread. Textures are
+ * then created with _spAtlasPage_createTexture and _spAtlas_getTexturePath. Pages without a size in the atlas file get theirs
+ * from the texture, after which _spAtlas_updateUVs must be called. */
+spAtlas* _spAtlas_createFromFileWithoutTextures (const char* path, void* rendererObject);
+/* Returns the path of the page's image, allocated with MALLOC. */
+char* _spAtlas_getTexturePath (const spAtlas* self, const spAtlasPage* page);
+/* Recomputes the region UVs from the page sizes. */
+void _spAtlas_updateUVs (spAtlas* self);
+
+/**/
+
+typedef struct _spSlot {
+	spSlot super;
+	float attachmentTime;
+
+#ifdef __cplusplus
+	_spSlot() :
+		super(),
+		attachmentTime(0) {
+	}
+#endif
+} _spSlot;
+
+/**/
+
+typedef struct _spAttachmentTimeline {
+	spAttachmentTimeline super;
+	const _spStringPool* strings; /* Attachment names found in this pool are not copied. May be 0. */
+} _spAttachmentTimeline;
+
+/**/
+
+typedef struct _spAnimationDecoder _spAnimationDecoder;
+
+typedef struct _spAnimation {
+	spAnimation super;
+	_spAnimationDecoder* decoder; /* Set when the timelines are decoded on demand, see spAnimation_decode. */
+	const char* source; /* Passed to the decoder. */
+	volatile int state;
+	volatile int references; /* Timelines are only evicted while 0. */
+	volatile int lastUsed;
+	int memory; /* Estimated bytes used by the decoded timelines. */
+} _spAnimation;
+
+struct _spAnimationDecoder {
+	/* Sets the timelines of the animation. May be called on any thread. Returns false on failure. */
+	int/*bool*/(*decode) (_spAnimationDecoder* self, spAnimation* animation, const char* source);
+	void (*dispose) (_spAnimationDecoder* self);
+	spSkeletonData* skeletonData;
+	int memoryBudget; /* 0 for no limit. */
+	volatile int memoryUsed;
+	volatile int clock;
+};
+
+void _spAnimation_disposeTimelines (spAnimation* self);
+
+/**/
+
+/* Replaces the names of the skin and its attachments and the attachment paths with pooled strings. */
+void _spSkin_internStrings (spSkin* self, _spStringPool* strings);
+/* Clears the pooled strings referenced by the skin and its attachments before they are disposed. */
+void _spSkin_releaseStrings (spSkin* self, const _spStringPool* strings);
+/* Returns the bytes used by the skin's attachments of the type, see spSkeletonData_getAttachmentsMemory. */
+int _spSkin_getAttachmentsMemory (const spSkin* self, spAttachmentType type);
+
+/**/
+
+typedef struct _spSkeletonData {
+	spSkeletonData super;
+
+	/* Template for new skeletons, see spSkeletonData_updateCache. */
+	int/*bool*/cacheValid;
+	int cacheBonesCount, cacheSlotsCount, cacheIkConstraintsCount;
+	spBone* bones; /* Setup pose, without skeleton and parent. */
+	int* boneParentIndices;
+	_spSlot* slots; /* Setup pose with the default skin, without bone. */
+	int* slotBoneIndices;
+	int* ikConstraintBoneIndices; /* The bones of all IK constraints, in order. */
+	int* ikConstraintTargetIndices;
+	int ikConstraintBonesCount;
+	int* skeletonCache; /* See _spSkeleton_computeCache. */
+	int* boneCacheIndices;
+	int boneCacheIndicesCount;
+
+	_spAnimationDecoder* animationDecoder; /* Set when the animations are decoded on demand. */
+
+	/* The names of the bones, slots, IK constraints, events, skins, attachments and animations, and the attachment paths, event
+	 * strings and attachment timeline names, each distinct string once. 0 if the data wasn't read by spSkeletonJson. */
+	_spStringPool* strings;
+} _spSkeletonData;
+
+/* Replaces the strings that aren't pooled yet with pooled strings, creating the pool if needed. The slots' setup attachment
+ * names are not pooled, spSlotData_setAttachmentName frees them. */
+void _spSkeletonData_internStrings (spSkeletonData* self);
+
+/* Updates the cache if bones, slots or IK constraints were added or removed since it was built. */
+void _spSkeletonData_validateCache (spSkeletonData* self);
+
+/**/
+
+/* The state applied by animations to bones, slots, IK constraints and draw order, stored in a flat buffer. Used by
+ * spSkeleton_snapshot and spPoseCache. The skeleton must have the same bones, slots and IK constraints when read. */
+int _spSkeleton_getPoseSize (const spSkeleton* self);
+void _spSkeleton_writePose (const spSkeleton* self, void* pose);
+void _spSkeleton_readPose (spSkeleton* self, const void* pose);
+
+/* Computes the bone update order and the bone and IK constraint indices used by spSkeleton from bone parent indices and IK
+ * constraint parent, child and target bone indices. The results are stored in a single block of _spSkeleton_getCacheSize ints,
+ * so the skeleton data can compute them once and skeletons copy them. boneCacheIndices must hold bonesCount * 2 ints and
+ * receives the bones of each level of the update order. Returns the number of bone indices written. */
+int _spSkeleton_getCacheSize (int bonesCount, int ikConstraintsCount);
+int _spSkeleton_computeCache (int* cache, int* boneCacheIndices, int bonesCount, int ikConstraintsCount,
+		const int* boneParentIndices, const int* ikParentIndices, const int* ikChildIndices, const int* ikTargetIndices);
 
 /**/
 
@@ -131,12 +378,17 @@ typedef struct _spAnimationState {
 	spTrackEntry* (*createTrackEntry) (spAnimationState* self);
 	void (*disposeTrackEntry) (spTrackEntry* entry);
 
+	spTrackEntry** restoreEntries; /* Scratch space for spAnimationState_restore. */
+	int restoreEntriesCapacity;
+
 #ifdef __cplusplus
 	_spAnimationState() :
 		super(),
 		events(0),
 		createTrackEntry(0),
-		disposeTrackEntry(0) {
+		disposeTrackEntry(0),
+		restoreEntries(0),
+		restoreEntriesCapacity(0) {
 	}
 #endif
 } _spAnimationState;
@@ -174,6 +426,12 @@ void _spAttachment_deinit (spAttachment* self);
 
 /**/
 
+typedef struct _spTimelineVtable {
+	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+			int* eventsCount, float alpha);
+	void (*dispose) (spTimeline* self);
+} _spTimelineVtable;
+
 void _spTimeline_init (spTimeline* self, spTimelineType type, /**/
 void (*dispose) (spTimeline* self), /**/
 		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
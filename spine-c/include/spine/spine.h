@@ -33,6 +33,7 @@
 #define SPINE_SPINE_H_
 
 #include <spine/Animation.h>
+#include <spine/AnimationLibrary.h>
 #include <spine/AnimationState.h>
 #include <spine/AnimationStateData.h>
 #include <spine/Atlas.h>
@@ -49,10 +50,16 @@
 #include <spine/SkeletonBounds.h>
 #include <spine/SkeletonData.h>
 #include <spine/SkeletonJson.h>
+#include <spine/SkeletonPool.h>
 #include <spine/Skin.h>
 #include <spine/Slot.h>
 #include <spine/SlotData.h>
 #include <spine/Event.h>
 #include <spine/EventData.h>
+#include <spine/PoseCache.h>
+#include <spine/RenderList.h>
+#include <spine/Imposter.h>
+#include <spine/LoadJob.h>
+#include <spine/AssetCache.h>
 
 #endif /* SPINE_SPINE_H_ */
@@ -35,7 +35,7 @@
 #include <spine/extension.h>
 
 spAnimation* spAnimation_create (const char* name, int timelinesCount) {
-	spAnimation* self = NEW(spAnimation);
+	spAnimation* self = SUPER(NEW(_spAnimation));
 	MALLOC_STR(self->name, name);
 	self->timelinesCount = timelinesCount;
 	self->timelines = MALLOC(spTimeline*, timelinesCount);
@@ -43,12 +43,18 @@ spAnimation* spAnimation_create (const char* name, int timelinesCount) {
 }
 
 void spAnimation_dispose (spAnimation* self) {
+	_spAnimation_disposeTimelines(self);
+	FREE(self->name);
+	FREE(self);
+}
+
+void _spAnimation_disposeTimelines (spAnimation* self) {
 	int i;
 	for (i = 0; i < self->timelinesCount; ++i)
 		spTimeline_dispose(self->timelines[i]);
 	FREE(self->timelines);
-	FREE(self->name);
-	FREE(self);
+	self->timelines = 0;
+	self->timelinesCount = 0;
 }
 
 void spAnimation_apply (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events,
@@ -77,13 +83,40 @@ void spAnimation_mix (const spAnimation* self, spSkeleton* skeleton, float lastT
 		spTimeline_apply(self->timelines[i], skeleton, lastTime, time, events, eventsCount, alpha);
 }
 
-/**/
+static int _spTimeline_isMasked (const spTimeline* timeline, const int* bonesMask) {
+	switch (timeline->type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE:
+		return bonesMask[((const spBaseTimeline*)timeline)->boneIndex];
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY:
+		return bonesMask[((const spFlipTimeline*)timeline)->boneIndex];
+	case SP_TIMELINE_EVENT:
+	case SP_TIMELINE_IKCONSTRAINT:
+		return 1;
+	default:
+		return 0;
+	}
+}
 
-typedef struct _spTimelineVtable {
-	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-			int* eventsCount, float alpha);
-	void (*dispose) (spTimeline* self);
-} _spTimelineVtable;
+void spAnimation_mixMasked (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventsCount, float alpha, const int* bonesMask) {
+	int i, n = self->timelinesCount;
+
+	if (loop && self->duration) {
+		time = FMOD(time, self->duration);
+		lastTime = FMOD(lastTime, self->duration);
+	}
+
+	for (i = 0; i < n; ++i) {
+		const spTimeline* timeline = self->timelines[i];
+		if (_spTimeline_isMasked(timeline, bonesMask))
+			spTimeline_apply(timeline, skeleton, lastTime, time, events, eventsCount, alpha);
+	}
+}
+
+/**/
 
 void _spTimeline_init (spTimeline* self, spTimelineType type, /**/
 void (*dispose) (spTimeline* self), /**/
@@ -489,19 +522,20 @@ void _spAttachmentTimeline_apply (const spTimeline* timeline, spSkeleton* skelet
 
 void _spAttachmentTimeline_dispose (spTimeline* timeline) {
 	spAttachmentTimeline* self = SUB_CAST(spAttachmentTimeline, timeline);
+	const _spStringPool* strings = SUB_CAST(_spAttachmentTimeline, self)->strings;
 	int i;
 
 	_spTimeline_deinit(timeline);
 
 	for (i = 0; i < self->framesCount; ++i)
-		FREE(self->attachmentNames[i]);
+		if (!_spStringPool_owns(strings, self->attachmentNames[i])) FREE(self->attachmentNames[i]);
 	FREE(self->attachmentNames);
 	FREE(self->frames);
 	FREE(self);
 }
 
 spAttachmentTimeline* spAttachmentTimeline_create (int framesCount) {
-	spAttachmentTimeline* self = NEW(spAttachmentTimeline);
+	spAttachmentTimeline* self = SUPER(NEW(_spAttachmentTimeline));
 	_spTimeline_init(SUPER(self), SP_TIMELINE_ATTACHMENT, _spAttachmentTimeline_dispose, _spAttachmentTimeline_apply);
 
 	CONST_CAST(int, self->framesCount) = framesCount;
@@ -512,13 +546,12 @@ spAttachmentTimeline* spAttachmentTimeline_create (int framesCount) {
 }
 
 void spAttachmentTimeline_setFrame (spAttachmentTimeline* self, int frameIndex, float time, const char* attachmentName) {
+	const _spStringPool* strings = SUB_CAST(_spAttachmentTimeline, self)->strings;
 	self->frames[frameIndex] = time;
 
-	FREE(self->attachmentNames[frameIndex]);
-	if (attachmentName)
-		MALLOC_STR(self->attachmentNames[frameIndex], attachmentName);
-	else
-		self->attachmentNames[frameIndex] = 0;
+	if (!_spStringPool_owns(strings, self->attachmentNames[frameIndex])) FREE(self->attachmentNames[frameIndex]);
+	self->attachmentNames[frameIndex] = attachmentName && strings ? _spStringPool_find(strings, attachmentName) : 0;
+	if (attachmentName && !self->attachmentNames[frameIndex]) MALLOC_STR(self->attachmentNames[frameIndex], attachmentName);
 }
 
 /**/
@@ -592,6 +625,7 @@ void _spDrawOrderTimeline_apply (const spTimeline* timeline, spSkeleton* skeleto
 	int i;
 	int frameIndex;
 	const int* drawOrderToSetupIndex;
+	int/*bool*/changed = 0;
 	spDrawOrderTimeline* self = (spDrawOrderTimeline*)timeline;
 
 	if (time < self->frames[0]) return; /* Time is before first frame. */
@@ -602,12 +636,13 @@ void _spDrawOrderTimeline_apply (const spTimeline* timeline, spSkeleton* skeleto
 		frameIndex = binarySearch1(self->frames, self->framesCount, time) - 1;
 
 	drawOrderToSetupIndex = self->drawOrders[frameIndex];
-	if (!drawOrderToSetupIndex)
-		memcpy(skeleton->drawOrder, skeleton->slots, self->slotsCount * sizeof(spSlot*));
-	else {
-		for (i = 0; i < self->slotsCount; ++i)
-			skeleton->drawOrder[i] = skeleton->slots[drawOrderToSetupIndex[i]];
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = skeleton->slots[drawOrderToSetupIndex ? drawOrderToSetupIndex[i] : i];
+		if (skeleton->drawOrder[i] == slot) continue;
+		skeleton->drawOrder[i] = slot;
+		changed = 1;
 	}
+	if (changed) spSkeleton_invalidateTopology(skeleton);
 }
 
 void _spDrawOrderTimeline_dispose (spTimeline* timeline) {
@@ -834,3 +869,124 @@ void spFlipTimeline_setFrame (spFlipTimeline* self, int frameIndex, float time,
 }
 
 /**/
+
+static const int ANIMATION_ENCODED = 0, ANIMATION_DECODING = 1, ANIMATION_DECODED = 2, ANIMATION_FAILED = 3;
+
+static int _spTimeline_getMemory (const spTimeline* timeline) {
+	int i, memory;
+	switch (timeline->type) {
+	case SP_TIMELINE_SCALE: /* fallthrough */
+	case SP_TIMELINE_ROTATE: /* fallthrough */
+	case SP_TIMELINE_TRANSLATE: /* fallthrough */
+	case SP_TIMELINE_COLOR: /* fallthrough */
+	case SP_TIMELINE_IKCONSTRAINT: {
+		const spBaseTimeline* self = (const spBaseTimeline*)timeline;
+		int frameSize = timeline->type == SP_TIMELINE_ROTATE ? 2 : (timeline->type == SP_TIMELINE_COLOR ? 5 : 3);
+		return sizeof(spBaseTimeline) + sizeof(float) * (self->framesCount + (self->framesCount / frameSize - 1) * BEZIER_SIZE);
+	}
+	case SP_TIMELINE_ATTACHMENT: {
+		const spAttachmentTimeline* self = (const spAttachmentTimeline*)timeline;
+		memory = sizeof(spAttachmentTimeline) + (sizeof(float) + sizeof(char*)) * self->framesCount;
+		for (i = 0; i < self->framesCount; ++i)
+			if (self->attachmentNames[i]) memory += (int)strlen(self->attachmentNames[i]) + 1;
+		return memory;
+	}
+	case SP_TIMELINE_EVENT: {
+		const spEventTimeline* self = (const spEventTimeline*)timeline;
+		return sizeof(spEventTimeline) + (sizeof(float) + sizeof(spEvent*) + sizeof(spEvent)) * self->framesCount;
+	}
+	case SP_TIMELINE_DRAWORDER: {
+		const spDrawOrderTimeline* self = (const spDrawOrderTimeline*)timeline;
+		memory = sizeof(spDrawOrderTimeline) + (sizeof(float) + sizeof(int*)) * self->framesCount;
+		for (i = 0; i < self->framesCount; ++i)
+			if (self->drawOrders[i]) memory += sizeof(int) * self->slotsCount;
+		return memory;
+	}
+	case SP_TIMELINE_FFD: {
+		const spFFDTimeline* self = (const spFFDTimeline*)timeline;
+		return sizeof(spFFDTimeline) + (sizeof(float) * (1 + self->frameVerticesCount + BEZIER_SIZE) + sizeof(float*))
+				* self->framesCount;
+	}
+	case SP_TIMELINE_FLIPX: /* fallthrough */
+	case SP_TIMELINE_FLIPY:
+		return sizeof(spFlipTimeline) + sizeof(float) * ((const spFlipTimeline*)timeline)->framesCount;
+	}
+	return 0;
+}
+
+/* Disposes of the timelines of the least recently used animations that are not acquired, until the decoded timelines fit in the
+ * budget. */
+static void _spAnimationDecoder_evict (_spAnimationDecoder* self, const spAnimation* keep) {
+	spSkeletonData* skeletonData = self->skeletonData;
+	while (self->memoryBudget && _spAtomic_get(&self->memoryUsed) > self->memoryBudget) {
+		_spAnimation* oldest = 0;
+		int i, oldestUse = 0;
+		for (i = 0; i < skeletonData->animationsCount; ++i) {
+			_spAnimation* animation = SUB_CAST(_spAnimation, skeletonData->animations[i]);
+			int lastUsed;
+			if (SUPER(animation) == keep || _spAtomic_get(&animation->state) != ANIMATION_DECODED
+					|| _spAtomic_get(&animation->references) != 0) continue;
+			lastUsed = _spAtomic_get(&animation->lastUsed);
+			if (!oldest || lastUsed - oldestUse < 0) {
+				oldest = animation;
+				oldestUse = lastUsed;
+			}
+		}
+		if (!oldest) return;
+
+		/* Holding the state keeps it from being decoded or evicted by another thread. A reference taken before the state is
+		 * held is seen here, one taken after waits in spAnimation_decode until the state is released, then decodes it again. */
+		if (!_spAtomic_compareAndSet(&oldest->state, ANIMATION_DECODED, ANIMATION_DECODING)) continue;
+		if (_spAtomic_get(&oldest->references) != 0) {
+			_spAtomic_set(&oldest->state, ANIMATION_DECODED);
+			_spAtomic_set(&oldest->lastUsed, _spAtomic_add(&self->clock, 1));
+			continue;
+		}
+		_spAnimation_disposeTimelines(SUPER(oldest));
+		_spAtomic_add(&self->memoryUsed, -oldest->memory);
+		oldest->memory = 0;
+		_spAtomic_set(&oldest->state, ANIMATION_ENCODED);
+	}
+}
+
+int spAnimation_decode (const spAnimation* self) {
+	int i;
+	_spAnimation* internal = SUB_CAST(_spAnimation, self);
+	_spAnimationDecoder* decoder = internal->decoder;
+	if (!decoder) return 1;
+
+	_spAtomic_set(&internal->lastUsed, _spAtomic_add(&decoder->clock, 1));
+	for (;;) {
+		int state = _spAtomic_get(&internal->state);
+		if (state == ANIMATION_DECODED) return 1;
+		if (state == ANIMATION_FAILED) return 0;
+		/* Waits while another thread decodes or evicts it, which doesn't depend on any other thread to finish. */
+		if (state == ANIMATION_ENCODED && _spAtomic_compareAndSet(&internal->state, ANIMATION_ENCODED, ANIMATION_DECODING)) break;
+	}
+
+	if (!decoder->decode(decoder, SUPER(internal), internal->source)) {
+		_spAnimation_disposeTimelines(SUPER(internal));
+		_spAtomic_set(&internal->state, ANIMATION_FAILED);
+		return 0;
+	}
+	internal->memory = 0;
+	for (i = 0; i < self->timelinesCount; ++i)
+		internal->memory += _spTimeline_getMemory(self->timelines[i]);
+	_spAtomic_add(&decoder->memoryUsed, internal->memory);
+	_spAtomic_set(&internal->state, ANIMATION_DECODED);
+
+	_spAnimationDecoder_evict(decoder, self);
+	return 1;
+}
+
+int spAnimation_acquire (const spAnimation* self) {
+	_spAnimation* internal = SUB_CAST(_spAnimation, self);
+	if (!internal->decoder) return 1;
+	_spAtomic_add(&internal->references, 1);
+	return spAnimation_decode(self);
+}
+
+void spAnimation_release (const spAnimation* self) {
+	_spAnimation* internal = SUB_CAST(_spAnimation, self);
+	if (internal->decoder && _spAtomic_add(&internal->references, -1) == 0) _spAnimationDecoder_evict(internal->decoder, 0);
+}
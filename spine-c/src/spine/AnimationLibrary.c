@@ -0,0 +1,296 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/AnimationLibrary.h>
+#include <spine/extension.h>
+
+spAnimationLibrary* spAnimationLibrary_create (spSkeletonData* skeletonData) {
+	int i;
+	spAnimationLibrary* self = NEW(spAnimationLibrary);
+	CONST_CAST(spSkeletonData*, self->skeletonData) = skeletonData;
+	/* Bound animations share the timelines, so they must not be evicted. */
+	for (i = 0; i < skeletonData->animationsCount; ++i)
+		spAnimation_acquire(skeletonData->animations[i]);
+	return self;
+}
+
+void spAnimationLibrary_dispose (spAnimationLibrary* self) {
+	int i;
+	for (i = 0; i < self->skeletonData->animationsCount; ++i)
+		spAnimation_release(self->skeletonData->animations[i]);
+	FREE(self);
+}
+
+/**/
+
+/* Bound timelines are shallow copies of the library's timelines, they only own what binding replaced. */
+
+static void _spBoundTimeline_dispose (spTimeline* self) {
+	_spTimeline_deinit(self);
+	FREE(self);
+}
+
+static void _spBoundEventTimeline_dispose (spTimeline* timeline) {
+	spEventTimeline* self = SUB_CAST(spEventTimeline, timeline);
+	int i;
+	for (i = 0; i < self->framesCount; ++i)
+		spEvent_dispose(self->events[i]);
+	FREE(self->events);
+	_spBoundTimeline_dispose(timeline);
+}
+
+static void _spBoundDrawOrderTimeline_dispose (spTimeline* timeline) {
+	spDrawOrderTimeline* self = SUB_CAST(spDrawOrderTimeline, timeline);
+	int i;
+	for (i = 0; i < self->framesCount; ++i)
+		FREE(self->drawOrders[i]);
+	FREE(self->drawOrders);
+	_spBoundTimeline_dispose(timeline);
+}
+
+/**/
+
+typedef struct {
+	const spSkeletonData* library;
+	const spSkeletonData* skeletonData;
+	int* boneIndices; /* For each bone of the library, the index in the skeleton data or -1. */
+	int* slotIndices;
+	int* ikConstraintIndices;
+	int/*bool*/sameSlots;
+} _spBinding;
+
+static int _spFFDTimeline_getVerticesCount (const spAttachment* attachment) {
+	if (attachment->type == SP_ATTACHMENT_MESH) return SUB_CAST(spMeshAttachment, attachment)->verticesCount;
+	if (attachment->type == SP_ATTACHMENT_SKINNED_MESH) return SUB_CAST(spSkinnedMeshAttachment, attachment)->weightsCount / 3 * 2;
+	return 0;
+}
+
+/* Returns the attachment of the skeleton data with the same skin, slot and name as the library's attachment, or 0. */
+static spAttachment* _spBinding_findAttachment (const _spBinding* self, int slotIndex, const spAttachment* attachment) {
+	int i, ii;
+	for (i = 0; i < self->library->skinsCount; ++i) {
+		const spSkin* skin = self->library->skins[i];
+		const char* name;
+		for (ii = 0; (name = spSkin_getAttachmentName(skin, slotIndex, ii)) != 0; ++ii) {
+			if (spSkin_getAttachment(skin, slotIndex, name) != attachment) continue;
+			skin = spSkeletonData_findSkin(self->skeletonData, skin->name);
+			return skin ? spSkin_getAttachment(skin, self->slotIndices[slotIndex], name) : 0;
+		}
+	}
+	return 0;
+}
+
+/* Returns 0 if the timeline can't be bound to the skeleton data. */
+static spTimeline* _spBinding_bindTimeline (const _spBinding* self, const spTimeline* timeline) {
+	spTimeline* bound;
+	size_t size;
+	int i, ii;
+
+	switch (timeline->type) {
+	case SP_TIMELINE_SCALE: /* fallthrough */
+	case SP_TIMELINE_ROTATE: /* fallthrough */
+	case SP_TIMELINE_TRANSLATE:
+		if (self->boneIndices[((const spBaseTimeline*)timeline)->boneIndex] == -1) return 0;
+		size = sizeof(spBaseTimeline);
+		break;
+	case SP_TIMELINE_COLOR:
+		if (self->slotIndices[((const spColorTimeline*)timeline)->slotIndex] == -1) return 0;
+		size = sizeof(spColorTimeline);
+		break;
+	case SP_TIMELINE_ATTACHMENT:
+		if (self->slotIndices[((const spAttachmentTimeline*)timeline)->slotIndex] == -1) return 0;
+		size = sizeof(_spAttachmentTimeline);
+		break;
+	case SP_TIMELINE_EVENT:
+		size = sizeof(spEventTimeline);
+		break;
+	case SP_TIMELINE_DRAWORDER:
+		if (!self->sameSlots) return 0;
+		size = sizeof(spDrawOrderTimeline);
+		break;
+	case SP_TIMELINE_FFD:
+		if (self->slotIndices[((const spFFDTimeline*)timeline)->slotIndex] == -1) return 0;
+		size = sizeof(spFFDTimeline);
+		break;
+	case SP_TIMELINE_IKCONSTRAINT:
+		if (self->ikConstraintIndices[((const spIkConstraintTimeline*)timeline)->ikConstraintIndex] == -1) return 0;
+		size = sizeof(spIkConstraintTimeline);
+		break;
+	case SP_TIMELINE_FLIPX: /* fallthrough */
+	case SP_TIMELINE_FLIPY:
+		if (self->boneIndices[((const spFlipTimeline*)timeline)->boneIndex] == -1) return 0;
+		size = sizeof(spFlipTimeline);
+		break;
+	default:
+		return 0;
+	}
+
+	bound = (spTimeline*)MALLOC(char, size);
+	memcpy((void*)bound, timeline, size);
+	_spTimeline_init(bound, timeline->type, _spBoundTimeline_dispose, VTABLE(spTimeline, timeline)->apply);
+
+	switch (timeline->type) {
+	case SP_TIMELINE_SCALE: /* fallthrough */
+	case SP_TIMELINE_ROTATE: /* fallthrough */
+	case SP_TIMELINE_TRANSLATE: {
+		spBaseTimeline* boundTimeline = SUB_CAST(spBaseTimeline, bound);
+		boundTimeline->boneIndex = self->boneIndices[boundTimeline->boneIndex];
+		break;
+	}
+	case SP_TIMELINE_COLOR: {
+		spColorTimeline* boundTimeline = SUB_CAST(spColorTimeline, bound);
+		boundTimeline->slotIndex = self->slotIndices[boundTimeline->slotIndex];
+		break;
+	}
+	case SP_TIMELINE_ATTACHMENT: {
+		/* The attachment names stay shared with the library. */
+		spAttachmentTimeline* boundTimeline = SUB_CAST(spAttachmentTimeline, bound);
+		boundTimeline->slotIndex = self->slotIndices[boundTimeline->slotIndex];
+		break;
+	}
+	case SP_TIMELINE_EVENT: {
+		spEventTimeline* boundTimeline = SUB_CAST(spEventTimeline, bound);
+		spEvent** events = MALLOC(spEvent*, boundTimeline->framesCount);
+		for (i = 0; i < boundTimeline->framesCount; ++i) {
+			const spEvent* event = boundTimeline->events[i];
+			spEventData* data = spSkeletonData_findEvent(self->skeletonData, event->data->name);
+			events[i] = spEvent_create(data ? data : event->data);
+			events[i]->intValue = event->intValue;
+			events[i]->floatValue = event->floatValue;
+			if (event->stringValue) MALLOC_STR(events[i]->stringValue, event->stringValue);
+		}
+		CONST_CAST(spEvent**, boundTimeline->events) = events;
+		VTABLE(spTimeline, bound)->dispose = _spBoundEventTimeline_dispose;
+		break;
+	}
+	case SP_TIMELINE_DRAWORDER: {
+		spDrawOrderTimeline* boundTimeline = SUB_CAST(spDrawOrderTimeline, bound);
+		const int** drawOrders = MALLOC(const int*, boundTimeline->framesCount);
+		for (i = 0; i < boundTimeline->framesCount; ++i) {
+			const int* drawOrder = boundTimeline->drawOrders[i];
+			int* boundDrawOrder = MALLOC(int, boundTimeline->slotsCount);
+			for (ii = 0; ii < boundTimeline->slotsCount; ++ii)
+				boundDrawOrder[ii] = self->slotIndices[drawOrder ? drawOrder[ii] : ii];
+			drawOrders[i] = boundDrawOrder;
+		}
+		CONST_CAST(const int**, boundTimeline->drawOrders) = drawOrders;
+		VTABLE(spTimeline, bound)->dispose = _spBoundDrawOrderTimeline_dispose;
+		break;
+	}
+	case SP_TIMELINE_FFD: {
+		spFFDTimeline* boundTimeline = SUB_CAST(spFFDTimeline, bound);
+		boundTimeline->attachment = _spBinding_findAttachment(self, boundTimeline->slotIndex, boundTimeline->attachment);
+		boundTimeline->slotIndex = self->slotIndices[boundTimeline->slotIndex];
+		if (!boundTimeline->attachment
+				|| _spFFDTimeline_getVerticesCount(boundTimeline->attachment) != boundTimeline->frameVerticesCount) {
+			spTimeline_dispose(bound);
+			return 0;
+		}
+		break;
+	}
+	case SP_TIMELINE_IKCONSTRAINT: {
+		spIkConstraintTimeline* boundTimeline = SUB_CAST(spIkConstraintTimeline, bound);
+		boundTimeline->ikConstraintIndex = self->ikConstraintIndices[boundTimeline->ikConstraintIndex];
+		break;
+	}
+	case SP_TIMELINE_FLIPX: /* fallthrough */
+	case SP_TIMELINE_FLIPY: {
+		spFlipTimeline* boundTimeline = SUB_CAST(spFlipTimeline, bound);
+		boundTimeline->boneIndex = self->boneIndices[boundTimeline->boneIndex];
+		break;
+	}
+	}
+	return bound;
+}
+
+static int/*bool*/_spSkeletonData_hasAnimation (const spSkeletonData* self, int animationsCount, const char* name) {
+	int i;
+	for (i = 0; i < animationsCount; ++i)
+		if (strcmp(self->animations[i]->name, name) == 0) return 1;
+	return 0;
+}
+
+int spAnimationLibrary_bind (const spAnimationLibrary* self, spSkeletonData* skeletonData) {
+	const spSkeletonData* library = self->skeletonData;
+	_spBinding binding;
+	spAnimation** animations;
+	int i, ii, animationsCount = skeletonData->animationsCount, unboundCount = 0;
+
+	binding.library = library;
+	binding.skeletonData = skeletonData;
+	binding.boneIndices = MALLOC(int, library->bonesCount);
+	for (i = 0; i < library->bonesCount; ++i)
+		binding.boneIndices[i] = spSkeletonData_findBoneIndex(skeletonData, library->bones[i]->name);
+	binding.sameSlots = library->slotsCount == skeletonData->slotsCount;
+	binding.slotIndices = MALLOC(int, library->slotsCount);
+	for (i = 0; i < library->slotsCount; ++i) {
+		binding.slotIndices[i] = spSkeletonData_findSlotIndex(skeletonData, library->slots[i]->name);
+		if (binding.slotIndices[i] == -1) binding.sameSlots = 0;
+	}
+	binding.ikConstraintIndices = MALLOC(int, library->ikConstraintsCount);
+	for (i = 0; i < library->ikConstraintsCount; ++i) {
+		binding.ikConstraintIndices[i] = -1;
+		for (ii = 0; ii < skeletonData->ikConstraintsCount; ++ii) {
+			if (strcmp(skeletonData->ikConstraints[ii]->name, library->ikConstraints[i]->name) == 0) {
+				binding.ikConstraintIndices[i] = ii;
+				break;
+			}
+		}
+	}
+
+	animations = MALLOC(spAnimation*, skeletonData->animationsCount + library->animationsCount);
+	memcpy(animations, skeletonData->animations, sizeof(spAnimation*) * skeletonData->animationsCount);
+	FREE(skeletonData->animations);
+	skeletonData->animations = animations;
+	for (i = 0; i < library->animationsCount; ++i) {
+		const spAnimation* animation = library->animations[i];
+		spAnimation* bound;
+		if (_spSkeletonData_hasAnimation(skeletonData, animationsCount, animation->name)) continue;
+		bound = spAnimation_create(animation->name, animation->timelinesCount);
+		bound->duration = animation->duration;
+		bound->timelinesCount = 0;
+		for (ii = 0; ii < animation->timelinesCount; ++ii) {
+			spTimeline* timeline = _spBinding_bindTimeline(&binding, animation->timelines[ii]);
+			if (timeline)
+				bound->timelines[bound->timelinesCount++] = timeline;
+			else
+				++unboundCount;
+		}
+		animations[animationsCount++] = bound;
+	}
+	skeletonData->animationsCount = animationsCount;
+	if (SUB_CAST(_spSkeletonData, skeletonData)->strings) _spSkeletonData_internStrings(skeletonData);
+
+	FREE(binding.boneIndices);
+	FREE(binding.slotIndices);
+	FREE(binding.ikConstraintIndices);
+	return unboundCount;
+}
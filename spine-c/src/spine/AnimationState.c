@@ -32,6 +32,7 @@
 #include <spine/AnimationState.h>
 #include <spine/extension.h>
 #include <string.h>
+#include <stddef.h>
 
 spTrackEntry* _spTrackEntry_create (spAnimationState* state) {
 	spTrackEntry* self = NEW(spTrackEntry);
@@ -44,6 +45,7 @@ spTrackEntry* _spTrackEntry_create (spAnimationState* state) {
 
 void _spTrackEntry_dispose (spTrackEntry* self) {
 	if (self->previous) SUB_CAST(_spAnimationState, self->state)->disposeTrackEntry(self->previous);
+	if (self->animation) spAnimation_release(self->animation);
 	FREE(self);
 }
 
@@ -81,6 +83,7 @@ void spAnimationState_dispose (spAnimationState* self) {
 	int i;
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	FREE(internal->events);
+	FREE(internal->restoreEntries);
 	for (i = 0; i < self->tracksCount; ++i)
 		_spAnimationState_disposeAllEntries(self, self->tracks[i]);
 	FREE(self->tracks);
@@ -114,7 +117,17 @@ void spAnimationState_update (spAnimationState* self, float delta) {
 	}
 }
 
-void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
+static void _spAnimationState_mixAnimation (const spAnimation* animation, spSkeleton* skeleton, float lastTime, float time,
+		int loop, spEvent** events, int* eventsCount, float alpha, const int* bonesMask) {
+	if (bonesMask)
+		spAnimation_mixMasked(animation, skeleton, lastTime, time, loop, events, eventsCount, alpha, bonesMask);
+	else if (alpha == 1)
+		spAnimation_apply(animation, skeleton, lastTime, time, loop, events, eventsCount);
+	else
+		spAnimation_mix(animation, skeleton, lastTime, time, loop, events, eventsCount, alpha);
+}
+
+static void _spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton, const int* bonesMask) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 
 	int i, ii;
@@ -133,27 +146,23 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 
 		previous = current->previous;
 		if (!previous) {
-			if (current->mix == 1) {
-				spAnimation_apply(current->animation, skeleton, current->lastTime, time,
-					current->loop, internal->events, &eventsCount);
-			} else {
-				spAnimation_mix(current->animation, skeleton, current->lastTime, time,
-					current->loop, internal->events, &eventsCount, current->mix);
-			}
+			_spAnimationState_mixAnimation(current->animation, skeleton, current->lastTime, time,
+				current->loop, internal->events, &eventsCount, current->mix, bonesMask);
 		} else {
 			float alpha = current->mixTime / current->mixDuration * current->mix;
 
 			float previousTime = previous->time;
 			if (!previous->loop && previousTime > previous->endTime) previousTime = previous->endTime;
-			spAnimation_apply(previous->animation, skeleton, previousTime, previousTime, previous->loop, 0, 0);
+			_spAnimationState_mixAnimation(previous->animation, skeleton, previousTime, previousTime, previous->loop, 0, 0, 1,
+				bonesMask);
 
 			if (alpha >= 1) {
 				alpha = 1;
 				internal->disposeTrackEntry(current->previous);
 				current->previous = 0;
 			}
-			spAnimation_mix(current->animation, skeleton, current->lastTime, time,
-				current->loop, internal->events, &eventsCount, alpha);
+			_spAnimationState_mixAnimation(current->animation, skeleton, current->lastTime, time,
+				current->loop, internal->events, &eventsCount, alpha, bonesMask);
 		}
 
 		entryChanged = 0;
@@ -194,6 +203,14 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 	}
 }
 
+void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
+	_spAnimationState_apply(self, skeleton, 0);
+}
+
+void spAnimationState_applyMasked (spAnimationState* self, spSkeleton* skeleton, const int* bonesMask) {
+	_spAnimationState_apply(self, skeleton, bonesMask);
+}
+
 void spAnimationState_clearTracks (spAnimationState* self) {
 	int i;
 	for (i = 0; i < self->tracksCount; ++i)
@@ -219,7 +236,7 @@ spTrackEntry* _spAnimationState_expandToIndex (spAnimationState* self, int index
 	spTrackEntry** newTracks;
 	if (index < self->tracksCount) return self->tracks[index];
 	newTracks = CALLOC(spTrackEntry*, index + 1);
-	memcpy(newTracks, self->tracks, self->tracksCount * sizeof(spTrackEntry*));
+	if (self->tracksCount) memcpy(newTracks, self->tracks, self->tracksCount * sizeof(spTrackEntry*));
 	FREE(self->tracks);
 	self->tracks = newTracks;
 	self->tracksCount = index + 1;
@@ -275,6 +292,7 @@ spTrackEntry* spAnimationState_setAnimation (spAnimationState* self, int trackIn
 	if (current) _spAnimationState_disposeAllEntries(self, current->next);
 
 	entry = internal->createTrackEntry(self);
+	spAnimation_acquire(animation);
 	entry->animation = animation;
 	entry->loop = loop;
 	entry->endTime = animation->duration;
@@ -294,6 +312,7 @@ spTrackEntry* spAnimationState_addAnimation (spAnimationState* self, int trackIn
 	spTrackEntry* last;
 
 	spTrackEntry* entry = internal->createTrackEntry(self);
+	spAnimation_acquire(animation);
 	entry->animation = animation;
 	entry->loop = loop;
 	entry->endTime = animation->duration;
@@ -321,3 +340,138 @@ spTrackEntry* spAnimationState_getCurrent (spAnimationState* self, int trackInde
 	if (trackIndex >= self->tracksCount) return 0;
 	return self->tracks[trackIndex];
 }
+
+/**/
+
+/* Animation, loop, times, listener and mix are contiguous. */
+#define ENTRY_STATE_SIZE (offsetof(spTrackEntry, mix) + sizeof(float) - offsetof(spTrackEntry, animation))
+
+typedef struct {
+	int size;
+	int tracksCount;
+	float timeScale;
+	int entriesCount;
+} _spAnimationStateSnapshot;
+
+/* The snapshot has 2 counts for each track: the current and queued entries, then the previous entries being mixed out. The
+ * ENTRY_STATE_SIZE bytes of each entry follow in the same order. */
+static int _spAnimationState_countEntries (const spAnimationState* self, int* counts) {
+	int i, total = 0;
+	for (i = 0; i < self->tracksCount; ++i) {
+		spTrackEntry* entry;
+		int count = 0, previousCount = 0;
+		for (entry = self->tracks[i]; entry; entry = entry->next)
+			count++;
+		if (self->tracks[i]) {
+			for (entry = self->tracks[i]->previous; entry; entry = entry->previous)
+				previousCount++;
+		}
+		if (counts) {
+			counts[i * 2] = count;
+			counts[i * 2 + 1] = previousCount;
+		}
+		total += count + previousCount;
+	}
+	return total;
+}
+
+int spAnimationState_getSnapshotSize (const spAnimationState* self) {
+	return sizeof(_spAnimationStateSnapshot) + sizeof(int) * 2 * self->tracksCount
+			+ ENTRY_STATE_SIZE * _spAnimationState_countEntries(self, 0);
+}
+
+int spAnimationState_snapshot (const spAnimationState* self, void* buffer) {
+	int i;
+	_spAnimationStateSnapshot* snapshot = (_spAnimationStateSnapshot*)buffer;
+	int* counts = (int*)(snapshot + 1);
+	char* entries = (char*)(counts + self->tracksCount * 2);
+
+	snapshot->tracksCount = self->tracksCount;
+	snapshot->timeScale = self->timeScale;
+	snapshot->entriesCount = _spAnimationState_countEntries(self, counts);
+	snapshot->size = sizeof(_spAnimationStateSnapshot) + sizeof(int) * 2 * self->tracksCount
+			+ ENTRY_STATE_SIZE * snapshot->entriesCount;
+
+	for (i = 0; i < self->tracksCount; ++i) {
+		spTrackEntry* entry;
+		for (entry = self->tracks[i]; entry; entry = entry->next, entries += ENTRY_STATE_SIZE)
+			memcpy(entries, &entry->animation, ENTRY_STATE_SIZE);
+		if (self->tracks[i]) {
+			for (entry = self->tracks[i]->previous; entry; entry = entry->previous, entries += ENTRY_STATE_SIZE)
+				memcpy(entries, &entry->animation, ENTRY_STATE_SIZE);
+		}
+	}
+	return snapshot->size;
+}
+
+/* Copies the stored state into the entry, or into a new entry if it is 0. The entry is unlinked. */
+static spTrackEntry* _spAnimationState_restoreEntry (spAnimationState* self, spTrackEntry* entry, const char* stored) {
+	spAnimation* animation;
+	if (!entry) entry = SUB_CAST(_spAnimationState, self)->createTrackEntry(self);
+	animation = entry->animation;
+	memcpy((void*)&entry->animation, stored, ENTRY_STATE_SIZE);
+	entry->next = 0;
+	entry->previous = 0;
+	/* The new animation is acquired before the old one is released, so neither is evicted when they are the same. */
+	if (entry->animation != animation) {
+		if (entry->animation) spAnimation_acquire(entry->animation);
+		if (animation) spAnimation_release(animation);
+	}
+	return entry;
+}
+
+int spAnimationState_restore (spAnimationState* self, const void* buffer) {
+	int i, ii, n = 0, reused = 0;
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	const _spAnimationStateSnapshot* snapshot = (const _spAnimationStateSnapshot*)buffer;
+	const int* counts = (const int*)(snapshot + 1);
+	const char* entries = (const char*)(counts + snapshot->tracksCount * 2);
+	int existingCount = _spAnimationState_countEntries(self, 0);
+
+	/* Collects the existing entries in snapshot order, so each stored entry reuses the entry at the same place. */
+	if (existingCount > internal->restoreEntriesCapacity) {
+		FREE(internal->restoreEntries);
+		internal->restoreEntries = MALLOC(spTrackEntry*, existingCount);
+		internal->restoreEntriesCapacity = existingCount;
+	}
+	for (i = 0; i < self->tracksCount; ++i) {
+		spTrackEntry* entry;
+		for (entry = self->tracks[i]; entry; entry = entry->next)
+			internal->restoreEntries[n++] = entry;
+		if (self->tracks[i]) {
+			for (entry = self->tracks[i]->previous; entry; entry = entry->previous)
+				internal->restoreEntries[n++] = entry;
+		}
+	}
+
+	if (snapshot->tracksCount != self->tracksCount) {
+		FREE(self->tracks);
+		self->tracks = CALLOC(spTrackEntry*, snapshot->tracksCount);
+		self->tracksCount = snapshot->tracksCount;
+	}
+	self->timeScale = snapshot->timeScale;
+
+	for (i = 0; i < self->tracksCount; ++i) {
+		spTrackEntry** link = self->tracks + i;
+		for (ii = 0; ii < counts[i * 2]; ++ii, entries += ENTRY_STATE_SIZE) {
+			*link = _spAnimationState_restoreEntry(self, reused < n ? internal->restoreEntries[reused++] : 0, entries);
+			link = &(*link)->next;
+		}
+		*link = 0;
+		if (!self->tracks[i]) continue;
+		link = &self->tracks[i]->previous;
+		for (ii = 0; ii < counts[i * 2 + 1]; ++ii, entries += ENTRY_STATE_SIZE) {
+			*link = _spAnimationState_restoreEntry(self, reused < n ? internal->restoreEntries[reused++] : 0, entries);
+			link = &(*link)->previous;
+		}
+	}
+
+	/* Disposes the entries left over, unlinked so the entries they were mixing from are not disposed with them. */
+	for (; reused < n; ++reused) {
+		spTrackEntry* entry = internal->restoreEntries[reused];
+		entry->next = 0;
+		entry->previous = 0;
+		internal->disposeTrackEntry(entry);
+	}
+	return snapshot->size;
+}
@@ -0,0 +1,229 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/AssetCache.h>
+#include <spine/SkeletonJson.h>
+#include <spine/extension.h>
+
+typedef struct _spAtlasEntry _spAtlasEntry;
+struct _spAtlasEntry {
+	char* path;
+	spAtlas* atlas;
+	int references; /* Including one for each cached skeleton data using the atlas. */
+	_spAtlasEntry* next;
+};
+
+typedef struct _spSkeletonDataEntry _spSkeletonDataEntry;
+struct _spSkeletonDataEntry {
+	char* path;
+	float scale;
+	_spAtlasEntry* atlas;
+	spSkeletonData* skeletonData;
+	int references;
+	_spSkeletonDataEntry* next;
+};
+
+typedef struct {
+	spAssetCache super;
+	_spAtlasEntry* atlases;
+	_spSkeletonDataEntry* skeletonData;
+} _spAssetCache;
+
+static void _spAssetCache_setError (spAssetCache* self, const char* value1, const char* value2) {
+	FREE(self->error);
+	CONST_CAST(char*, self->error) = _formatError(value1, value2);
+}
+
+spAssetCache* spAssetCache_create () {
+	return SUPER(NEW(_spAssetCache));
+}
+
+void spAssetCache_dispose (spAssetCache* self) {
+	_spAssetCache* internal = SUB_CAST(_spAssetCache, self);
+	while (internal->skeletonData) {
+		_spSkeletonDataEntry* next = internal->skeletonData->next;
+		spSkeletonData_dispose(internal->skeletonData->skeletonData);
+		FREE(internal->skeletonData->path);
+		FREE(internal->skeletonData);
+		internal->skeletonData = next;
+	}
+	while (internal->atlases) {
+		_spAtlasEntry* next = internal->atlases->next;
+		spAtlas_dispose(internal->atlases->atlas);
+		FREE(internal->atlases->path);
+		FREE(internal->atlases);
+		internal->atlases = next;
+	}
+	FREE(self->error);
+	FREE(self);
+}
+
+static _spAtlasEntry* _spAssetCache_acquireAtlasEntry (_spAssetCache* self, const char* atlasPath) {
+	spAtlas* atlas;
+	_spAtlasEntry* entry;
+	for (entry = self->atlases; entry; entry = entry->next) {
+		if (strcmp(entry->path, atlasPath) == 0) {
+			entry->references++;
+			CONST_CAST(int, self->super.hits)++;
+			return entry;
+		}
+	}
+
+	CONST_CAST(int, self->super.misses)++;
+	atlas = spAtlas_createFromFile(atlasPath, 0);
+	if (!atlas) {
+		_spAssetCache_setError(SUPER(self), "Error reading atlas file: ", atlasPath);
+		return 0;
+	}
+	entry = NEW(_spAtlasEntry);
+	MALLOC_STR(entry->path, atlasPath);
+	entry->atlas = atlas;
+	entry->references = 1;
+	entry->next = self->atlases;
+	self->atlases = entry;
+	CONST_CAST(int, self->super.atlasesCount)++;
+	return entry;
+}
+
+static void _spAssetCache_releaseAtlasEntry (_spAtlasEntry* entry) {
+	if (entry->references > 0) entry->references--;
+}
+
+spAtlas* spAssetCache_acquireAtlas (spAssetCache* self, const char* atlasPath) {
+	_spAtlasEntry* entry = _spAssetCache_acquireAtlasEntry(SUB_CAST(_spAssetCache, self), atlasPath);
+	return entry ? entry->atlas : 0;
+}
+
+void spAssetCache_releaseAtlas (spAssetCache* self, spAtlas* atlas) {
+	_spAtlasEntry* entry;
+	for (entry = SUB_CAST(_spAssetCache, self)->atlases; entry; entry = entry->next) {
+		if (entry->atlas == atlas) {
+			_spAssetCache_releaseAtlasEntry(entry);
+			return;
+		}
+	}
+}
+
+spSkeletonData* spAssetCache_acquireSkeletonData (spAssetCache* self, const char* skeletonPath, const char* atlasPath,
+		float scale) {
+	_spAssetCache* internal = SUB_CAST(_spAssetCache, self);
+	_spAtlasEntry* atlas;
+	_spSkeletonDataEntry* entry;
+	spSkeletonJson* json;
+	spSkeletonData* skeletonData;
+
+	for (entry = internal->skeletonData; entry; entry = entry->next) {
+		if (entry->scale == scale && strcmp(entry->path, skeletonPath) == 0 && strcmp(entry->atlas->path, atlasPath) == 0) {
+			entry->references++;
+			CONST_CAST(int, self->hits)++;
+			return entry->skeletonData;
+		}
+	}
+
+	/* The skeleton data's reference to the atlas is held while the skeleton data is cached. */
+	atlas = _spAssetCache_acquireAtlasEntry(internal, atlasPath);
+	if (!atlas) return 0;
+
+	CONST_CAST(int, self->misses)++;
+	json = spSkeletonJson_create(atlas->atlas);
+	json->scale = scale;
+	json->parallelFor = self->parallelFor;
+	skeletonData = spSkeletonJson_readSkeletonDataFile(json, skeletonPath);
+	if (!skeletonData) {
+		_spAssetCache_setError(self, json->error, 0);
+		spSkeletonJson_dispose(json);
+		_spAssetCache_releaseAtlasEntry(atlas);
+		return 0;
+	}
+	spSkeletonJson_dispose(json);
+
+	entry = NEW(_spSkeletonDataEntry);
+	MALLOC_STR(entry->path, skeletonPath);
+	entry->scale = scale;
+	entry->atlas = atlas;
+	entry->skeletonData = skeletonData;
+	entry->references = 1;
+	entry->next = internal->skeletonData;
+	internal->skeletonData = entry;
+	CONST_CAST(int, self->skeletonDataCount)++;
+	return skeletonData;
+}
+
+void spAssetCache_releaseSkeletonData (spAssetCache* self, spSkeletonData* skeletonData) {
+	_spSkeletonDataEntry* entry;
+	for (entry = SUB_CAST(_spAssetCache, self)->skeletonData; entry; entry = entry->next) {
+		if (entry->skeletonData == skeletonData) {
+			if (entry->references > 0) entry->references--;
+			return;
+		}
+	}
+}
+
+int spAssetCache_preload (spAssetCache* self, const char* skeletonPath, const char* atlasPath, float scale) {
+	spSkeletonData* skeletonData = spAssetCache_acquireSkeletonData(self, skeletonPath, atlasPath, scale);
+	if (!skeletonData) return 0;
+	spAssetCache_releaseSkeletonData(self, skeletonData);
+	return 1;
+}
+
+void spAssetCache_purge (spAssetCache* self) {
+	_spAssetCache* internal = SUB_CAST(_spAssetCache, self);
+	_spSkeletonDataEntry** skeletonData = &internal->skeletonData;
+	_spAtlasEntry** atlas = &internal->atlases;
+
+	/* Skeleton data first, so the atlases they release can be purged too. */
+	while (*skeletonData) {
+		_spSkeletonDataEntry* entry = *skeletonData;
+		if (entry->references) {
+			skeletonData = &entry->next;
+			continue;
+		}
+		*skeletonData = entry->next;
+		spSkeletonData_dispose(entry->skeletonData);
+		_spAssetCache_releaseAtlasEntry(entry->atlas);
+		FREE(entry->path);
+		FREE(entry);
+		CONST_CAST(int, self->skeletonDataCount)--;
+	}
+
+	while (*atlas) {
+		_spAtlasEntry* entry = *atlas;
+		if (entry->references) {
+			atlas = &entry->next;
+			continue;
+		}
+		*atlas = entry->next;
+		spAtlas_dispose(entry->atlas);
+		FREE(entry->path);
+		FREE(entry);
+		CONST_CAST(int, self->atlasesCount)--;
+	}
+}
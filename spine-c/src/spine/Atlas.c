@@ -33,6 +33,25 @@
 #include <ctype.h>
 #include <spine/extension.h>
 
+typedef struct {
+	spAtlas super;
+
+	char* dir; /* Prefixed to the page names to get the image paths. */
+	int/*bool*/createTextures; /* False while an atlas is read by _spAtlas_createFromFileWithoutTextures. */
+
+	/* The names of the regions read from binary data, NUL terminated, in one allocation. */
+	char* strings;
+	int stringsLength;
+	/* The names of the regions read from text, each distinct name once. Regions of a sequence have the same name. */
+	_spStringPool* names;
+	/* The last region read by the parser. Regions up to it use names in strings or names and are in the index. */
+	spAtlasRegion* lastRegion;
+
+	/* Open addressing hash table of the regions up to lastRegion, capacity is a power of two. */
+	spAtlasRegion** index;
+	int indexCapacity;
+} _spAtlas;
+
 spAtlasPage* spAtlasPage_create (spAtlas* atlas, const char* name) {
 	spAtlasPage* self = NEW(spAtlasPage);
 	CONST_CAST(spAtlas*, self->atlas) = atlas;
@@ -41,7 +60,8 @@ spAtlasPage* spAtlasPage_create (spAtlas* atlas, const char* name) {
 }
 
 void spAtlasPage_dispose (spAtlasPage* self) {
-	_spAtlasPage_disposeTexture(self);
+	/* Pages of an atlas read without textures may never get one. */
+	if (self->rendererObject) _spAtlasPage_disposeTexture(self);
 	FREE(self->name);
 	FREE(self);
 }
@@ -132,12 +152,8 @@ static int readTuple (const char** begin, const char* end, Str tuple[]) {
 	return i + 1;
 }
 
-static char* mallocString (Str* str) {
-	int length = (int)(str->end - str->begin);
-	char* string = MALLOC(char, length + 1);
-	memcpy(string, str->begin, length);
-	string[length] = '\0';
-	return string;
+static const char* poolString (_spAtlas* self, Str* str) {
+	return _spStringPool_addLength(self->names, str->begin, (int)(str->end - str->begin));
 }
 
 static int indexOf (const char** array, int count, Str* str) {
@@ -161,44 +177,110 @@ static spAtlas* abortAtlas (spAtlas* self) {
 	return 0;
 }
 
+static void updateUVs (spAtlasRegion* region) {
+	spAtlasPage* page = region->page;
+	region->u = region->x / (float)page->width;
+	region->v = region->y / (float)page->height;
+	if (region->rotate) {
+		region->u2 = (region->x + region->height) / (float)page->width;
+		region->v2 = (region->y + region->width) / (float)page->height;
+	} else {
+		region->u2 = (region->x + region->width) / (float)page->width;
+		region->v2 = (region->y + region->height) / (float)page->height;
+	}
+}
+
+static unsigned int hashString (const char* string) {
+	unsigned int hash = 2166136261u; /* FNV-1a */
+	while (*string) {
+		hash ^= (unsigned char)*string++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* Indexes the regions up to lastRegion. The first region with a name is found, as when searching the list. */
+static void indexRegions (_spAtlas* self) {
+	int count = 0;
+	spAtlasRegion* region;
+	if (!self->lastRegion) return;
+	for (region = self->super.regions; region; region = region->next) {
+		count++;
+		if (region == self->lastRegion) break;
+	}
+
+	self->indexCapacity = 8;
+	while (self->indexCapacity < count * 2)
+		self->indexCapacity <<= 1;
+	self->index = CALLOC(spAtlasRegion*, self->indexCapacity);
+	for (region = self->super.regions; region; region = region->next) {
+		int mask = self->indexCapacity - 1;
+		int i = (int)(hashString(region->name) & mask);
+		while (self->index[i] && strcmp(self->index[i]->name, region->name) != 0)
+			i = (i + 1) & mask;
+		if (!self->index[i]) self->index[i] = region;
+		if (region == self->lastRegion) break;
+	}
+}
+
+static void appendRegion (_spAtlas* self, spAtlasRegion* region) {
+	if (self->lastRegion)
+		self->lastRegion->next = region;
+	else
+		self->super.regions = region;
+	self->lastRegion = region;
+}
+
+static void appendPage (spAtlas* self, spAtlasPage* page, spAtlasPage** lastPage) {
+	if (*lastPage)
+		(*lastPage)->next = page;
+	else
+		self->pages = page;
+	*lastPage = page;
+}
+
+static void createTexture (_spAtlas* self, spAtlasPage* page) {
+	char* path;
+	if (!self->createTextures) return;
+	path = _spAtlas_getTexturePath(SUPER(self), page);
+	_spAtlasPage_createTexture(page, path);
+	FREE(path);
+}
+
+static _spAtlas* newAtlas (const char* dir, void* rendererObject, int/*bool*/createTextures) {
+	_spAtlas* self = NEW(_spAtlas);
+	self->super.rendererObject = rendererObject;
+	MALLOC_STR(self->dir, dir);
+	self->createTextures = createTextures;
+	return self;
+}
+
 static const char* formatNames[] = {"Alpha", "Intensity", "LuminanceAlpha", "RGB565", "RGBA4444", "RGB888", "RGBA8888"};
 static const char* textureFilterNames[] = {"Nearest", "Linear", "MipMap", "MipMapNearestNearest", "MipMapLinearNearest",
 		"MipMapNearestLinear", "MipMapLinearLinear"};
 
-spAtlas* spAtlas_create (const char* begin, int length, const char* dir, void* rendererObject) {
+static spAtlas* readText (const char* begin, int length, const char* dir, void* rendererObject, int/*bool*/createTextures) {
 	spAtlas* self;
+	_spAtlas* internal;
 
 	int count;
 	const char* end = begin + length;
-	int dirLength = (int)strlen(dir);
-	int needsSlash = dirLength > 0 && dir[dirLength - 1] != '/' && dir[dirLength - 1] != '\\';
 
 	spAtlasPage *page = 0;
 	spAtlasPage *lastPage = 0;
-	spAtlasRegion *lastRegion = 0;
 	Str str;
 	Str tuple[4];
 
-	self = NEW(spAtlas);
-	self->rendererObject = rendererObject;
+	internal = newAtlas(dir, rendererObject, createTextures);
+	self = SUPER(internal);
+	internal->names = _spStringPool_create();
 
 	while (readLine(&begin, end, &str)) {
 		if (str.end - str.begin == 0) {
 			page = 0;
 		} else if (!page) {
-			char* name = mallocString(&str);
-			char* path = MALLOC(char, dirLength + needsSlash + strlen(name) + 1);
-			memcpy(path, dir, dirLength);
-			if (needsSlash) path[dirLength] = '/';
-			strcpy(path + dirLength + needsSlash, name);
-
-			page = spAtlasPage_create(self, name);
-			FREE(name);
-			if (lastPage)
-				lastPage->next = page;
-			else
-				self->pages = page;
-			lastPage = page;
+			page = spAtlasPage_create(self, poolString(internal, &str));
+			appendPage(self, page, &lastPage);
 
 			switch (readTuple(&begin, end, tuple)) {
 			case 0:
@@ -220,18 +302,12 @@ spAtlas* spAtlas_create (const char* begin, int length, const char* dir, void* r
 				page->vWrap = *str.begin == 'x' ? SP_ATLAS_CLAMPTOEDGE : (*str.begin == 'y' ? SP_ATLAS_REPEAT : SP_ATLAS_REPEAT);
 			}
 
-			_spAtlasPage_createTexture(page, path);
-			FREE(path);
+			createTexture(internal, page);
 		} else {
 			spAtlasRegion *region = spAtlasRegion_create();
-			if (lastRegion)
-				lastRegion->next = region;
-			else
-				self->regions = region;
-			lastRegion = region;
-
 			region->page = page;
-			region->name = mallocString(&str);
+			region->name = poolString(internal, &str);
+			appendRegion(internal, region);
 
 			if (!readValue(&begin, end, &str)) return abortAtlas(self);
 			region->rotate = equals(&str, "true");
@@ -244,15 +320,7 @@ spAtlas* spAtlas_create (const char* begin, int length, const char* dir, void* r
 			region->width = toInt(tuple);
 			region->height = toInt(tuple + 1);
 
-			region->u = region->x / (float)page->width;
-			region->v = region->y / (float)page->height;
-			if (region->rotate) {
-				region->u2 = (region->x + region->height) / (float)page->width;
-				region->v2 = (region->y + region->width) / (float)page->height;
-			} else {
-				region->u2 = (region->x + region->width) / (float)page->width;
-				region->v2 = (region->y + region->height) / (float)page->height;
-			}
+			updateUVs(region);
 
 			if (!(count = readTuple(&begin, end, tuple))) return abortAtlas(self);
 			if (count == 4) { /* split is optional */
@@ -286,10 +354,209 @@ spAtlas* spAtlas_create (const char* begin, int length, const char* dir, void* r
 		}
 	}
 
+	indexRegions(internal);
 	return self;
 }
 
-spAtlas* spAtlas_createFromFile (const char* path, void* rendererObject) {
+spAtlas* spAtlas_create (const char* begin, int length, const char* dir, void* rendererObject) {
+	return readText(begin, length, dir, rendererObject, 1);
+}
+
+/**/
+
+#define BINARY_VERSION 1
+#define BINARY_ROTATE 1
+#define BINARY_SPLITS 2
+#define BINARY_PADS 4
+
+static const unsigned char binaryMagic[4] = {0, 's', 'p', 'a'};
+
+/* Returns the string at the offset in the string block, or 0 if the offset is out of range. */
+static const char* readString (_spBinaryInput* input, const char* strings, int stringsLength) {
+	int offset = _spBinaryInput_readInt(input);
+	if (offset < 0 || offset >= stringsLength) {
+		input->error = 1;
+		return 0;
+	}
+	return strings + offset;
+}
+
+static spAtlas* readBinary (const unsigned char* data, int length, const char* dir, void* rendererObject,
+		int/*bool*/createTextures) {
+	spAtlas* self;
+	_spAtlas* internal;
+	spAtlasPage** pages;
+	spAtlasPage* lastPage = 0;
+	int i, pagesCount, regionsCount;
+	_spBinaryInput input;
+	input.cursor = data;
+	input.end = data + length;
+	input.error = 0;
+
+	if (length < 5 || memcmp(data, binaryMagic, 4) != 0 || data[4] != BINARY_VERSION) return 0;
+	input.cursor += 5;
+
+	internal = newAtlas(dir, rendererObject, createTextures);
+	self = SUPER(internal);
+
+	/* The string block is NUL terminated names, copied to the arena as is. */
+	internal->stringsLength = _spBinaryInput_readInt(&input);
+	if (input.error || internal->stringsLength <= 0 || internal->stringsLength > input.end - input.cursor
+			|| input.cursor[internal->stringsLength - 1] != '\0') return abortAtlas(self);
+	internal->strings = MALLOC(char, internal->stringsLength);
+	memcpy(internal->strings, input.cursor, internal->stringsLength);
+	input.cursor += internal->stringsLength;
+
+	pagesCount = _spBinaryInput_readInt(&input);
+	if (input.error || pagesCount < 0 || pagesCount > (input.end - input.cursor) / 32) return abortAtlas(self);
+	pages = MALLOC(spAtlasPage*, pagesCount + 1); /* + 1 so the allocation is never empty. */
+	for (i = 0; i < pagesCount; ++i) {
+		const char* name = readString(&input, internal->strings, internal->stringsLength);
+		spAtlasPage* page;
+		if (input.error) break;
+		page = spAtlasPage_create(self, name);
+		appendPage(self, page, &lastPage);
+		pages[i] = page;
+		page->width = _spBinaryInput_readInt(&input);
+		page->height = _spBinaryInput_readInt(&input);
+		page->format = (spAtlasFormat)_spBinaryInput_readInt(&input);
+		page->minFilter = (spAtlasFilter)_spBinaryInput_readInt(&input);
+		page->magFilter = (spAtlasFilter)_spBinaryInput_readInt(&input);
+		page->uWrap = (spAtlasWrap)_spBinaryInput_readInt(&input);
+		page->vWrap = (spAtlasWrap)_spBinaryInput_readInt(&input);
+		if (input.error) break;
+		createTexture(internal, page);
+	}
+
+	regionsCount = input.error ? 0 : _spBinaryInput_readInt(&input);
+	for (i = 0; i < regionsCount && !input.error; ++i) {
+		int pageIndex, flags;
+		spAtlasRegion* region = spAtlasRegion_create();
+		region->name = readString(&input, internal->strings, internal->stringsLength);
+		appendRegion(internal, region);
+		pageIndex = _spBinaryInput_readInt(&input);
+		if (input.error || pageIndex < 0 || pageIndex >= pagesCount) {
+			input.error = 1;
+			break;
+		}
+		region->page = pages[pageIndex];
+		region->x = _spBinaryInput_readInt(&input);
+		region->y = _spBinaryInput_readInt(&input);
+		region->width = _spBinaryInput_readInt(&input);
+		region->height = _spBinaryInput_readInt(&input);
+		region->offsetX = _spBinaryInput_readInt(&input);
+		region->offsetY = _spBinaryInput_readInt(&input);
+		region->originalWidth = _spBinaryInput_readInt(&input);
+		region->originalHeight = _spBinaryInput_readInt(&input);
+		region->index = _spBinaryInput_readInt(&input);
+		flags = _spBinaryInput_readInt(&input);
+		region->rotate = (flags & BINARY_ROTATE) != 0;
+		if (flags & BINARY_SPLITS) {
+			int ii;
+			region->splits = MALLOC(int, 4);
+			for (ii = 0; ii < 4; ++ii)
+				region->splits[ii] = _spBinaryInput_readInt(&input);
+		}
+		if (flags & BINARY_PADS) {
+			int ii;
+			region->pads = MALLOC(int, 4);
+			for (ii = 0; ii < 4; ++ii)
+				region->pads[ii] = _spBinaryInput_readInt(&input);
+		}
+		updateUVs(region);
+	}
+
+	FREE(pages);
+	if (input.error || regionsCount < 0) return abortAtlas(self);
+	indexRegions(internal);
+	return self;
+}
+
+spAtlas* spAtlas_createFromBinary (const unsigned char* data, int length, const char* dir, void* rendererObject) {
+	return readBinary(data, length, dir, rendererObject, 1);
+}
+
+unsigned char* spAtlas_writeBinary (const spAtlas* self, int* length) {
+	int pagesCount = 0, regionsCount = 0, stringsLength = 0, size;
+	unsigned char* data;
+	unsigned char* output;
+	char* strings;
+	spAtlasPage* page;
+	spAtlasRegion* region, *previous;
+	int nameOffset = 0;
+
+	for (page = self->pages; page; page = page->next) {
+		pagesCount++;
+		stringsLength += (int)strlen(page->name) + 1;
+	}
+	size = 5 + 4 + 4 + pagesCount * 32 + 4;
+	for (region = self->regions, previous = 0; region; previous = region, region = region->next) {
+		regionsCount++;
+		/* Regions of a sequence usually follow each other, their name is written once. */
+		if (!previous || strcmp(previous->name, region->name) != 0) stringsLength += (int)strlen(region->name) + 1;
+		size += 12 * 4 + (region->splits ? 16 : 0) + (region->pads ? 16 : 0);
+	}
+	size += stringsLength;
+
+	data = MALLOC(unsigned char, size);
+	memcpy(data, binaryMagic, 4);
+	data[4] = BINARY_VERSION;
+	output = data + 5;
+	_spBinary_writeInt(&output, stringsLength);
+	strings = (char*)output;
+	output += stringsLength;
+
+	stringsLength = 0;
+	_spBinary_writeInt(&output, pagesCount);
+	for (page = self->pages; page; page = page->next) {
+		strcpy(strings + stringsLength, page->name);
+		_spBinary_writeInt(&output, stringsLength);
+		stringsLength += (int)strlen(page->name) + 1;
+		_spBinary_writeInt(&output, page->width);
+		_spBinary_writeInt(&output, page->height);
+		_spBinary_writeInt(&output, page->format);
+		_spBinary_writeInt(&output, page->minFilter);
+		_spBinary_writeInt(&output, page->magFilter);
+		_spBinary_writeInt(&output, page->uWrap);
+		_spBinary_writeInt(&output, page->vWrap);
+	}
+
+	_spBinary_writeInt(&output, regionsCount);
+	for (region = self->regions, previous = 0; region; previous = region, region = region->next) {
+		int pageIndex = 0, i;
+		for (page = self->pages; page != region->page; page = page->next)
+			pageIndex++;
+		if (!previous || strcmp(previous->name, region->name) != 0) {
+			nameOffset = stringsLength;
+			strcpy(strings + stringsLength, region->name);
+			stringsLength += (int)strlen(region->name) + 1;
+		}
+		_spBinary_writeInt(&output, nameOffset);
+		_spBinary_writeInt(&output, pageIndex);
+		_spBinary_writeInt(&output, region->x);
+		_spBinary_writeInt(&output, region->y);
+		_spBinary_writeInt(&output, region->width);
+		_spBinary_writeInt(&output, region->height);
+		_spBinary_writeInt(&output, region->offsetX);
+		_spBinary_writeInt(&output, region->offsetY);
+		_spBinary_writeInt(&output, region->originalWidth);
+		_spBinary_writeInt(&output, region->originalHeight);
+		_spBinary_writeInt(&output, region->index);
+		_spBinary_writeInt(&output, (region->rotate ? BINARY_ROTATE : 0) | (region->splits ? BINARY_SPLITS : 0)
+				| (region->pads ? BINARY_PADS : 0));
+		if (region->splits) for (i = 0; i < 4; ++i)
+			_spBinary_writeInt(&output, region->splits[i]);
+		if (region->pads) for (i = 0; i < 4; ++i)
+			_spBinary_writeInt(&output, region->pads[i]);
+	}
+
+	*length = size;
+	return data;
+}
+
+/**/
+
+static spAtlas* readFile (const char* path, void* rendererObject, int/*bool*/createTextures) {
 	int dirLength;
 	char *dir;
 	int length;
@@ -308,14 +575,45 @@ spAtlas* spAtlas_createFromFile (const char* path, void* rendererObject) {
 	dir[dirLength] = '\0';
 
 	data = _spUtil_readFile(path, &length);
-	if (data) atlas = spAtlas_create(data, length, dir, rendererObject);
+	if (data) {
+		if (length >= 4 && memcmp(data, binaryMagic, 4) == 0)
+			atlas = readBinary((const unsigned char*)data, length, dir, rendererObject, createTextures);
+		else
+			atlas = readText(data, length, dir, rendererObject, createTextures);
+	}
 
 	FREE(data);
 	FREE(dir);
 	return atlas;
 }
 
+spAtlas* spAtlas_createFromFile (const char* path, void* rendererObject) {
+	return readFile(path, rendererObject, 1);
+}
+
+spAtlas* _spAtlas_createFromFileWithoutTextures (const char* path, void* rendererObject) {
+	return readFile(path, rendererObject, 0);
+}
+
+char* _spAtlas_getTexturePath (const spAtlas* self, const spAtlasPage* page) {
+	const char* dir = SUB_CAST(_spAtlas, self)->dir;
+	int dirLength = (int)strlen(dir);
+	int needsSlash = dirLength > 0 && dir[dirLength - 1] != '/' && dir[dirLength - 1] != '\\';
+	char* path = MALLOC(char, dirLength + needsSlash + strlen(page->name) + 1);
+	memcpy(path, dir, dirLength);
+	if (needsSlash) path[dirLength] = '/';
+	strcpy(path + dirLength + needsSlash, page->name);
+	return path;
+}
+
+void _spAtlas_updateUVs (spAtlas* self) {
+	spAtlasRegion* region;
+	for (region = self->regions; region; region = region->next)
+		updateUVs(region);
+}
+
 void spAtlas_dispose (spAtlas* self) {
+	_spAtlas* internal = SUB_CAST(_spAtlas, self);
 	spAtlasRegion* region, *nextRegion;
 	spAtlasPage* page = self->pages;
 	while (page) {
@@ -324,6 +622,15 @@ void spAtlas_dispose (spAtlas* self) {
 		page = nextPage;
 	}
 
+	/* Names of the parsed regions are in strings or names. */
+	region = internal->lastRegion ? self->regions : 0;
+	while (region) {
+		int/*bool*/last = region == internal->lastRegion;
+		region->name = 0;
+		if (last) break;
+		region = region->next;
+	}
+
 	region = self->regions;
 	while (region) {
 		nextRegion = region->next;
@@ -331,11 +638,27 @@ void spAtlas_dispose (spAtlas* self) {
 		region = nextRegion;
 	}
 
+	FREE(internal->dir);
+	FREE(internal->strings);
+	if (internal->names) _spStringPool_dispose(internal->names);
+	FREE(internal->index);
 	FREE(self);
 }
 
 spAtlasRegion* spAtlas_findRegion (const spAtlas* self, const char* name) {
-	spAtlasRegion* region = self->regions;
+	const _spAtlas* internal = SUB_CAST(_spAtlas, self);
+	spAtlasRegion* region;
+	if (internal->index) {
+		int mask = internal->indexCapacity - 1;
+		int i = (int)(hashString(name) & mask);
+		while ((region = internal->index[i]) != 0) {
+			if (strcmp(region->name, name) == 0) return region;
+			i = (i + 1) & mask;
+		}
+		/* Only regions added to the list after the atlas was created remain. */
+		region = internal->lastRegion->next;
+	} else
+		region = self->regions;
 	while (region) {
 		if (strcmp(region->name, name) == 0) return region;
 		region = region->next;
@@ -32,14 +32,14 @@
 #include <spine/Bone.h>
 #include <spine/extension.h>
 
-static int yDown;
+static int yDownDefault;
 
 void spBone_setYDown (int value) {
-	yDown = value;
+	yDownDefault = value;
 }
 
 int spBone_isYDown () {
-	return yDown;
+	return yDownDefault;
 }
 
 spBone* spBone_create (spBoneData* data, spSkeleton* skeleton, spBone* parent) {
@@ -74,7 +74,7 @@ void spBone_updateWorldTransform (spBone* self) {
 	} else {
 		int skeletonFlipX = self->skeleton->flipX, skeletonFlipY = self->skeleton->flipY;
 		CONST_CAST(float, self->worldX) = self->skeleton->flipX ? -self->x : self->x;
-		CONST_CAST(float, self->worldY) = self->skeleton->flipY != yDown ? -self->y : self->y;
+		CONST_CAST(float, self->worldY) = self->skeleton->flipY != self->skeleton->yDown ? -self->y : self->y;
 		CONST_CAST(float, self->worldScaleX) = self->scaleX;
 		CONST_CAST(float, self->worldScaleY) = self->scaleY;
 		CONST_CAST(float, self->worldRotation) = self->rotationIK;
@@ -91,7 +91,7 @@ void spBone_updateWorldTransform (spBone* self) {
 		CONST_CAST(float, self->m00) = cosine * self->worldScaleX;
 		CONST_CAST(float, self->m01) = -sine * self->worldScaleY;
 	}
-	if (self->worldFlipY != yDown) {
+	if (self->worldFlipY != self->skeleton->yDown) {
 		CONST_CAST(float, self->m10) = -sine * self->worldScaleX;
 		CONST_CAST(float, self->m11) = -cosine * self->worldScaleY;
 	} else {
@@ -115,7 +115,7 @@ void spBone_worldToLocal (spBone* self, float worldX, float worldY, float* local
 	float invDet;
 	float dx = worldX - self->worldX, dy = worldY - self->worldY;
 	float m00 = self->m00, m11 = self->m11;
-	if (self->worldFlipX != (self->worldFlipY != yDown)) {
+	if (self->worldFlipX != (self->worldFlipY != self->skeleton->yDown)) {
 		m00 *= -1;
 		m11 *= -1;
 	}
@@ -0,0 +1,477 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/Imposter.h>
+#include <spine/RenderList.h>
+#include <spine/extension.h>
+#include <stddef.h>
+
+typedef struct {
+	spImposter super;
+
+	int animationsCapacity;
+	int pagesCapacity;
+
+	/* Frames are packed into rows, left to right, on the last page. */
+	int rowX, rowY, rowHeight;
+} _spImposter;
+
+typedef struct {
+	float x, y;
+	float u, v;
+	float r, g, b, a;
+} _spImposterVertex;
+
+spImposter* spImposter_create (float framesPerSecond, float scale) {
+	spImposter* self = SUPER(NEW(_spImposter));
+	CONST_CAST(float, self->framesPerSecond) = framesPerSecond;
+	CONST_CAST(float, self->scale) = scale;
+	self->pageSize = 1024;
+	self->padding = 1;
+	return self;
+}
+
+void spImposter_dispose (spImposter* self) {
+	int i;
+	for (i = 0; i < self->animationsCount; ++i)
+		FREE(self->animations[i].frames);
+	FREE(self->animations);
+	for (i = 0; i < self->pagesCount; ++i)
+		FREE(self->pages[i].pixels);
+	FREE(self->pages);
+	FREE(self);
+}
+
+/* Sets the frame's page, x and y to a free area the size of the frame, adding a page if the last page has no room. */
+static void _spImposter_packFrame (_spImposter* internal, spImposterFrame* frame) {
+	spImposter* self = SUPER(internal);
+	spImposterPage* page = self->pagesCount ? self->pages + self->pagesCount - 1 : 0;
+	if (page && internal->rowX + frame->width > page->width) {
+		internal->rowX = 0;
+		internal->rowY += internal->rowHeight;
+		internal->rowHeight = 0;
+	}
+	if (!page || internal->rowX + frame->width > page->width || internal->rowY + frame->height > page->height) {
+		if (self->pagesCount == internal->pagesCapacity) {
+			int capacity = internal->pagesCapacity ? internal->pagesCapacity << 1 : 4;
+			spImposterPage* pages = CALLOC(spImposterPage, capacity);
+			if (self->pagesCount) memcpy(pages, self->pages, sizeof(spImposterPage) * self->pagesCount);
+			FREE(self->pages);
+			CONST_CAST(spImposterPage*, self->pages) = pages;
+			internal->pagesCapacity = capacity;
+		}
+		page = self->pages + CONST_CAST(int, self->pagesCount)++;
+		page->width = frame->width > self->pageSize ? frame->width : self->pageSize;
+		page->height = frame->height > self->pageSize ? frame->height : self->pageSize;
+		page->pixels = CALLOC(unsigned char, page->width * page->height * 4);
+		internal->rowX = 0;
+		internal->rowY = 0;
+		internal->rowHeight = 0;
+	}
+	frame->page = self->pagesCount - 1;
+	frame->x = internal->rowX;
+	frame->y = internal->rowY;
+	internal->rowX += frame->width;
+	if (frame->height > internal->rowHeight) internal->rowHeight = frame->height;
+}
+
+static float _spImposter_clamp (float value) {
+	return value < 0 ? 0 : (value > 1 ? 1 : value);
+}
+
+/* Draws the batch's triangles into the frame. The destination pixels have premultiplied alpha. */
+static void _spImposter_drawBatch (const spImposter* self, const spImposterFrame* frame, const spRenderList* list,
+		const spRenderBatch* batch, const unsigned char* texels) {
+	spImposterPage* page = self->pages + frame->page;
+	const _spImposterVertex* vertices = (const _spImposterVertex*)list->vertices + batch->firstVertex;
+	int textureWidth = batch->page->width, textureHeight = batch->page->height;
+	int i, x, y;
+	for (i = 0; i < batch->verticesCount; i += 3) {
+		const _spImposterVertex* v0 = vertices + i;
+		const _spImposterVertex* v1 = v0 + 1;
+		const _spImposterVertex* v2 = v0 + 2;
+		/* Pixel positions in the page. */
+		float x0 = frame->x + (v0->x - frame->offsetX) * self->scale, y0 = frame->y + (v0->y - frame->offsetY) * self->scale;
+		float x1 = frame->x + (v1->x - frame->offsetX) * self->scale, y1 = frame->y + (v1->y - frame->offsetY) * self->scale;
+		float x2 = frame->x + (v2->x - frame->offsetX) * self->scale, y2 = frame->y + (v2->y - frame->offsetY) * self->scale;
+		float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+		int minX, minY, maxX, maxY;
+		if (area == 0) continue;
+		minX = (int)(x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2));
+		minY = (int)(y0 < y1 ? (y0 < y2 ? y0 : y2) : (y1 < y2 ? y1 : y2));
+		maxX = (int)(x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2));
+		maxY = (int)(y0 > y1 ? (y0 > y2 ? y0 : y2) : (y1 > y2 ? y1 : y2));
+		if (minX < frame->x) minX = frame->x;
+		if (minY < frame->y) minY = frame->y;
+		if (maxX >= frame->x + frame->width) maxX = frame->x + frame->width - 1;
+		if (maxY >= frame->y + frame->height) maxY = frame->y + frame->height - 1;
+		for (y = minY; y <= maxY; ++y) {
+			float cy = y + 0.5f;
+			for (x = minX; x <= maxX; ++x) {
+				float cx = x + 0.5f;
+				/* Barycentric weights of the pixel center, all positive inside the triangle for either winding. */
+				float w0 = ((x2 - x1) * (cy - y1) - (y2 - y1) * (cx - x1)) / area;
+				float w1 = ((x0 - x2) * (cy - y2) - (y0 - y2) * (cx - x2)) / area;
+				float w2 = 1 - w0 - w1;
+				float u, v, r, g, b, a;
+				int tx, ty;
+				const unsigned char* texel;
+				unsigned char* pixel;
+				if (w0 < 0 || w1 < 0 || w2 < 0) continue;
+
+				u = w0 * v0->u + w1 * v1->u + w2 * v2->u;
+				v = w0 * v0->v + w1 * v1->v + w2 * v2->v;
+				tx = (int)(u * textureWidth);
+				ty = (int)(v * textureHeight);
+				if (tx < 0) tx = 0; else if (tx >= textureWidth) tx = textureWidth - 1;
+				if (ty < 0) ty = 0; else if (ty >= textureHeight) ty = textureHeight - 1;
+				texel = texels + (ty * textureWidth + tx) * 4;
+
+				/* An attachment's vertices share one color, premultiplied by the render list. */
+				a = texel[3] / 255.0f;
+				r = texel[0] / 255.0f;
+				g = texel[1] / 255.0f;
+				b = texel[2] / 255.0f;
+				if (!self->premultipliedAlpha) {
+					r *= a;
+					g *= a;
+					b *= a;
+				}
+				r *= v0->r;
+				g *= v0->g;
+				b *= v0->b;
+				a *= v0->a;
+
+				pixel = page->pixels + (y * page->width + x) * 4;
+				{
+					float dr = pixel[0] / 255.0f, dg = pixel[1] / 255.0f, db = pixel[2] / 255.0f, da = pixel[3] / 255.0f;
+					switch (batch->blendMode) {
+					case SP_BLEND_MODE_ADDITIVE:
+						dr += r;
+						dg += g;
+						db += b;
+						da += a;
+						break;
+					case SP_BLEND_MODE_MULTIPLY:
+						dr = r * dr + dr * (1 - a);
+						dg = g * dg + dg * (1 - a);
+						db = b * db + db * (1 - a);
+						da = a * da + da * (1 - a);
+						break;
+					case SP_BLEND_MODE_SCREEN:
+						dr = r + dr * (1 - r);
+						dg = g + dg * (1 - g);
+						db = b + db * (1 - b);
+						da = a + da * (1 - a);
+						break;
+					default:
+						dr = r + dr * (1 - a);
+						dg = g + dg * (1 - a);
+						db = b + db * (1 - a);
+						da = a + da * (1 - a);
+					}
+					pixel[0] = (unsigned char)(_spImposter_clamp(dr) * 255 + 0.5f);
+					pixel[1] = (unsigned char)(_spImposter_clamp(dg) * 255 + 0.5f);
+					pixel[2] = (unsigned char)(_spImposter_clamp(db) * 255 + 0.5f);
+					pixel[3] = (unsigned char)(_spImposter_clamp(da) * 255 + 0.5f);
+				}
+			}
+		}
+	}
+}
+
+spImposterAnimation* spImposter_addAnimation (spImposter* self, spSkeleton* skeleton, const spAnimation* animation,
+		spImposterPixelsProvider getPixels, void* context) {
+	_spImposter* internal = SUB_CAST(_spImposter, self);
+	spImposterAnimation* entry;
+	spVertexFormat format;
+	spRenderList* list;
+	int i, ii, x, y;
+
+	if (self->animationsCount == internal->animationsCapacity) {
+		int capacity = internal->animationsCapacity ? internal->animationsCapacity << 1 : 4;
+		spImposterAnimation* animations = CALLOC(spImposterAnimation, capacity);
+		if (self->animationsCount) memcpy(animations, self->animations, sizeof(spImposterAnimation) * self->animationsCount);
+		FREE(self->animations);
+		CONST_CAST(spImposterAnimation*, self->animations) = animations;
+		internal->animationsCapacity = capacity;
+	}
+	entry = self->animations + CONST_CAST(int, self->animationsCount)++;
+	entry->animation = animation;
+	entry->framesCount = (int)ceil(animation->duration * self->framesPerSecond);
+	if (entry->framesCount < 1) entry->framesCount = 1;
+	entry->frames = CALLOC(spImposterFrame, entry->framesCount);
+
+	memset((void*)&format, 0, sizeof(format));
+	format.stride = sizeof(_spImposterVertex);
+	format.positionOffset = offsetof(_spImposterVertex, x);
+	format.uvOffset = offsetof(_spImposterVertex, u);
+	format.colorOffset = offsetof(_spImposterVertex, r);
+	format.color = SP_VERTEX_COLOR_FLOATS;
+	format.premultipliedAlpha = 1;
+	format.triangleList = 1;
+	list = spRenderList_create(&format);
+
+	spAnimation_acquire(animation);
+	skeleton->x = 0;
+	skeleton->y = 0;
+	for (i = 0; i < entry->framesCount; ++i) {
+		spImposterFrame* frame = entry->frames + i;
+		float time = i / self->framesPerSecond;
+		float minX = 0, minY = 0, maxX = 0, maxY = 0;
+
+		spSkeleton_setToSetupPose(skeleton);
+		spAnimation_apply(animation, skeleton, time, time, 0, 0, 0);
+		spSkeleton_updateWorldTransform(skeleton);
+		spRenderList_clear(list);
+		spRenderList_addSkeleton(list, skeleton);
+		if (list->verticesCount) {
+			minX = list->minX;
+			minY = list->minY;
+			maxX = list->maxX;
+			maxY = list->maxY;
+		}
+
+		frame->width = (int)ceil((maxX - minX) * self->scale) + self->padding * 2;
+		frame->height = (int)ceil((maxY - minY) * self->scale) + self->padding * 2;
+		if (frame->width < 1) frame->width = 1;
+		if (frame->height < 1) frame->height = 1;
+		frame->offsetX = minX - self->padding / self->scale;
+		frame->offsetY = minY - self->padding / self->scale;
+		_spImposter_packFrame(internal, frame);
+
+		for (ii = 0; ii < list->batchesCount; ++ii) {
+			const spRenderBatch* batch = list->batches + ii;
+			const unsigned char* texels = getPixels(context, batch->page);
+			if (texels) _spImposter_drawBatch(self, frame, list, batch, texels);
+		}
+
+		if (!self->premultipliedAlpha) {
+			spImposterPage* page = self->pages + frame->page;
+			for (y = frame->y; y < frame->y + frame->height; ++y) {
+				unsigned char* pixel = page->pixels + (y * page->width + frame->x) * 4;
+				for (x = 0; x < frame->width; ++x, pixel += 4) {
+					int c;
+					if (!pixel[3]) continue;
+					for (c = 0; c < 3; ++c) {
+						int value = pixel[c] * 255 / pixel[3];
+						pixel[c] = (unsigned char)(value > 255 ? 255 : value);
+					}
+				}
+			}
+		}
+	}
+	spAnimation_release(animation);
+
+	spRenderList_dispose(list);
+	return entry;
+}
+
+/**/
+
+#define BINARY_VERSION 1
+
+static const unsigned char binaryMagic[4] = {0, 's', 'p', 'i'};
+
+static spImposter* _spImposter_abort (spImposter* self) {
+	spImposter_dispose(self);
+	return 0;
+}
+
+spImposter* spImposter_createFromBinary (const unsigned char* data, int length, const spSkeletonData* skeletonData) {
+	spImposter* self;
+	_spImposter* internal;
+	_spBinaryInput input;
+	float framesPerSecond, scale;
+	int i, ii, count;
+	input.cursor = data;
+	input.end = data + length;
+	input.error = 0;
+
+	if (length < 5 || memcmp(data, binaryMagic, 4) != 0 || data[4] != BINARY_VERSION) return 0;
+	input.cursor += 5;
+
+	framesPerSecond = _spBinaryInput_readFloat(&input);
+	scale = _spBinaryInput_readFloat(&input);
+	if (input.error || !(framesPerSecond > 0) || !(scale > 0)) return 0;
+	self = spImposter_create(framesPerSecond, scale);
+	internal = SUB_CAST(_spImposter, self);
+	self->pageSize = _spBinaryInput_readInt(&input);
+	self->padding = _spBinaryInput_readInt(&input);
+	self->premultipliedAlpha = _spBinaryInput_readInt(&input);
+
+	/* An animation is at least its name length, name and frames count. */
+	count = _spBinaryInput_readInt(&input);
+	if (input.error || count < 0 || count > (input.end - input.cursor) / 9) return _spImposter_abort(self);
+	CONST_CAST(spImposterAnimation*, self->animations) = CALLOC(spImposterAnimation, count + 1);
+	internal->animationsCapacity = count + 1;
+	for (i = 0; i < count; ++i) {
+		spImposterAnimation* entry = self->animations + i;
+		char* name;
+		int nameLength = _spBinaryInput_readInt(&input);
+		if (input.error || nameLength < 1 || nameLength > input.end - input.cursor) return _spImposter_abort(self);
+		name = MALLOC(char, nameLength + 1);
+		memcpy(name, input.cursor, nameLength);
+		name[nameLength] = '\0';
+		input.cursor += nameLength;
+		entry->animation = spSkeletonData_findAnimation(skeletonData, name);
+		FREE(name);
+		entry->framesCount = _spBinaryInput_readInt(&input);
+		if (input.error || !entry->animation || entry->framesCount < 1
+				|| entry->framesCount > (input.end - input.cursor) / 28) return _spImposter_abort(self);
+		entry->frames = CALLOC(spImposterFrame, entry->framesCount);
+		CONST_CAST(int, self->animationsCount)++;
+		for (ii = 0; ii < entry->framesCount; ++ii) {
+			spImposterFrame* frame = entry->frames + ii;
+			frame->page = _spBinaryInput_readInt(&input);
+			frame->x = _spBinaryInput_readInt(&input);
+			frame->y = _spBinaryInput_readInt(&input);
+			frame->width = _spBinaryInput_readInt(&input);
+			frame->height = _spBinaryInput_readInt(&input);
+			frame->offsetX = _spBinaryInput_readFloat(&input);
+			frame->offsetY = _spBinaryInput_readFloat(&input);
+		}
+	}
+
+	count = _spBinaryInput_readInt(&input);
+	if (input.error || count < 0 || count > (input.end - input.cursor) / 8) return _spImposter_abort(self);
+	CONST_CAST(spImposterPage*, self->pages) = CALLOC(spImposterPage, count + 1);
+	internal->pagesCapacity = count + 1;
+	for (i = 0; i < count; ++i) {
+		spImposterPage* page = self->pages + i;
+		page->width = _spBinaryInput_readInt(&input);
+		page->height = _spBinaryInput_readInt(&input);
+		if (input.error || page->width < 1 || page->height < 1 || page->width > (input.end - input.cursor) / 4 / page->height)
+			return _spImposter_abort(self);
+		page->pixels = MALLOC(unsigned char, page->width * page->height * 4);
+		memcpy(page->pixels, input.cursor, page->width * page->height * 4);
+		input.cursor += page->width * page->height * 4;
+		CONST_CAST(int, self->pagesCount)++;
+	}
+
+	for (i = 0; i < self->animationsCount; ++i) {
+		for (ii = 0; ii < self->animations[i].framesCount; ++ii) {
+			const spImposterFrame* frame = self->animations[i].frames + ii;
+			const spImposterPage* page;
+			if (frame->page < 0 || frame->page >= self->pagesCount) return _spImposter_abort(self);
+			page = self->pages + frame->page;
+			if (frame->x < 0 || frame->y < 0 || frame->width < 1 || frame->height < 1 || frame->x > page->width - frame->width
+					|| frame->y > page->height - frame->height) return _spImposter_abort(self);
+		}
+	}
+
+	/* Animations added later start a new page. */
+	if (self->pagesCount) internal->rowY = self->pages[self->pagesCount - 1].height;
+	return self;
+}
+
+spImposter* spImposter_createFromFile (const char* path, const spSkeletonData* skeletonData) {
+	int length;
+	spImposter* self;
+	const char* data = _spUtil_readFile(path, &length);
+	if (!data) return 0;
+	self = spImposter_createFromBinary((const unsigned char*)data, length, skeletonData);
+	FREE(data);
+	return self;
+}
+
+unsigned char* spImposter_writeBinary (const spImposter* self, int* length) {
+	int i, ii, size = 5 + 4 * 6 + 4;
+	unsigned char* data;
+	unsigned char* output;
+
+	for (i = 0; i < self->animationsCount; ++i)
+		size += 4 + (int)strlen(self->animations[i].animation->name) + 4 + self->animations[i].framesCount * 28;
+	for (i = 0; i < self->pagesCount; ++i)
+		size += 8 + self->pages[i].width * self->pages[i].height * 4;
+
+	data = MALLOC(unsigned char, size);
+	memcpy(data, binaryMagic, 4);
+	data[4] = BINARY_VERSION;
+	output = data + 5;
+	_spBinary_writeFloat(&output, self->framesPerSecond);
+	_spBinary_writeFloat(&output, self->scale);
+	_spBinary_writeInt(&output, self->pageSize);
+	_spBinary_writeInt(&output, self->padding);
+	_spBinary_writeInt(&output, self->premultipliedAlpha);
+
+	_spBinary_writeInt(&output, self->animationsCount);
+	for (i = 0; i < self->animationsCount; ++i) {
+		const spImposterAnimation* entry = self->animations + i;
+		int nameLength = (int)strlen(entry->animation->name);
+		_spBinary_writeInt(&output, nameLength);
+		memcpy(output, entry->animation->name, nameLength);
+		output += nameLength;
+		_spBinary_writeInt(&output, entry->framesCount);
+		for (ii = 0; ii < entry->framesCount; ++ii) {
+			const spImposterFrame* frame = entry->frames + ii;
+			_spBinary_writeInt(&output, frame->page);
+			_spBinary_writeInt(&output, frame->x);
+			_spBinary_writeInt(&output, frame->y);
+			_spBinary_writeInt(&output, frame->width);
+			_spBinary_writeInt(&output, frame->height);
+			_spBinary_writeFloat(&output, frame->offsetX);
+			_spBinary_writeFloat(&output, frame->offsetY);
+		}
+	}
+
+	_spBinary_writeInt(&output, self->pagesCount);
+	for (i = 0; i < self->pagesCount; ++i) {
+		const spImposterPage* page = self->pages + i;
+		_spBinary_writeInt(&output, page->width);
+		_spBinary_writeInt(&output, page->height);
+		memcpy(output, page->pixels, page->width * page->height * 4);
+		output += page->width * page->height * 4;
+	}
+
+	*length = size;
+	return data;
+}
+
+/**/
+
+spImposterAnimation* spImposter_findAnimation (const spImposter* self, const spAnimation* animation) {
+	int i;
+	for (i = 0; i < self->animationsCount; ++i)
+		if (self->animations[i].animation == animation) return self->animations + i;
+	return 0;
+}
+
+const spImposterFrame* spImposter_getFrame (const spImposter* self, const spAnimation* animation, float time, int/*bool*/loop) {
+	const spImposterAnimation* entry = spImposter_findAnimation(self, animation);
+	int index;
+	if (!entry) return 0;
+	if (loop && animation->duration > 0) time = FMOD(time, animation->duration);
+	index = (int)(time * self->framesPerSecond);
+	if (index >= entry->framesCount) index = entry->framesCount - 1;
+	if (index < 0) index = 0;
+	return entry->frames + index;
+}
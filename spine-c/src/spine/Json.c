@@ -37,7 +37,7 @@
 #include "Json.h"
 #include <stdio.h>
 #include <ctype.h>
-#include <stdlib.h> /* strtod (C89), strtof (C99) */
+#include <stdlib.h>
 #include <string.h> /* strcasecmp (4.4BSD - compatibility), _stricmp (_WIN32) */
 #include <spine/extension.h>
 
@@ -46,12 +46,6 @@
 #define SPINE_JSON_DEBUG 0
 #endif
 
-static const char* ep;
-
-const char* Json_getError (void) {
-	return ep;
-}
-
 static int Json_strcasecmp (const char* s1, const char* s2) {
 	/* TODO we may be able to elide these NULL checks if we can prove
 	 * the graph and input (only callsite is Json_getItem) should not have NULLs
@@ -83,55 +77,65 @@ void Json_dispose (Json *c) {
 	while (c) {
 		next = c->next;
 		if (c->child) Json_dispose(c->child);
-		if (c->valueString) FREE(c->valueString);
+		if (c->valueString && c->type != Json_Raw) FREE(c->valueString);
 		if (c->name) FREE(c->name);
 		FREE(c);
 		c = next;
 	}
 }
 
-/* Parse the input text to generate a number, and populate the result into item. */
-static const char* parse_number (Json *item, const char* num) {
-	char * endptr;
+/* Parse the input text to generate a number, and populate the result into item. Locale independent, unlike strtod, so parsing
+ * doesn't need setlocale, which is process wide. */
+static const char* parse_number (Json *item, const char* num, const char** ep) {
+	const char* ptr = num;
+	double mantissa = 0, power = 1;
+	int digits = 0, exponent = 0;
 	float n;
 
-	/* Using strtod and strtof is slightly more permissive than RFC4627,
-	 * accepting for example hex-encoded floating point, but either
-	 * is often leagues faster than any manual implementation.
-	 *
-	 * We also already know that this starts with [-0-9] from parse_value.
-	 */
-#if __STDC_VERSION__ >= 199901L
-	n = strtof(num, &endptr);
-#else
-	n = (float)strtod( num, &endptr );
-#endif
-	/* ignore errno's ERANGE, which returns +/-HUGE_VAL */
-	/* n is 0 on any other error */
-
-	if (endptr != num) {
-		/* Parse success, number found. */
-		item->valueFloat = n;
-		item->valueInt = (int)n;
-		item->type = Json_Number;
-		return endptr;
-	} else {
+	/* We already know that this starts with [-0-9] from parse_value. */
+	if (*ptr == '-') ptr++;
+	for (; *ptr >= '0' && *ptr <= '9'; ptr++, digits++)
+		mantissa = mantissa * 10 + (*ptr - '0');
+	if (*ptr == '.') {
+		for (ptr++; *ptr >= '0' && *ptr <= '9'; ptr++, digits++, exponent--)
+			mantissa = mantissa * 10 + (*ptr - '0');
+	}
+	if (!digits) {
 		/* Parse failure, ep is set. */
-		ep = num;
+		*ep = num;
 		return 0;
 	}
+	if ((*ptr == 'e' || *ptr == 'E')
+			&& ((ptr[1] >= '0' && ptr[1] <= '9') || ((ptr[1] == '-' || ptr[1] == '+') && ptr[2] >= '0' && ptr[2] <= '9'))) {
+		int negativeExponent = *++ptr == '-', value = 0;
+		if (*ptr == '-' || *ptr == '+') ptr++;
+		for (; *ptr >= '0' && *ptr <= '9'; ptr++)
+			if (value < 10000) value = value * 10 + (*ptr - '0');
+		exponent += negativeExponent ? -value : value;
+	}
+
+	/* Powers of ten up to 1e22 are exact, so dividing for negative exponents keeps typical values correctly rounded. */
+	for (digits = exponent < 0 ? -exponent : exponent; digits > 0 && power < 1e300; digits--)
+		power *= 10;
+	n = (float)(exponent < 0 ? mantissa / power : mantissa * power);
+	if (*num == '-') n = -n;
+
+	item->valueFloat = n;
+	item->valueInt = (int)n;
+	item->type = Json_Number;
+	return ptr;
 }
 
 /* Parse the input text into an unescaped cstring, and populate item. */
 static const unsigned char firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
-static const char* parse_string (Json *item, const char* str) {
+static const char* parse_string (Json *item, const char* str, const char** ep) {
 	const char* ptr = str + 1;
 	char* ptr2;
 	char* out;
 	int len = 0;
 	unsigned uc, uc2;
 	if (*str != '\"') { /* TODO: don't need this check when called from parse_value, but do need from parse_object */
-		ep = str;
+		*ep = str;
 		return 0;
 	} /* not a string! */
 
@@ -221,9 +225,16 @@ static const char* parse_string (Json *item, const char* str) {
 }
 
 /* Predeclare these prototypes. */
-static const char* parse_value (Json *item, const char* value);
-static const char* parse_array (Json *item, const char* value);
-static const char* parse_object (Json *item, const char* value);
+typedef struct {
+	const char* ep;
+	const char* rawName;
+	Json* root;
+	Json* rawParent; /* The item whose children are not parsed. */
+} _JsonParse;
+
+static const char* parse_value (Json *item, const char* value, _JsonParse* parse);
+static const char* parse_array (Json *item, const char* value, _JsonParse* parse);
+static const char* parse_object (Json *item, const char* value, _JsonParse* parse);
 
 /* Utility to jump whitespace and cr/lf */
 static const char* skip (const char* in) {
@@ -233,25 +244,74 @@ static const char* skip (const char* in) {
 	return in;
 }
 
-/* Parse an object - create a new root, and populate. */
-Json *Json_create (const char* value) {
+/* Skip a value without parsing it, leaving its text in valueString and its length in valueInt. */
+static const char* parse_raw (Json *item, const char* value, const char** ep) {
+	int depth = 0;
+	item->type = Json_Raw;
+	item->valueString = value;
+	for (; *value; ++value) {
+		switch (*value) {
+		case '{': /* fallthrough */
+		case '[':
+			depth++;
+			break;
+		case '}': /* fallthrough */
+		case ']':
+			if (depth == 0) goto end;
+			depth--;
+			break;
+		case ',':
+			if (depth == 0) goto end;
+			break;
+		case '\"':
+			for (++value; *value != '\"'; ++value) {
+				if (!*value) {
+					*ep = value;
+					return 0;
+				}
+				if (*value == '\\' && value[1]) ++value;
+			}
+			break;
+		}
+	}
+	end:
+	if (depth || value == item->valueString) {
+		*ep = value;
+		return 0;
+	}
+	item->valueInt = (int)(value - item->valueString);
+	while (item->valueInt && (unsigned char)item->valueString[item->valueInt - 1] <= 32)
+		item->valueInt--;
+	return value;
+}
+
+Json *Json_createRaw (const char* value, const char** error, const char* rawName) {
 	Json *c;
-	ep = 0;
+	_JsonParse parse = {0, 0, 0, 0};
+	if (error) *error = 0;
 	if (!value) return 0; /* only place we check for NULL other than skip() */
 	c = Json_new();
 	if (!c) return 0; /* memory fail */
 
-	value = parse_value(c, skip(value));
+	parse.rawName = rawName;
+	parse.root = c;
+	value = parse_value(c, skip(value), &parse);
 	if (!value) {
 		Json_dispose(c);
+		if (error) *error = parse.ep;
 		return 0;
 	} /* parse failure. ep is set. */
 
 	return c;
 }
 
+/* Parse an object - create a new root, and populate. */
+Json *Json_create (const char* value, const char** error) {
+	return Json_createRaw(value, error, 0);
+}
+
 /* Parser core - when encountering text, process appropriately. */
-static const char* parse_value (Json *item, const char* value) {
+static const char* parse_value (Json *item, const char* value, _JsonParse* parse) {
 	/* Referenced by Json_create(), parse_array(), and parse_object(). */
 	/* Always called with the result of skip(). */
 #if SPINE_JSON_DEBUG /* Checked at entry to graph, Json_create, and after every parse_ call. */
@@ -283,11 +343,11 @@ static const char* parse_value (Json *item, const char* value) {
 		break;
 	}
 	case '\"':
-		return parse_string(item, value);
+		return parse_string(item, value, &parse->ep);
 	case '[':
-		return parse_array(item, value);
+		return parse_array(item, value, parse);
 	case '{':
-		return parse_object(item, value);
+		return parse_object(item, value, parse);
 	case '-': /* fallthrough */
 	case '0': /* fallthrough */
 	case '1': /* fallthrough */
@@ -299,22 +359,22 @@ static const char* parse_value (Json *item, const char* value) {
 	case '7': /* fallthrough */
 	case '8': /* fallthrough */
 	case '9':
-		return parse_number(item, value);
+		return parse_number(item, value, &parse->ep);
 	default:
 		break;
 	}
 
-	ep = value;
+	parse->ep = value;
 	return 0; /* failure. */
 }
 
 /* Build an array from input text. */
-static const char* parse_array (Json *item, const char* value) {
+static const char* parse_array (Json *item, const char* value, _JsonParse* parse) {
 	Json *child;
 
 #if SPINE_JSON_DEBUG /* unnecessary, only callsite (parse_value) verifies this */
 	if (*value != '[') {
-		ep = value;
+		parse->ep = value;
 		return 0;
 	} /* not an array! */
 #endif
@@ -325,7 +385,7 @@ static const char* parse_array (Json *item, const char* value) {
 
 	item->child = child = Json_new();
 	if (!item->child) return 0; /* memory fail */
-	value = skip(parse_value(child, skip(value))); /* skip any spacing, get the value. */
+	value = skip(parse_value(child, skip(value), parse)); /* skip any spacing, get the value. */
 	if (!value) return 0;
 	item->size = 1;
 
@@ -337,23 +397,30 @@ static const char* parse_array (Json *item, const char* value) {
 		new_item->prev = child;
 #endif
 		child = new_item;
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(child, skip(value + 1), parse));
 		if (!value) return 0; /* parse fail */
 		item->size++;
 	}
 
 	if (*value == ']') return value + 1; /* end of array */
-	ep = value;
+	parse->ep = value;
 	return 0; /* malformed. */
 }
 
+/* Parse the value of an object's item, or skip it for the children of the raw item, see Json_createRaw. */
+static const char* parse_member (Json *item, Json *child, const char* value, _JsonParse* parse) {
+	if (item == parse->rawParent) return parse_raw(child, value, &parse->ep);
+	if (item == parse->root && parse->rawName && !strcmp(child->name, parse->rawName)) parse->rawParent = child;
+	return parse_value(child, value, parse);
+}
+
 /* Build an object from the text. */
-static const char* parse_object (Json *item, const char* value) {
+static const char* parse_object (Json *item, const char* value, _JsonParse* parse) {
 	Json *child;
 
 #if SPINE_JSON_DEBUG /* unnecessary, only callsite (parse_value) verifies this */
 	if (*value != '{') {
-		ep = value;
+		parse->ep = value;
 		return 0;
 	} /* not an object! */
 #endif
@@ -364,15 +431,15 @@ static const char* parse_object (Json *item, const char* value) {
 
 	item->child = child = Json_new();
 	if (!item->child) return 0;
-	value = skip(parse_string(child, skip(value)));
+	value = skip(parse_string(child, skip(value), &parse->ep));
 	if (!value) return 0;
 	child->name = child->valueString;
 	child->valueString = 0;
 	if (*value != ':') {
-		ep = value;
+		parse->ep = value;
 		return 0;
 	} /* fail! */
-	value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+	value = skip(parse_member(item, child, skip(value + 1), parse)); /* skip any spacing, get the value. */
 	if (!value) return 0;
 	item->size = 1;
 
@@ -384,21 +451,21 @@ static const char* parse_object (Json *item, const char* value) {
 		new_item->prev = child;
 #endif
 		child = new_item;
-		value = skip(parse_string(child, skip(value + 1)));
+		value = skip(parse_string(child, skip(value + 1), &parse->ep));
 		if (!value) return 0;
 		child->name = child->valueString;
 		child->valueString = 0;
 		if (*value != ':') {
-			ep = value;
+			parse->ep = value;
 			return 0;
 		} /* fail! */
-		value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+		value = skip(parse_member(item, child, skip(value + 1), parse)); /* skip any spacing, get the value. */
 		if (!value) return 0;
 		item->size++;
 	}
 
 	if (*value == '}') return value + 1; /* end of array */
-	ep = value;
+	parse->ep = value;
 	return 0; /* malformed. */
 }
 
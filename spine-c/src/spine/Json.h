@@ -37,6 +37,7 @@ extern "C" {
 #define Json_String 4
 #define Json_Array 5
 #define Json_Object 6
+#define Json_Raw 7 /* Not parsed, see Json_createRaw. */
 
 #ifndef SPINE_JSON_HAVE_PREV
 /* Spine doesn't use the "prev" link in the Json sibling lists. */
@@ -61,8 +62,15 @@ typedef struct Json {
 	const char* name; /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
 } Json;
 
-/* Supply a block of JSON, and this returns a Json object you can interrogate. Call Json_dispose when finished. */
-Json* Json_create (const char* value);
+/* Supply a block of JSON, and this returns a Json object you can interrogate. Call Json_dispose when finished.
+ * @param error May be 0. For analysing failed parses, set to a pointer to the parse error when 0 is returned. You'll probably need
+ * to look a few chars back to make sense of it. */
+Json* Json_create (const char* value, const char** error);
+
+/* Like Json_create, but the values of the items in the root object's item named rawName are not parsed. Those items are
+ * Json_Raw, their valueString points to the value's text in value, which must outlive the Json, and valueInt is the text's
+ * length. */
+Json* Json_createRaw (const char* value, const char** error, const char* rawName);
 
 /* Delete a Json entity and all subentities. */
 void Json_dispose (Json* json);
@@ -73,9 +81,6 @@ const char* Json_getString (Json* json, const char* name, const char* defaultVal
 float Json_getFloat (Json* json, const char* name, float defaultValue);
 int Json_getInt (Json* json, const char* name, int defaultValue);
 
-/* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when Json_create() returns 0. 0 when Json_create() succeeds. */
-const char* Json_getError (void);
-
 #ifdef __cplusplus
 }
 #endif
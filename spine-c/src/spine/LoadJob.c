@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/LoadJob.h>
+#include <spine/SkeletonJson.h>
+#include <spine/extension.h>
+
+typedef struct {
+	spLoadJob super;
+
+	/* Shared between the thread calling spLoadJob_run and the main thread. */
+	volatile int state;
+	volatile int canceled;
+	volatile int stepsDone, stepsCount;
+
+	void** images; /* Decoded images of the pages not yet uploaded, in page order. */
+	int pagesCount, uploadedCount;
+	int/*bool*/notified;
+} _spLoadJob;
+
+spLoadJob* spLoadJob_create (const char* atlasPath, const char* skeletonPath) {
+	spLoadJob* self = SUPER(NEW(_spLoadJob));
+	MALLOC_STR(self->atlasPath, atlasPath);
+	MALLOC_STR(self->skeletonPath, skeletonPath);
+	self->scale = 1;
+	return self;
+}
+
+void spLoadJob_dispose (spLoadJob* self) {
+	_spLoadJob* internal = SUB_CAST(_spLoadJob, self);
+	int i;
+	if (internal->images) {
+		for (i = 0; i < internal->pagesCount; ++i)
+			if (internal->images[i]) self->disposeImage(self, internal->images[i]);
+		FREE(internal->images);
+	}
+	if (_spAtomic_get(&internal->state) != SP_LOAD_JOB_COMPLETE) {
+		if (self->skeletonData) spSkeletonData_dispose(self->skeletonData);
+		if (self->atlas) spAtlas_dispose(self->atlas);
+	}
+	FREE(self->atlasPath);
+	FREE(self->skeletonPath);
+	FREE(self->error);
+	FREE(self);
+}
+
+static void _spLoadJob_step (_spLoadJob* self, int count) {
+	_spAtomic_set(&self->stepsDone, _spAtomic_get(&self->stepsDone) + count);
+}
+
+static void _spLoadJob_fail (_spLoadJob* self, const char* value1, const char* value2) {
+	CONST_CAST(char*, self->super.error) = _formatError(value1, value2);
+	_spAtomic_set(&self->state, SP_LOAD_JOB_FAILED);
+}
+
+/* Returns true if the job was canceled, after setting its state. */
+static int/*bool*/_spLoadJob_checkCanceled (_spLoadJob* self) {
+	if (!_spAtomic_get(&self->canceled)) return 0;
+	_spAtomic_set(&self->state, SP_LOAD_JOB_CANCELED);
+	return 1;
+}
+
+void spLoadJob_run (spLoadJob* self) {
+	_spLoadJob* internal = SUB_CAST(_spLoadJob, self);
+	spAtlasPage* page;
+	spSkeletonJson* json;
+	int i;
+	int/*bool*/sizesMissing = 0;
+
+	if (!_spAtomic_compareAndSet(&internal->state, SP_LOAD_JOB_PENDING, SP_LOAD_JOB_LOADING)) return;
+
+	CONST_CAST(spAtlas*, self->atlas) = _spAtlas_createFromFileWithoutTextures(self->atlasPath, self->rendererObject);
+	if (!self->atlas) {
+		_spLoadJob_fail(internal, "Error reading atlas file: ", self->atlasPath);
+		return;
+	}
+	for (page = self->atlas->pages; page; page = page->next)
+		internal->pagesCount++;
+	/* Reading the atlas, decoding each page, reading the skeleton data and uploading each page. */
+	_spAtomic_set(&internal->stepsCount, 2 + internal->pagesCount * 2);
+	_spLoadJob_step(internal, 1);
+
+	if (self->decodePage) {
+		internal->images = CALLOC(void*, internal->pagesCount);
+		for (page = self->atlas->pages, i = 0; page; page = page->next, ++i) {
+			char* path;
+			if (_spLoadJob_checkCanceled(internal)) return;
+			if (!page->width || !page->height) sizesMissing = 1;
+			path = _spAtlas_getTexturePath(self->atlas, page);
+			internal->images[i] = self->decodePage(self, page, path);
+			FREE(path);
+			if (!internal->images[i]) {
+				_spLoadJob_fail(internal, "Error decoding atlas page: ", page->name);
+				return;
+			}
+			_spLoadJob_step(internal, 1);
+		}
+		/* The regions of pages sized by the decoder need UVs before attachments are created from them. */
+		if (sizesMissing) _spAtlas_updateUVs(self->atlas);
+	} else {
+		for (page = self->atlas->pages; page; page = page->next) {
+			if (!page->width || !page->height) {
+				_spLoadJob_fail(internal, "Atlas page size is required without a decoder: ", page->name);
+				return;
+			}
+		}
+		_spLoadJob_step(internal, internal->pagesCount);
+	}
+
+	if (_spLoadJob_checkCanceled(internal)) return;
+	json = spSkeletonJson_create(self->atlas);
+	json->scale = self->scale;
+	json->parallelFor = self->parallelFor;
+	CONST_CAST(spSkeletonData*, self->skeletonData) = spSkeletonJson_readSkeletonDataFile(json, self->skeletonPath);
+	if (!self->skeletonData) {
+		_spLoadJob_fail(internal, json->error, 0);
+		spSkeletonJson_dispose(json);
+		return;
+	}
+	spSkeletonJson_dispose(json);
+	_spLoadJob_step(internal, 1);
+
+	_spAtomic_set(&internal->state, SP_LOAD_JOB_LOADED);
+}
+
+int spLoadJob_update (spLoadJob* self) {
+	_spLoadJob* internal = SUB_CAST(_spLoadJob, self);
+	spAtlasPage* page;
+	int i;
+
+	if (internal->notified) return 1;
+	if (_spAtomic_get(&internal->canceled)) {
+		/* Jobs not yet run or waiting for textures are canceled here, others by spLoadJob_run. */
+		if (!_spAtomic_compareAndSet(&internal->state, SP_LOAD_JOB_PENDING, SP_LOAD_JOB_CANCELED))
+			_spAtomic_compareAndSet(&internal->state, SP_LOAD_JOB_LOADED, SP_LOAD_JOB_CANCELED);
+	}
+
+	switch (_spAtomic_get(&internal->state)) {
+	case SP_LOAD_JOB_PENDING:
+	case SP_LOAD_JOB_LOADING:
+		return 0;
+	case SP_LOAD_JOB_LOADED:
+		/* One page per call, so uploads are spread over frames. */
+		for (page = self->atlas->pages, i = 0; i < internal->uploadedCount; ++i)
+			page = page->next;
+		if (page) {
+			if (internal->images) {
+				self->uploadPage(self, page, internal->images[i]);
+				self->disposeImage(self, internal->images[i]);
+				internal->images[i] = 0;
+			} else {
+				char* path = _spAtlas_getTexturePath(self->atlas, page);
+				_spAtlasPage_createTexture(page, path);
+				FREE(path);
+			}
+			internal->uploadedCount++;
+			_spLoadJob_step(internal, 1);
+			if (page->next) return 0;
+		}
+		_spAtomic_set(&internal->state, SP_LOAD_JOB_COMPLETE);
+		break;
+	default:
+		break;
+	}
+
+	internal->notified = 1;
+	if (self->listener) self->listener(self);
+	return 1;
+}
+
+void spLoadJob_cancel (spLoadJob* self) {
+	_spAtomic_set(&SUB_CAST(_spLoadJob, self)->canceled, 1);
+}
+
+spLoadJobState spLoadJob_getState (spLoadJob* self) {
+	return (spLoadJobState)_spAtomic_get(&SUB_CAST(_spLoadJob, self)->state);
+}
+
+float spLoadJob_getProgress (spLoadJob* self) {
+	_spLoadJob* internal = SUB_CAST(_spLoadJob, self);
+	int stepsCount = _spAtomic_get(&internal->stepsCount);
+	if (_spAtomic_get(&internal->state) == SP_LOAD_JOB_COMPLETE) return 1;
+	return stepsCount ? _spAtomic_get(&internal->stepsDone) / (float)stepsCount : 0;
+}
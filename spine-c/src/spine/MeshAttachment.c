@@ -40,6 +40,7 @@ void _spMeshAttachment_dispose (spAttachment* attachment) {
 	FREE(self->regionUVs);
 	FREE(self->uvs);
 	FREE(self->triangles);
+	FREE(self->shortTriangles);
 	FREE(self->edges);
 	FREE(self);
 }
@@ -55,32 +56,54 @@ spMeshAttachment* spMeshAttachment_create (const char* name) {
 }
 
 void spMeshAttachment_updateUVs (spMeshAttachment* self) {
-	int i;
-	float width = self->regionU2 - self->regionU, height = self->regionV2 - self->regionV;
 	FREE(self->uvs);
 	self->uvs = MALLOC(float, self->verticesCount);
+	spMeshAttachment_computeUVs(self, self->uvs);
+}
+
+void spMeshAttachment_computeUVs (const spMeshAttachment* self, float* uvs) {
+	int i;
+	float width = self->regionU2 - self->regionU, height = self->regionV2 - self->regionV;
 	if (self->regionRotate) {
 		for (i = 0; i < self->verticesCount; i += 2) {
-			self->uvs[i] = self->regionU + self->regionUVs[i + 1] * width;
-			self->uvs[i + 1] = self->regionV + height - self->regionUVs[i] * height;
+			uvs[i] = self->regionU + self->regionUVs[i + 1] * width;
+			uvs[i + 1] = self->regionV + height - self->regionUVs[i] * height;
 		}
 	} else {
 		for (i = 0; i < self->verticesCount; i += 2) {
-			self->uvs[i] = self->regionU + self->regionUVs[i] * width;
-			self->uvs[i + 1] = self->regionV + self->regionUVs[i + 1] * height;
+			uvs[i] = self->regionU + self->regionUVs[i] * width;
+			uvs[i + 1] = self->regionV + self->regionUVs[i + 1] * height;
 		}
 	}
 }
 
+void spMeshAttachment_compact (spMeshAttachment* self) {
+	if (self->triangles) {
+		self->shortTriangles = _toShorts(self->triangles, self->trianglesCount);
+		if (self->shortTriangles) {
+			FREE(self->triangles);
+			self->triangles = 0;
+		}
+	}
+	FREE(self->uvs);
+	self->uvs = 0;
+}
+
 void spMeshAttachment_computeWorldVertices (spMeshAttachment* self, spSlot* slot, float* worldVertices) {
+	spMeshAttachment_computeWorldVerticesStrided(self, slot, worldVertices, 0, 2);
+}
+
+void spMeshAttachment_computeWorldVerticesStrided (spMeshAttachment* self, spSlot* slot, float* worldVertices, int start,
+		int stride) {
 	int i;
 	float* vertices = self->vertices;
+	float* vertex = worldVertices + start;
 	const spBone* bone = slot->bone;
 	float x = bone->skeleton->x + bone->worldX, y = bone->skeleton->y + bone->worldY;
 	if (slot->attachmentVerticesCount == self->verticesCount) vertices = slot->attachmentVertices;
-	for (i = 0; i < self->verticesCount; i += 2) {
+	for (i = 0; i < self->verticesCount; i += 2, vertex += stride) {
 		const float vx = vertices[i], vy = vertices[i + 1];
-		worldVertices[i] = vx * bone->m00 + vy * bone->m01 + x;
-		worldVertices[i + 1] = vx * bone->m10 + vy * bone->m11 + y;
+		vertex[0] = vx * bone->m00 + vy * bone->m01 + x;
+		vertex[1] = vx * bone->m10 + vy * bone->m11 + y;
 	}
 }
@@ -0,0 +1,304 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/PoseCache.h>
+#include <spine/extension.h>
+#include <string.h>
+
+/* Mix alphas within the same 1/MIX_STEPS share a pose. */
+#define MIX_STEPS 64
+
+typedef struct {
+	const spSkeletonData* skeletonData;
+	const spSkin* skin;
+	int/*bool*/flipX, flipY, yDown;
+	int tracksCount;
+} _spPoseKey;
+
+typedef struct {
+	const spAnimation* animation;
+	int/*bool*/loop;
+	int time;
+	int mix;
+} _spPoseKeyTrack;
+
+typedef struct _spPoseEntry _spPoseEntry;
+struct _spPoseEntry {
+	_spPoseEntry* next; /* Next entry in the same bucket. */
+	_spPoseEntry* newer;
+	_spPoseEntry* older;
+	unsigned int hash;
+	int keySize, poseSize;
+	char* key;
+	char* pose;
+};
+
+typedef struct {
+	spPoseCache super;
+
+	int bucketsCount;
+	_spPoseEntry** buckets;
+	_spPoseEntry* newest;
+	_spPoseEntry* oldest;
+
+	int keyCapacity;
+	char* key;
+	int bonesMaskCapacity;
+	int* bonesMask; /* Always zero, used to process events without posing. */
+} _spPoseCache;
+
+spPoseCache* spPoseCache_create (float timeStep, int memoryBudget) {
+	_spPoseCache* internal = NEW(_spPoseCache);
+	spPoseCache* self = SUPER(internal);
+	self->timeStep = timeStep;
+	self->memoryBudget = memoryBudget;
+	internal->bucketsCount = 64;
+	internal->buckets = CALLOC(_spPoseEntry*, internal->bucketsCount);
+	return self;
+}
+
+void spPoseCache_dispose (spPoseCache* self) {
+	_spPoseCache* internal = SUB_CAST(_spPoseCache, self);
+	spPoseCache_clear(self);
+	FREE(internal->buckets);
+	FREE(internal->key);
+	FREE(internal->bonesMask);
+	FREE(self);
+}
+
+static void _spPoseEntry_dispose (_spPoseEntry* self) {
+	FREE(self->key);
+	FREE(self->pose);
+	FREE(self);
+}
+
+void spPoseCache_clear (spPoseCache* self) {
+	_spPoseCache* internal = SUB_CAST(_spPoseCache, self);
+	_spPoseEntry* entry = internal->newest;
+	while (entry) {
+		_spPoseEntry* older = entry->older;
+		_spPoseEntry_dispose(entry);
+		entry = older;
+	}
+	memset(internal->buckets, 0, sizeof(_spPoseEntry*) * internal->bucketsCount);
+	internal->newest = 0;
+	internal->oldest = 0;
+	CONST_CAST(int, self->memoryUsed) = 0;
+	CONST_CAST(int, self->posesCount) = 0;
+}
+
+/**/
+
+static int _spPoseCache_quantizeTime (const spPoseCache* self, const spTrackEntry* entry) {
+	int bits;
+	float time = entry->time;
+	if (!entry->loop && time > entry->endTime) time = entry->endTime;
+	if (entry->loop && entry->animation->duration) time = FMOD(time, entry->animation->duration);
+	if (self->timeStep > 0) return (int)(time / self->timeStep);
+	memcpy(&bits, &time, sizeof(int));
+	return bits;
+}
+
+static int _spPoseCache_buildKey (_spPoseCache* internal, const spAnimationState* state, const spSkeleton* skeleton) {
+	int i;
+	_spPoseKey* key;
+	_spPoseKeyTrack* tracks;
+	int size = sizeof(_spPoseKey) + sizeof(_spPoseKeyTrack) * 2 * state->tracksCount;
+	if (internal->keyCapacity < size) {
+		FREE(internal->key);
+		internal->key = MALLOC(char, size);
+		internal->keyCapacity = size;
+	}
+	/* Keys are compared with memcmp, so padding must be cleared too. */
+	memset(internal->key, 0, size);
+
+	key = (_spPoseKey*)internal->key;
+	key->skeletonData = skeleton->data;
+	key->skin = skeleton->skin;
+	key->flipX = skeleton->flipX;
+	key->flipY = skeleton->flipY;
+	key->yDown = skeleton->yDown;
+	key->tracksCount = state->tracksCount;
+
+	tracks = (_spPoseKeyTrack*)(key + 1);
+	for (i = 0; i < state->tracksCount; ++i) {
+		spTrackEntry* current = state->tracks[i];
+		_spPoseKeyTrack* track = tracks + i * 2;
+		float mix;
+		if (!current) continue;
+		mix = current->mix;
+		if (current->previous) {
+			spTrackEntry* previous = current->previous;
+			mix = current->mixTime / current->mixDuration * current->mix;
+			if (mix > 1) mix = 1;
+			track[1].animation = previous->animation;
+			track[1].loop = previous->loop;
+			track[1].time = _spPoseCache_quantizeTime(SUPER(internal), previous);
+		}
+		track->animation = current->animation;
+		track->loop = current->loop;
+		track->time = _spPoseCache_quantizeTime(SUPER(internal), current);
+		track->mix = (int)(mix * MIX_STEPS + 0.5f);
+	}
+	return size;
+}
+
+static unsigned int _spPoseCache_hash (const char* key, int keySize) {
+	/* FNV-1a. */
+	unsigned int hash = 2166136261u;
+	int i;
+	for (i = 0; i < keySize; ++i) {
+		hash ^= (unsigned char)key[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**/
+
+static void _spPoseCache_unlink (_spPoseCache* internal, _spPoseEntry* entry) {
+	if (entry->newer)
+		entry->newer->older = entry->older;
+	else
+		internal->newest = entry->older;
+	if (entry->older)
+		entry->older->newer = entry->newer;
+	else
+		internal->oldest = entry->newer;
+}
+
+static void _spPoseCache_linkNewest (_spPoseCache* internal, _spPoseEntry* entry) {
+	entry->newer = 0;
+	entry->older = internal->newest;
+	if (internal->newest)
+		internal->newest->newer = entry;
+	else
+		internal->oldest = entry;
+	internal->newest = entry;
+}
+
+static void _spPoseCache_evict (_spPoseCache* internal, _spPoseEntry* entry) {
+	_spPoseEntry** bucket = internal->buckets + (entry->hash & (internal->bucketsCount - 1));
+	while (*bucket != entry)
+		bucket = &(*bucket)->next;
+	*bucket = entry->next;
+	_spPoseCache_unlink(internal, entry);
+
+	CONST_CAST(int, internal->super.memoryUsed) -= sizeof(_spPoseEntry) + entry->keySize + entry->poseSize;
+	CONST_CAST(int, internal->super.posesCount)--;
+	_spPoseEntry_dispose(entry);
+}
+
+static void _spPoseCache_growBuckets (_spPoseCache* internal) {
+	int i, bucketsCount = internal->bucketsCount * 2;
+	_spPoseEntry** buckets = CALLOC(_spPoseEntry*, bucketsCount);
+	for (i = 0; i < internal->bucketsCount; ++i) {
+		_spPoseEntry* entry = internal->buckets[i];
+		while (entry) {
+			_spPoseEntry* next = entry->next;
+			_spPoseEntry** bucket = buckets + (entry->hash & (bucketsCount - 1));
+			entry->next = *bucket;
+			*bucket = entry;
+			entry = next;
+		}
+	}
+	FREE(internal->buckets);
+	internal->buckets = buckets;
+	internal->bucketsCount = bucketsCount;
+}
+
+static _spPoseEntry* _spPoseCache_find (_spPoseCache* internal, unsigned int hash, int keySize) {
+	_spPoseEntry* entry = internal->buckets[hash & (internal->bucketsCount - 1)];
+	for (; entry; entry = entry->next)
+		if (entry->hash == hash && entry->keySize == keySize && memcmp(entry->key, internal->key, keySize) == 0) return entry;
+	return 0;
+}
+
+static void _spPoseCache_store (_spPoseCache* internal, unsigned int hash, int keySize, const spSkeleton* skeleton) {
+	spPoseCache* self = SUPER(internal);
+	_spPoseEntry* entry;
+	_spPoseEntry** bucket;
+	int poseSize = _spSkeleton_getPoseSize(skeleton);
+	int size = sizeof(_spPoseEntry) + keySize + poseSize;
+	if (size > self->memoryBudget) return;
+
+	while (self->memoryUsed + size > self->memoryBudget) {
+		_spPoseCache_evict(internal, internal->oldest);
+		self->evictions++;
+	}
+	if (self->posesCount >= internal->bucketsCount) _spPoseCache_growBuckets(internal);
+
+	entry = NEW(_spPoseEntry);
+	entry->hash = hash;
+	entry->keySize = keySize;
+	entry->key = MALLOC(char, keySize);
+	memcpy(entry->key, internal->key, keySize);
+	entry->poseSize = poseSize;
+	entry->pose = MALLOC(char, poseSize);
+	_spSkeleton_writePose(skeleton, entry->pose);
+
+	bucket = internal->buckets + (hash & (internal->bucketsCount - 1));
+	entry->next = *bucket;
+	*bucket = entry;
+	_spPoseCache_linkNewest(internal, entry);
+
+	CONST_CAST(int, self->memoryUsed) += size;
+	CONST_CAST(int, self->posesCount)++;
+}
+
+int spPoseCache_apply (spPoseCache* self, spAnimationState* state, spSkeleton* skeleton) {
+	_spPoseCache* internal = SUB_CAST(_spPoseCache, self);
+	int keySize = _spPoseCache_buildKey(internal, state, skeleton);
+	unsigned int hash = _spPoseCache_hash(internal->key, keySize);
+	_spPoseEntry* entry = _spPoseCache_find(internal, hash, keySize);
+
+	if (!entry) {
+		self->misses++;
+		spAnimationState_apply(state, skeleton);
+		spSkeleton_updateWorldTransform(skeleton);
+		_spPoseCache_store(internal, hash, keySize, skeleton);
+		return 0;
+	}
+
+	self->hits++;
+	if (internal->bonesMaskCapacity < skeleton->bonesCount) {
+		FREE(internal->bonesMask);
+		internal->bonesMask = CALLOC(int, skeleton->bonesCount);
+		internal->bonesMaskCapacity = skeleton->bonesCount;
+	}
+	/* Only event and IK constraint timelines are applied, the IK constraints are then overwritten by the cached pose. */
+	spAnimationState_applyMasked(state, skeleton, internal->bonesMask);
+	_spSkeleton_readPose(skeleton, entry->pose);
+
+	_spPoseCache_unlink(internal, entry);
+	_spPoseCache_linkNewest(internal, entry);
+	return 1;
+}
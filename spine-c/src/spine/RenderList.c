@@ -0,0 +1,473 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/RenderList.h>
+#include <spine/extension.h>
+#include <float.h>
+
+static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+
+typedef struct {
+	const spAttachment* attachment;
+	float* uvs;
+} _spPixelUVs;
+
+typedef struct {
+	spRenderList super;
+
+	int verticesCapacity;
+	int indicesCapacity;
+	int batchesCapacity;
+	int worldVerticesCapacity;
+	float* worldVertices;
+
+	/* The UVs and triangles of the compact mesh being written. */
+	int uvsCapacity;
+	float* uvs;
+	int trianglesCapacity;
+	int* triangles;
+
+	/* Open addressing hash of the UVs scaled to pixels, keyed by attachment. */
+	int pixelUVsCapacity;
+	int pixelUVsCount;
+	_spPixelUVs* pixelUVs;
+
+	/* The skeleton last built by spRenderList_updateSkeleton, or 0, and its topology version at the time. */
+	const spSkeleton* retainedSkeleton;
+	const spSkeletonData* retainedData;
+	int retainedVersion;
+} _spRenderList;
+
+spRenderList* spRenderList_create (const spVertexFormat* format) {
+	_spRenderList* internal = NEW(_spRenderList);
+	spRenderList* self = SUPER(internal);
+	CONST_CAST(spVertexFormat, self->format) = *format;
+	spRenderList_clear(self);
+	return self;
+}
+
+void spRenderList_dispose (spRenderList* self) {
+	_spRenderList* internal = SUB_CAST(_spRenderList, self);
+	FREE(self->vertices);
+	FREE(self->indices);
+	FREE(self->batches);
+	FREE(internal->worldVertices);
+	FREE(internal->uvs);
+	FREE(internal->triangles);
+	spRenderList_clearUVCache(self);
+	FREE(internal->pixelUVs);
+	FREE(self);
+}
+
+static void _spRenderList_clearBounds (spRenderList* self) {
+	CONST_CAST(float, self->minX) = FLT_MAX;
+	CONST_CAST(float, self->minY) = FLT_MAX;
+	CONST_CAST(float, self->maxX) = -FLT_MAX;
+	CONST_CAST(float, self->maxY) = -FLT_MAX;
+}
+
+void spRenderList_clear (spRenderList* self) {
+	SUB_CAST(_spRenderList, self)->retainedSkeleton = 0;
+	CONST_CAST(int, self->verticesCount) = 0;
+	CONST_CAST(int, self->indicesCount) = 0;
+	CONST_CAST(int, self->batchesCount) = 0;
+	_spRenderList_clearBounds(self);
+}
+
+/* Returns a buffer of at least the required number of elements, keeping the first count elements. New space is zeroed, so bytes
+ * of a vertex that are never written stay zero. */
+static void* _spRenderList_grow (void* data, int count, int elementSize, int* capacity, int required) {
+	char* newData;
+	int newCapacity;
+	if (required <= *capacity) return data;
+	newCapacity = *capacity ? *capacity : 64;
+	while (newCapacity < required)
+		newCapacity <<= 1;
+	newData = CALLOC(char, newCapacity * elementSize);
+	if (count) memcpy(newData, data, count * elementSize);
+	FREE(data);
+	*capacity = newCapacity;
+	return newData;
+}
+
+void spRenderList_reserve (spRenderList* self, int verticesCount, int indicesCount) {
+	_spRenderList* internal = SUB_CAST(_spRenderList, self);
+	CONST_CAST(void*, self->vertices) = _spRenderList_grow(self->vertices, self->verticesCount, self->format.stride,
+			&internal->verticesCapacity, verticesCount);
+	if (!self->format.triangleList) {
+		CONST_CAST(void*, self->indices) = _spRenderList_grow(self->indices, self->indicesCount, self->format.indexSize,
+				&internal->indicesCapacity, indicesCount);
+	}
+}
+
+/* Returns 0 for attachments that are not drawn. */
+static int _spRenderList_getAttachmentSize (const spAttachment* attachment, int* indicesCount) {
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		*indicesCount = 6;
+		return 4;
+	case SP_ATTACHMENT_MESH:
+		*indicesCount = ((spMeshAttachment*)attachment)->trianglesCount;
+		return ((spMeshAttachment*)attachment)->verticesCount >> 1;
+	case SP_ATTACHMENT_SKINNED_MESH:
+		*indicesCount = ((spSkinnedMeshAttachment*)attachment)->trianglesCount;
+		return ((spSkinnedMeshAttachment*)attachment)->uvsCount >> 1;
+	default:
+		*indicesCount = 0;
+		return 0;
+	}
+}
+
+void spRenderList_reserveForSkeletonData (spRenderList* self, const spSkeletonData* skeletonData, int skeletonsCount) {
+	int i, ii, iii, verticesCount = 0, indicesCount = 0;
+	for (i = 0; i < skeletonData->slotsCount; ++i) {
+		int slotVerticesCount = 0, slotIndicesCount = 0;
+		for (ii = 0; ii < skeletonData->skinsCount; ++ii) {
+			const spSkin* skin = skeletonData->skins[ii];
+			const char* name;
+			for (iii = 0; (name = spSkin_getAttachmentName(skin, i, iii)) != 0; ++iii) {
+				int attachmentIndicesCount, attachmentVerticesCount;
+				attachmentVerticesCount = _spRenderList_getAttachmentSize(spSkin_getAttachment(skin, i, name),
+						&attachmentIndicesCount);
+				if (self->format.triangleList) attachmentVerticesCount = attachmentIndicesCount;
+				if (attachmentVerticesCount > slotVerticesCount) slotVerticesCount = attachmentVerticesCount;
+				if (attachmentIndicesCount > slotIndicesCount) slotIndicesCount = attachmentIndicesCount;
+			}
+		}
+		verticesCount += slotVerticesCount;
+		indicesCount += slotIndicesCount;
+	}
+	spRenderList_reserve(self, self->verticesCount + verticesCount * skeletonsCount,
+			self->indicesCount + indicesCount * skeletonsCount);
+}
+
+void spRenderList_clearUVCache (spRenderList* self) {
+	_spRenderList* internal = SUB_CAST(_spRenderList, self);
+	int i;
+	for (i = 0; i < internal->pixelUVsCapacity; ++i) {
+		FREE(internal->pixelUVs[i].uvs);
+		internal->pixelUVs[i].attachment = 0;
+		internal->pixelUVs[i].uvs = 0;
+	}
+	internal->pixelUVsCount = 0;
+}
+
+static _spPixelUVs* _spRenderList_findPixelUVs (_spPixelUVs* entries, int capacity, const spAttachment* attachment) {
+	int mask = capacity - 1;
+	int i = (int)(((size_t)attachment >> 3) * 2654435761u) & mask;
+	while (entries[i].attachment && entries[i].attachment != attachment)
+		i = (i + 1) & mask;
+	return entries + i;
+}
+
+/* Returns the UVs multiplied by the page size, computed the first time the attachment is drawn. */
+static const float* _spRenderList_getPixelUVs (_spRenderList* internal, const spAttachment* attachment, const float* uvs,
+		int uvsCount, const spAtlasPage* page) {
+	_spPixelUVs* entry;
+	int i;
+	if (internal->pixelUVsCount * 2 >= internal->pixelUVsCapacity) {
+		int capacity = internal->pixelUVsCapacity ? internal->pixelUVsCapacity << 1 : 64;
+		_spPixelUVs* entries = CALLOC(_spPixelUVs, capacity);
+		for (i = 0; i < internal->pixelUVsCapacity; ++i) {
+			if (internal->pixelUVs[i].attachment)
+				*_spRenderList_findPixelUVs(entries, capacity, internal->pixelUVs[i].attachment) = internal->pixelUVs[i];
+		}
+		FREE(internal->pixelUVs);
+		internal->pixelUVs = entries;
+		internal->pixelUVsCapacity = capacity;
+	}
+	entry = _spRenderList_findPixelUVs(internal->pixelUVs, internal->pixelUVsCapacity, attachment);
+	if (entry->attachment) return entry->uvs;
+
+	entry->attachment = attachment;
+	entry->uvs = MALLOC(float, uvsCount);
+	for (i = 0; i < uvsCount; i += 2) {
+		entry->uvs[i] = uvs[i] * page->width;
+		entry->uvs[i + 1] = uvs[i + 1] * page->height;
+	}
+	internal->pixelUVsCount++;
+	return entry->uvs;
+}
+
+/* Returns the UVs of a compact mesh, computed from its region UVs into a buffer reused for each mesh. */
+static const float* _spRenderList_computeUVs (_spRenderList* internal, const spAttachment* attachment, int uvsCount) {
+	internal->uvs = (float*)_spRenderList_grow(internal->uvs, 0, sizeof(float), &internal->uvsCapacity, uvsCount);
+	if (attachment->type == SP_ATTACHMENT_MESH)
+		spMeshAttachment_computeUVs((const spMeshAttachment*)attachment, internal->uvs);
+	else
+		spSkinnedMeshAttachment_computeUVs((const spSkinnedMeshAttachment*)attachment, internal->uvs);
+	return internal->uvs;
+}
+
+/* Returns the triangles of a compact mesh as ints, in a buffer reused for each mesh. */
+static const int* _spRenderList_expandTriangles (_spRenderList* internal, const unsigned short* shortTriangles, int count) {
+	int i;
+	internal->triangles = (int*)_spRenderList_grow(internal->triangles, 0, sizeof(int), &internal->trianglesCapacity, count);
+	for (i = 0; i < count; ++i)
+		internal->triangles[i] = shortTriangles[i];
+	return internal->triangles;
+}
+
+static spRenderBatch* _spRenderList_addBatch (_spRenderList* internal, spAtlasPage* page, spBlendMode blendMode) {
+	spRenderList* self = SUPER(internal);
+	spRenderBatch* batch;
+	CONST_CAST(spRenderBatch*, self->batches) = (spRenderBatch*)_spRenderList_grow(self->batches, self->batchesCount,
+			sizeof(spRenderBatch), &internal->batchesCapacity, self->batchesCount + 1);
+	batch = self->batches + CONST_CAST(int, self->batchesCount)++;
+	batch->page = page;
+	batch->rendererObject = page->rendererObject;
+	batch->blendMode = blendMode;
+	batch->firstVertex = self->verticesCount;
+	batch->verticesCount = 0;
+	batch->firstIndex = self->indicesCount;
+	batch->indicesCount = 0;
+	return batch;
+}
+
+static void _spRenderList_computeWorldVertices (spSlot* slot, float* vertices, int start, int stride) {
+	switch (slot->attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		spRegionAttachment_computeWorldVerticesStrided((spRegionAttachment*)slot->attachment, slot->bone, vertices, start, stride);
+		break;
+	case SP_ATTACHMENT_MESH:
+		spMeshAttachment_computeWorldVerticesStrided((spMeshAttachment*)slot->attachment, slot, vertices, start, stride);
+		break;
+	case SP_ATTACHMENT_SKINNED_MESH:
+		spSkinnedMeshAttachment_computeWorldVerticesStrided((spSkinnedMeshAttachment*)slot->attachment, slot, vertices, start,
+				stride);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Appends the skeleton's vertices, indices and batches or, if update is set, rewrites only the positions and colors of the
+ * vertices the skeleton's attachments were given when the list was built. Returns false if update is set and the attachments
+ * don't have the number of vertices in the list, in which case the list must be rebuilt. */
+static int/*bool*/_spRenderList_writeSkeleton (_spRenderList* internal, const spSkeleton* skeleton, int/*bool*/update) {
+	spRenderList* self = SUPER(internal);
+	const spVertexFormat* format = &self->format;
+	int i, ii;
+	int first = update ? 0 : self->verticesCount;
+	for (i = 0; i < skeleton->slotsCount; ++i) {
+		spSlot* slot = skeleton->drawOrder[i];
+		spAttachment* attachment = slot->attachment;
+		spAtlasRegion* region;
+		const float* uvs;
+		const int* triangles;
+		const unsigned short* shortTriangles = 0;
+		int verticesCount, trianglesCount, outCount;
+		float r, g, b, a;
+		unsigned char colorBytes[4];
+		float colorFloats[4];
+		const void* color;
+		int colorSize;
+		spRenderBatch* batch;
+		char* vertex;
+		const float* positions;
+		int positionsStride;
+		if (!attachment) continue;
+
+		switch (attachment->type) {
+		case SP_ATTACHMENT_REGION: {
+			spRegionAttachment* regionAttachment = (spRegionAttachment*)attachment;
+			region = (spAtlasRegion*)regionAttachment->rendererObject;
+			verticesCount = 4;
+			uvs = regionAttachment->uvs;
+			triangles = quadTriangles;
+			trianglesCount = 6;
+			r = regionAttachment->r;
+			g = regionAttachment->g;
+			b = regionAttachment->b;
+			a = regionAttachment->a;
+			break;
+		}
+		case SP_ATTACHMENT_MESH: {
+			spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+			region = (spAtlasRegion*)mesh->rendererObject;
+			verticesCount = mesh->verticesCount >> 1;
+			uvs = mesh->uvs;
+			triangles = mesh->triangles;
+			shortTriangles = mesh->shortTriangles;
+			trianglesCount = mesh->trianglesCount;
+			r = mesh->r;
+			g = mesh->g;
+			b = mesh->b;
+			a = mesh->a;
+			break;
+		}
+		case SP_ATTACHMENT_SKINNED_MESH: {
+			spSkinnedMeshAttachment* mesh = (spSkinnedMeshAttachment*)attachment;
+			region = (spAtlasRegion*)mesh->rendererObject;
+			verticesCount = mesh->uvsCount >> 1;
+			uvs = mesh->uvs;
+			triangles = mesh->triangles;
+			shortTriangles = mesh->shortTriangles;
+			trianglesCount = mesh->trianglesCount;
+			r = mesh->r;
+			g = mesh->g;
+			b = mesh->b;
+			a = mesh->a;
+			break;
+		}
+		default:
+			continue;
+		}
+		if (!region) continue;
+
+		a *= skeleton->a * slot->a;
+		r *= skeleton->r * slot->r;
+		g *= skeleton->g * slot->g;
+		b *= skeleton->b * slot->b;
+		if (format->premultipliedAlpha) {
+			r *= a;
+			g *= a;
+			b *= a;
+		}
+		if (format->color == SP_VERTEX_COLOR_BYTES) {
+			colorBytes[0] = (unsigned char)(r * 255);
+			colorBytes[1] = (unsigned char)(g * 255);
+			colorBytes[2] = (unsigned char)(b * 255);
+			colorBytes[3] = (unsigned char)(a * 255);
+			color = colorBytes;
+			colorSize = 4;
+		} else {
+			colorFloats[0] = r;
+			colorFloats[1] = g;
+			colorFloats[2] = b;
+			colorFloats[3] = a;
+			color = colorFloats;
+			colorSize = format->color == SP_VERTEX_COLOR_FLOATS ? 16 : 0;
+		}
+		outCount = format->triangleList ? trianglesCount : verticesCount;
+		if (update && first + outCount > self->verticesCount) return 0;
+		if (!triangles && (format->triangleList || !update))
+			triangles = _spRenderList_expandTriangles(internal, shortTriangles, trianglesCount);
+		if (update) {
+			batch = 0;
+		} else {
+			if (!uvs) uvs = _spRenderList_computeUVs(internal, attachment, verticesCount << 1);
+			if (format->pixelUVs) uvs = _spRenderList_getPixelUVs(internal, attachment, uvs, verticesCount << 1, region->page);
+
+			batch = self->batchesCount ? self->batches + self->batchesCount - 1 : 0;
+			if (!batch || batch->page != region->page || batch->blendMode != slot->data->blendMode
+					|| (format->maxBatchVertices && batch->verticesCount
+							&& batch->verticesCount + outCount > format->maxBatchVertices)
+					|| (format->maxBatchIndices && !format->triangleList && batch->indicesCount
+							&& batch->indicesCount + trianglesCount > format->maxBatchIndices)) {
+				batch = _spRenderList_addBatch(internal, region->page, slot->data->blendMode);
+			}
+
+			CONST_CAST(void*, self->vertices) = _spRenderList_grow(self->vertices, self->verticesCount, format->stride,
+					&internal->verticesCapacity, self->verticesCount + outCount);
+		}
+		vertex = (char*)self->vertices + first * format->stride;
+		first += outCount;
+
+		if (format->triangleList) {
+			/* Vertices are repeated for each triangle, so the world vertices are computed once into the scratch buffer. */
+			internal->worldVertices = (float*)_spRenderList_grow(internal->worldVertices, 0, sizeof(float),
+					&internal->worldVerticesCapacity, verticesCount << 1);
+			_spRenderList_computeWorldVertices(slot, internal->worldVertices, 0, 2);
+			positions = internal->worldVertices;
+			positionsStride = 2;
+		} else {
+			/* The world vertices are written directly to the vertex positions. */
+			positions = (float*)(vertex + format->positionOffset);
+			positionsStride = format->stride / (int)sizeof(float);
+			_spRenderList_computeWorldVertices(slot, (float*)(vertex + format->positionOffset), 0, positionsStride);
+		}
+
+		for (ii = 0; ii < outCount; ++ii, vertex += format->stride) {
+			int index = format->triangleList ? triangles[ii] : ii;
+			const float* position = positions + index * positionsStride;
+			float x = position[0], y = position[1];
+			if (format->triangleList) {
+				float* out = (float*)(vertex + format->positionOffset);
+				out[0] = x;
+				out[1] = y;
+			}
+			if (x < self->minX) CONST_CAST(float, self->minX) = x;
+			if (x > self->maxX) CONST_CAST(float, self->maxX) = x;
+			if (y < self->minY) CONST_CAST(float, self->minY) = y;
+			if (y > self->maxY) CONST_CAST(float, self->maxY) = y;
+			if (!update && format->uvOffset >= 0) {
+				float* uv = (float*)(vertex + format->uvOffset);
+				uv[0] = uvs[index << 1];
+				uv[1] = uvs[(index << 1) + 1];
+			}
+			if (colorSize) memcpy(vertex + format->colorOffset, color, colorSize);
+		}
+
+		if (update) continue;
+
+		if (!format->triangleList) {
+			CONST_CAST(void*, self->indices) = _spRenderList_grow(self->indices, self->indicesCount, format->indexSize,
+					&internal->indicesCapacity, self->indicesCount + trianglesCount);
+			if (format->indexSize == 2) {
+				unsigned short* indices = (unsigned short*)self->indices + self->indicesCount;
+				for (ii = 0; ii < trianglesCount; ++ii)
+					indices[ii] = (unsigned short)(triangles[ii] + batch->verticesCount);
+			} else {
+				unsigned int* indices = (unsigned int*)self->indices + self->indicesCount;
+				for (ii = 0; ii < trianglesCount; ++ii)
+					indices[ii] = (unsigned int)(triangles[ii] + batch->verticesCount);
+			}
+			CONST_CAST(int, self->indicesCount) += trianglesCount;
+			batch->indicesCount += trianglesCount;
+		}
+		CONST_CAST(int, self->verticesCount) += outCount;
+		batch->verticesCount += outCount;
+	}
+	return !update || first == self->verticesCount;
+}
+
+void spRenderList_addSkeleton (spRenderList* self, const spSkeleton* skeleton) {
+	SUB_CAST(_spRenderList, self)->retainedSkeleton = 0;
+	_spRenderList_writeSkeleton(SUB_CAST(_spRenderList, self), skeleton, 0);
+}
+
+int spRenderList_updateSkeleton (spRenderList* self, const spSkeleton* skeleton) {
+	_spRenderList* internal = SUB_CAST(_spRenderList, self);
+	int version = spSkeleton_getTopologyVersion(skeleton);
+	if (internal->retainedSkeleton == skeleton && internal->retainedData == skeleton->data
+			&& internal->retainedVersion == version) {
+		_spRenderList_clearBounds(self);
+		if (_spRenderList_writeSkeleton(internal, skeleton, 1)) return 0;
+	}
+
+	spRenderList_clear(self);
+	_spRenderList_writeSkeleton(internal, skeleton, 0);
+	internal->retainedSkeleton = skeleton;
+	internal->retainedData = skeleton->data;
+	internal->retainedVersion = version;
+	return 1;
+}
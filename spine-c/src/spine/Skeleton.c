@@ -31,6 +31,7 @@
 
 #include <spine/Skeleton.h>
 #include <string.h>
+#include <stddef.h>
 #include <spine/extension.h>
 
 typedef struct {
@@ -39,48 +40,159 @@ typedef struct {
 	int boneCacheCount;
 	int* boneCacheCounts;
 	spBone*** boneCache;
+	spBone** boneCacheBones;
+
+	int* cache; /* Holds the indices and epochs, see _spSkeleton_computeCache. */
+	int* boneParentIndices;
+	int* boneIkIndices; /* Index of the IK constraint whose bone chain contains the bone, or -1. */
+	int* ikParentIndices;
+	int* ikChildIndices;
+	int* ikTargetIndices;
+
+	int worldEpoch;
+	int* boneEpochs;
+	int* ikEpochs;
+
+	int topologyVersion;
+
+	spBone* boneBlock;
+	_spSlot* slotBlock;
+	spIkConstraint* ikConstraintBlock;
+	spBone** ikConstraintBones;
 } _spSkeleton;
 
+/* The cache holds boneCacheCounts, boneParentIndices, boneIkIndices, boneEpochs, ikParentIndices, ikChildIndices,
+ * ikTargetIndices and ikEpochs, in that order. */
+int _spSkeleton_getCacheSize (int bonesCount, int ikConstraintsCount) {
+	return ikConstraintsCount + 1 + bonesCount * 3 + ikConstraintsCount * 4;
+}
+
+static void _spSkeleton_setCache (_spSkeleton* internal, int* cache, int bonesCount, int ikConstraintsCount) {
+	internal->cache = cache;
+	internal->boneCacheCount = ikConstraintsCount + 1;
+	internal->boneCacheCounts = cache;
+	internal->boneParentIndices = internal->boneCacheCounts + internal->boneCacheCount;
+	internal->boneIkIndices = internal->boneParentIndices + bonesCount;
+	internal->boneEpochs = internal->boneIkIndices + bonesCount;
+	internal->ikParentIndices = internal->boneEpochs + bonesCount;
+	internal->ikChildIndices = internal->ikParentIndices + ikConstraintsCount;
+	internal->ikTargetIndices = internal->ikChildIndices + ikConstraintsCount;
+	internal->ikEpochs = internal->ikTargetIndices + ikConstraintsCount;
+}
+
+/* Returns the index of the first IK constraint whose bone chain contains the bone or one of its ancestors, or -1. */
+static int _spSkeleton_findIkLevel (const _spSkeleton* layout, int ikConstraintsCount, int boneIndex) {
+	int i, child, current = boneIndex;
+	do {
+		for (i = 0; i < ikConstraintsCount; ++i) {
+			child = layout->ikChildIndices[i];
+			while (1) {
+				if (current == child) return i;
+				if (child == layout->ikParentIndices[i]) break;
+				child = layout->boneParentIndices[child];
+			}
+		}
+		current = layout->boneParentIndices[current];
+	} while (current != -1);
+	return -1;
+}
+
+int _spSkeleton_computeCache (int* cache, int* boneCacheIndices, int bonesCount, int ikConstraintsCount,
+		const int* boneParentIndices, const int* ikParentIndices, const int* ikChildIndices, const int* ikTargetIndices) {
+	int i, level, boneIndex, n = 0;
+	_spSkeleton layout;
+	_spSkeleton_setCache(&layout, cache, bonesCount, ikConstraintsCount);
+
+	if (bonesCount) memcpy(layout.boneParentIndices, boneParentIndices, sizeof(int) * bonesCount);
+	if (ikConstraintsCount) {
+		memcpy(layout.ikParentIndices, ikParentIndices, sizeof(int) * ikConstraintsCount);
+		memcpy(layout.ikChildIndices, ikChildIndices, sizeof(int) * ikConstraintsCount);
+		memcpy(layout.ikTargetIndices, ikTargetIndices, sizeof(int) * ikConstraintsCount);
+	}
+
+	/* Bones affected by an IK constraint are updated before it is applied and again after. The IK constraint of each bone is
+	 * kept in boneEpochs until the levels are populated. */
+	memset(layout.boneCacheCounts, 0, sizeof(int) * layout.boneCacheCount);
+	for (i = 0; i < bonesCount; ++i) {
+		level = _spSkeleton_findIkLevel(&layout, ikConstraintsCount, i);
+		layout.boneEpochs[i] = level;
+		if (level == -1)
+			layout.boneCacheCounts[0]++;
+		else {
+			layout.boneCacheCounts[level]++;
+			layout.boneCacheCounts[level + 1]++;
+		}
+	}
+	for (level = 0; level < layout.boneCacheCount; ++level) {
+		for (i = 0; i < bonesCount; ++i) {
+			int ikIndex = layout.boneEpochs[i];
+			if (ikIndex == -1 ? level == 0 : level == ikIndex || level == ikIndex + 1) boneCacheIndices[n++] = i;
+		}
+	}
+
+	/* Index IK constraint chains for spSkeleton_updateBoneWorldTransform. */
+	for (i = 0; i < bonesCount; ++i)
+		layout.boneIkIndices[i] = -1;
+	for (i = 0; i < ikConstraintsCount; ++i) {
+		boneIndex = layout.ikChildIndices[i];
+		while (1) {
+			if (layout.boneIkIndices[boneIndex] == -1) layout.boneIkIndices[boneIndex] = i;
+			if (boneIndex == layout.ikParentIndices[i]) break;
+			boneIndex = layout.boneParentIndices[boneIndex];
+		}
+	}
+
+	memset(layout.boneEpochs, 0, sizeof(int) * bonesCount);
+	memset(layout.ikEpochs, 0, sizeof(int) * ikConstraintsCount);
+	return n;
+}
+
+/* Takes ownership of the cache and resolves the bones of each level of the update order. */
+static void _spSkeleton_linkCache (_spSkeleton* internal, int* cache, const int* boneCacheIndices, int boneCacheIndicesCount) {
+	int i, n;
+	spSkeleton* self = SUPER(internal);
+	_spSkeleton_setCache(internal, cache, self->bonesCount, self->ikConstraintsCount);
+	internal->boneCache = MALLOC(spBone**, internal->boneCacheCount);
+	internal->boneCacheBones = MALLOC(spBone*, boneCacheIndicesCount);
+	for (i = 0; i < boneCacheIndicesCount; ++i)
+		internal->boneCacheBones[i] = self->bones[boneCacheIndices[i]];
+	for (i = 0, n = 0; i < internal->boneCacheCount; n += internal->boneCacheCounts[i++])
+		internal->boneCache[i] = internal->boneCacheBones + n;
+}
+
 spSkeleton* spSkeleton_create (spSkeletonData* data) {
-	int i, ii;
+	int i, ii, n;
+	int* cache;
+	_spSkeletonData* dataInternal = SUB_CAST(_spSkeletonData, data);
 
 	_spSkeleton* internal = NEW(_spSkeleton);
 	spSkeleton* self = SUPER(internal);
 	CONST_CAST(spSkeletonData*, self->data) = data;
 
-	self->bonesCount = self->data->bonesCount;
-	self->bones = MALLOC(spBone*, self->bonesCount);
+	_spSkeletonData_validateCache(data);
 
+	/* Bones, slots and IK constraints are copied from the skeleton data's template, then linked by index. */
+	self->bonesCount = data->bonesCount;
+	self->bones = MALLOC(spBone*, self->bonesCount);
+	internal->boneBlock = MALLOC(spBone, self->bonesCount);
+	memcpy((void*)internal->boneBlock, dataInternal->bones, sizeof(spBone) * self->bonesCount);
 	for (i = 0; i < self->bonesCount; ++i) {
-		spBoneData* boneData = self->data->bones[i];
-		spBone* parent = 0;
-		if (boneData->parent) {
-			/* Find parent bone. */
-			for (ii = 0; ii < self->bonesCount; ++ii) {
-				if (data->bones[ii] == boneData->parent) {
-					parent = self->bones[ii];
-					break;
-				}
-			}
-		}
-		self->bones[i] = spBone_create(boneData, self, parent);
+		spBone* bone = internal->boneBlock + i;
+		int parentIndex = dataInternal->boneParentIndices[i];
+		CONST_CAST(spSkeleton*, bone->skeleton) = self;
+		CONST_CAST(spBone*, bone->parent) = parentIndex == -1 ? 0 : internal->boneBlock + parentIndex;
+		self->bones[i] = bone;
 	}
 	CONST_CAST(spBone*, self->root) = self->bones[0];
 
 	self->slotsCount = data->slotsCount;
 	self->slots = MALLOC(spSlot*, self->slotsCount);
+	internal->slotBlock = MALLOC(_spSlot, self->slotsCount);
+	memcpy((void*)internal->slotBlock, dataInternal->slots, sizeof(_spSlot) * self->slotsCount);
 	for (i = 0; i < self->slotsCount; ++i) {
-		spSlotData *slotData = data->slots[i];
-
-		/* Find bone for the slotData's boneData. */
-		spBone* bone = 0;
-		for (ii = 0; ii < self->bonesCount; ++ii) {
-			if (data->bones[ii] == slotData->boneData) {
-				bone = self->bones[ii];
-				break;
-			}
-		}
-		self->slots[i] = spSlot_create(slotData, bone);
+		spSlot* slot = &internal->slotBlock[i].super;
+		CONST_CAST(spBone*, slot->bone) = self->bones[dataInternal->slotBoneIndices[i]];
+		self->slots[i] = slot;
 	}
 
 	self->drawOrder = MALLOC(spSlot*, self->slotsCount);
@@ -90,14 +202,34 @@ spSkeleton* spSkeleton_create (spSkeletonData* data) {
 	self->g = 1;
 	self->b = 1;
 	self->a = 1;
+	self->yDown = spBone_isYDown();
 
 	self->ikConstraintsCount = data->ikConstraintsCount;
 	self->ikConstraints = MALLOC(spIkConstraint*, self->ikConstraintsCount);
-	for (i = 0; i < self->data->ikConstraintsCount; ++i)
-		self->ikConstraints[i] = spIkConstraint_create(self->data->ikConstraints[i], self);
+	internal->ikConstraintBlock = CALLOC(spIkConstraint, self->ikConstraintsCount);
+	internal->ikConstraintBones = MALLOC(spBone*, dataInternal->ikConstraintBonesCount);
+	for (i = 0, n = 0; i < self->ikConstraintsCount; ++i) {
+		spIkConstraintData* ikConstraintData = data->ikConstraints[i];
+		spIkConstraint* ikConstraint = internal->ikConstraintBlock + i;
+		CONST_CAST(spIkConstraintData*, ikConstraint->data) = ikConstraintData;
+		ikConstraint->bendDirection = ikConstraintData->bendDirection;
+		ikConstraint->mix = ikConstraintData->mix;
+		ikConstraint->bonesCount = ikConstraintData->bonesCount;
+		ikConstraint->bones = internal->ikConstraintBones + n;
+		for (ii = 0; ii < ikConstraint->bonesCount; ++ii)
+			ikConstraint->bones[ii] = self->bones[dataInternal->ikConstraintBoneIndices[n++]];
+		ikConstraint->target = self->bones[dataInternal->ikConstraintTargetIndices[i]];
+		self->ikConstraints[i] = ikConstraint;
+	}
 
-	spSkeleton_updateCache(self);
+	/* The update order and indices are computed once by the skeleton data. */
+	internal->worldEpoch = 1;
+	n = _spSkeleton_getCacheSize(self->bonesCount, self->ikConstraintsCount);
+	cache = MALLOC(int, n);
+	memcpy(cache, dataInternal->skeletonCache, sizeof(int) * n);
+	_spSkeleton_linkCache(internal, cache, dataInternal->boneCacheIndices, dataInternal->boneCacheIndicesCount);
 
+	spSkeleton_invalidateTopology(self);
 	return self;
 }
 
@@ -105,92 +237,76 @@ void spSkeleton_dispose (spSkeleton* self) {
 	int i;
 	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
 
-	for (i = 0; i < internal->boneCacheCount; ++i)
-		FREE(internal->boneCache[i]);
 	FREE(internal->boneCache);
-	FREE(internal->boneCacheCounts);
+	FREE(internal->boneCacheBones);
+	FREE(internal->cache);
 
-	for (i = 0; i < self->bonesCount; ++i)
-		spBone_dispose(self->bones[i]);
+	FREE(internal->boneBlock);
 	FREE(self->bones);
 
 	for (i = 0; i < self->slotsCount; ++i)
-		spSlot_dispose(self->slots[i]);
+		FREE(self->slots[i]->attachmentVertices);
+	FREE(internal->slotBlock);
 	FREE(self->slots);
 
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		spIkConstraint_dispose(self->ikConstraints[i]);
+	FREE(internal->ikConstraintBones);
+	FREE(internal->ikConstraintBlock);
 	FREE(self->ikConstraints);
 
 	FREE(self->drawOrder);
 	FREE(self);
 }
 
+static int _spSkeleton_indexOfBone (const spSkeleton* self, const spBone* bone) {
+	int i;
+	for (i = 0; i < self->bonesCount; ++i)
+		if (self->bones[i] == bone) return i;
+	return -1;
+}
+
 void spSkeleton_updateCache (const spSkeleton* self) {
-	int i, ii;
+	int i, ii, n;
 	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	int* cache = MALLOC(int, _spSkeleton_getCacheSize(self->bonesCount, self->ikConstraintsCount));
+	int* boneCacheIndices = MALLOC(int, self->bonesCount * 2);
+	int* boneParentIndices = MALLOC(int, self->bonesCount + self->ikConstraintsCount * 3);
+	int* ikParentIndices = boneParentIndices + self->bonesCount;
+	int* ikChildIndices = ikParentIndices + self->ikConstraintsCount;
+	int* ikTargetIndices = ikChildIndices + self->ikConstraintsCount;
 
-	for (i = 0; i < internal->boneCacheCount; ++i)
-		FREE(internal->boneCache[i]);
-	FREE(internal->boneCache);
-	FREE(internal->boneCacheCounts);
-
-	internal->boneCacheCount = self->ikConstraintsCount + 1;
-	internal->boneCache = MALLOC(spBone**, internal->boneCacheCount);
-	internal->boneCacheCounts = CALLOC(int, internal->boneCacheCount);
-
-	/* Compute array sizes. */
 	for (i = 0; i < self->bonesCount; ++i) {
-		spBone* current = self->bones[i];
-		do {
-			for (ii = 0; ii < self->ikConstraintsCount; ++ii) {
-				spIkConstraint* ikConstraint = self->ikConstraints[ii];
-				spBone* parent = ikConstraint->bones[0];
-				spBone* child = ikConstraint->bones[ikConstraint->bonesCount - 1];
-				while (1) {
-					if (current == child) {
-						internal->boneCacheCounts[ii]++;
-						internal->boneCacheCounts[ii + 1]++;
-						goto outer1;
-					}
-					if (child == parent) break;
-					child = child->parent;
-				}
+		spBone* parent = self->bones[i]->parent;
+		boneParentIndices[i] = -1;
+		/* Parents usually precede their children, so search backward first. */
+		for (ii = i - 1; parent && ii >= 0; --ii) {
+			if (self->bones[ii] == parent) {
+				boneParentIndices[i] = ii;
+				parent = 0;
 			}
-			current = current->parent;
-		} while (current);
-		internal->boneCacheCounts[0]++;
-		outer1: {}
+		}
+		for (ii = i + 1; parent && ii < self->bonesCount; ++ii) {
+			if (self->bones[ii] == parent) {
+				boneParentIndices[i] = ii;
+				parent = 0;
+			}
+		}
+	}
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		spIkConstraint* ikConstraint = self->ikConstraints[i];
+		ikParentIndices[i] = _spSkeleton_indexOfBone(self, ikConstraint->bones[0]);
+		ikChildIndices[i] = _spSkeleton_indexOfBone(self, ikConstraint->bones[ikConstraint->bonesCount - 1]);
+		ikTargetIndices[i] = _spSkeleton_indexOfBone(self, ikConstraint->target);
 	}
 
-	for (i = 0; i < internal->boneCacheCount; ++i)
-		internal->boneCache[i] = MALLOC(spBone*, internal->boneCacheCounts[i]);
-	memset(internal->boneCacheCounts, 0, internal->boneCacheCount * sizeof(int));
+	n = _spSkeleton_computeCache(cache, boneCacheIndices, self->bonesCount, self->ikConstraintsCount, boneParentIndices,
+			ikParentIndices, ikChildIndices, ikTargetIndices);
+	FREE(boneParentIndices);
 
-	/* Populate arrays. */
-	for (i = 0; i < self->bonesCount; ++i) {
-		spBone* bone = self->bones[i];
-		spBone* current = bone;
-		do {
-			for (ii = 0; ii < self->ikConstraintsCount; ++ii) {
-				spIkConstraint* ikConstraint = self->ikConstraints[ii];
-				spBone* parent = ikConstraint->bones[0];
-				spBone* child = ikConstraint->bones[ikConstraint->bonesCount - 1];
-				while (1) {
-					if (current == child) {
-						internal->boneCache[ii][internal->boneCacheCounts[ii]++] = bone;
-						internal->boneCache[ii + 1][internal->boneCacheCounts[ii + 1]++] = bone;
-						goto outer2;
-					}
-					if (child == parent) break;
-					child = child->parent;
-				}
-			}
-			current = current->parent;
-		} while (current);
-		internal->boneCache[0][internal->boneCacheCounts[0]++] = bone;
-		outer2: {}
-	}
+	FREE(internal->boneCache);
+	FREE(internal->boneCacheBones);
+	FREE(internal->cache);
+	_spSkeleton_linkCache(internal, cache, boneCacheIndices, n);
+	FREE(boneCacheIndices);
 }
 
 void spSkeleton_updateWorldTransform (const spSkeleton* self) {
@@ -211,6 +327,85 @@ void spSkeleton_updateWorldTransform (const spSkeleton* self) {
 	}
 }
 
+void spSkeleton_invalidateWorldTransform (const spSkeleton* self) {
+	SUB_CAST(_spSkeleton, self)->worldEpoch++;
+}
+
+/* Shared by all skeletons, so a skeleton created at the address of a disposed one never has the same version. */
+static volatile int _spSkeleton_lastTopologyVersion = 0;
+
+int spSkeleton_getTopologyVersion (const spSkeleton* self) {
+	return SUB_CAST(_spSkeleton, self)->topologyVersion;
+}
+
+void spSkeleton_invalidateTopology (const spSkeleton* self) {
+	SUB_CAST(_spSkeleton, self)->topologyVersion = _spAtomic_add(&_spSkeleton_lastTopologyVersion, 1);
+}
+
+static void _spSkeleton_updateBone (_spSkeleton* internal, int boneIndex);
+
+/* Updates the bones from the child bone of an IK constraint up to its parent bone, parents first. */
+static void _spSkeleton_updateIkChain (_spSkeleton* internal, int boneIndex, int parentIndex, int/*bool*/resetRotation) {
+	spBone* bone = SUPER(internal)->bones[boneIndex];
+	if (boneIndex != parentIndex)
+		_spSkeleton_updateIkChain(internal, internal->boneParentIndices[boneIndex], parentIndex, resetRotation);
+	if (resetRotation)
+		bone->rotationIK = bone->rotation;
+	else
+		internal->boneEpochs[boneIndex] = internal->worldEpoch;
+	spBone_updateWorldTransform(bone);
+}
+
+static void _spSkeleton_updateIkConstraint (_spSkeleton* internal, int ikIndex) {
+	int parentIndex = internal->ikParentIndices[ikIndex], childIndex = internal->ikChildIndices[ikIndex];
+	if (internal->ikEpochs[ikIndex] == internal->worldEpoch) return;
+	internal->ikEpochs[ikIndex] = internal->worldEpoch;
+
+	if (internal->boneParentIndices[parentIndex] != -1)
+		_spSkeleton_updateBone(internal, internal->boneParentIndices[parentIndex]);
+	_spSkeleton_updateIkChain(internal, childIndex, parentIndex, 1);
+	_spSkeleton_updateBone(internal, internal->ikTargetIndices[ikIndex]);
+	spIkConstraint_apply(SUPER(internal)->ikConstraints[ikIndex]);
+	_spSkeleton_updateIkChain(internal, childIndex, parentIndex, 0);
+}
+
+static void _spSkeleton_updateBone (_spSkeleton* internal, int boneIndex) {
+	spBone* bone;
+	if (internal->boneEpochs[boneIndex] == internal->worldEpoch) return;
+
+	if (internal->boneIkIndices[boneIndex] != -1) {
+		_spSkeleton_updateIkConstraint(internal, internal->boneIkIndices[boneIndex]);
+		return;
+	}
+
+	if (internal->boneParentIndices[boneIndex] != -1) _spSkeleton_updateBone(internal, internal->boneParentIndices[boneIndex]);
+	bone = SUPER(internal)->bones[boneIndex];
+	bone->rotationIK = bone->rotation;
+	spBone_updateWorldTransform(bone);
+	internal->boneEpochs[boneIndex] = internal->worldEpoch;
+}
+
+void spSkeleton_updateBoneWorldTransform (const spSkeleton* self, int boneIndex) {
+	_spSkeleton_updateBone(SUB_CAST(_spSkeleton, self), boneIndex);
+}
+
+static void _spSkeleton_maskBone (const _spSkeleton* internal, int boneIndex, int* bonesMask) {
+	while (boneIndex != -1 && !bonesMask[boneIndex]) {
+		int ikIndex = internal->boneIkIndices[boneIndex];
+		bonesMask[boneIndex] = 1;
+		if (ikIndex != -1) {
+			/* The whole chain of the IK constraint and its target are needed to pose the bone. */
+			_spSkeleton_maskBone(internal, internal->ikChildIndices[ikIndex], bonesMask);
+			_spSkeleton_maskBone(internal, internal->ikTargetIndices[ikIndex], bonesMask);
+		}
+		boneIndex = internal->boneParentIndices[boneIndex];
+	}
+}
+
+void spSkeleton_maskBone (const spSkeleton* self, int boneIndex, int* bonesMask) {
+	_spSkeleton_maskBone(SUB_CAST(_spSkeleton, self), boneIndex, bonesMask);
+}
+
 void spSkeleton_setToSetupPose (const spSkeleton* self) {
 	spSkeleton_setBonesToSetupPose(self);
 	spSkeleton_setSlotsToSetupPose(self);
@@ -230,9 +425,25 @@ void spSkeleton_setBonesToSetupPose (const spSkeleton* self) {
 
 void spSkeleton_setSlotsToSetupPose (const spSkeleton* self) {
 	int i;
-	memcpy(self->drawOrder, self->slots, self->slotsCount * sizeof(spSlot*));
-	for (i = 0; i < self->slotsCount; ++i)
-		spSlot_setToSetupPose(self->slots[i]);
+	_spSkeletonData* dataInternal = SUB_CAST(_spSkeletonData, self->data);
+	if (memcmp(self->drawOrder, self->slots, self->slotsCount * sizeof(spSlot*)) != 0) {
+		memcpy(self->drawOrder, self->slots, self->slotsCount * sizeof(spSlot*));
+		spSkeleton_invalidateTopology(self);
+	}
+	_spSkeletonData_validateCache(self->data);
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		spAttachment* attachment = 0;
+		slot->r = slot->data->r;
+		slot->g = slot->data->g;
+		slot->b = slot->data->b;
+		slot->a = slot->data->a;
+		if (!self->skin)
+			attachment = dataInternal->slots[i].super.attachment;
+		else if (slot->data->attachmentName) /**/
+			attachment = spSkeleton_getAttachmentForSlotIndex(self, i, slot->data->attachmentName);
+		spSlot_setAttachment(slot, attachment);
+	}
 }
 
 spBone* spSkeleton_findBone (const spSkeleton* self, const char* boneName) {
@@ -291,6 +502,7 @@ void spSkeleton_setSkin (spSkeleton* self, spSkin* newSkin) {
 			}
 		}
 	}
+	if (newSkin != self->skin) spSkeleton_invalidateTopology(self);
 	CONST_CAST(spSkin*, self->skin) = newSkin;
 }
 
@@ -340,3 +552,170 @@ spIkConstraint* spSkeleton_findIkConstraint (const spSkeleton* self, const char*
 void spSkeleton_update (spSkeleton* self, float deltaTime) {
 	self->time += deltaTime;
 }
+
+/**/
+
+#define BONE_POSE_SIZE (sizeof(spBone) - offsetof(spBone, x))
+
+typedef struct {
+	float r, g, b, a;
+	spAttachment* attachment;
+	int attachmentVerticesCount;
+} _spSlotPose;
+
+typedef struct {
+	float mix;
+	int bendDirection;
+} _spIkConstraintPose;
+
+int _spSkeleton_getPoseSize (const spSkeleton* self) {
+	int i;
+	int size = sizeof(_spSlotPose) * self->slotsCount + BONE_POSE_SIZE * self->bonesCount
+			+ sizeof(_spIkConstraintPose) * self->ikConstraintsCount + sizeof(int) * self->slotsCount;
+	for (i = 0; i < self->slotsCount; ++i)
+		size += sizeof(float) * self->slots[i]->attachmentVerticesCount;
+	return size;
+}
+
+void _spSkeleton_writePose (const spSkeleton* self, void* pose) {
+	int i;
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	_spSlotPose* slotPoses = (_spSlotPose*)pose;
+	char* bonePoses = (char*)(slotPoses + self->slotsCount);
+	_spIkConstraintPose* ikConstraintPoses = (_spIkConstraintPose*)(bonePoses + BONE_POSE_SIZE * self->bonesCount);
+	int* drawOrder = (int*)(ikConstraintPoses + self->ikConstraintsCount);
+	float* vertices = (float*)(drawOrder + self->slotsCount);
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		slotPoses[i].r = slot->r;
+		slotPoses[i].g = slot->g;
+		slotPoses[i].b = slot->b;
+		slotPoses[i].a = slot->a;
+		slotPoses[i].attachment = slot->attachment;
+		slotPoses[i].attachmentVerticesCount = slot->attachmentVerticesCount;
+		if (slot->attachmentVerticesCount)
+			memcpy(vertices, slot->attachmentVertices, sizeof(float) * slot->attachmentVerticesCount);
+		vertices += slot->attachmentVerticesCount;
+	}
+	for (i = 0; i < self->bonesCount; ++i)
+		memcpy(bonePoses + BONE_POSE_SIZE * i, &self->bones[i]->x, BONE_POSE_SIZE);
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		ikConstraintPoses[i].mix = self->ikConstraints[i]->mix;
+		ikConstraintPoses[i].bendDirection = self->ikConstraints[i]->bendDirection;
+	}
+	/* Slots live in the slot block, so a slot's index is its offset in the block. */
+	for (i = 0; i < self->slotsCount; ++i)
+		drawOrder[i] = (int)(SUB_CAST(_spSlot, self->drawOrder[i]) - internal->slotBlock);
+}
+
+void _spSkeleton_readPose (spSkeleton* self, const void* pose) {
+	int i;
+	const _spSlotPose* slotPoses = (const _spSlotPose*)pose;
+	const char* bonePoses = (const char*)(slotPoses + self->slotsCount);
+	const _spIkConstraintPose* ikConstraintPoses = (const _spIkConstraintPose*)(bonePoses + BONE_POSE_SIZE * self->bonesCount);
+	const int* drawOrder = (const int*)(ikConstraintPoses + self->ikConstraintsCount);
+	const float* vertices = (const float*)(drawOrder + self->slotsCount);
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		int verticesCount = slotPoses[i].attachmentVerticesCount;
+		slot->r = slotPoses[i].r;
+		slot->g = slotPoses[i].g;
+		slot->b = slotPoses[i].b;
+		slot->a = slotPoses[i].a;
+		if (slot->attachment != slotPoses[i].attachment) spSlot_setAttachment(slot, slotPoses[i].attachment);
+		if (slot->attachmentVerticesCapacity < verticesCount) {
+			FREE(slot->attachmentVertices);
+			slot->attachmentVertices = MALLOC(float, verticesCount);
+			slot->attachmentVerticesCapacity = verticesCount;
+		}
+		slot->attachmentVerticesCount = verticesCount;
+		if (verticesCount) memcpy(slot->attachmentVertices, vertices, sizeof(float) * verticesCount);
+		vertices += verticesCount;
+	}
+	for (i = 0; i < self->bonesCount; ++i)
+		memcpy((void*)&self->bones[i]->x, bonePoses + BONE_POSE_SIZE * i, BONE_POSE_SIZE);
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		self->ikConstraints[i]->mix = ikConstraintPoses[i].mix;
+		self->ikConstraints[i]->bendDirection = ikConstraintPoses[i].bendDirection;
+	}
+	for (i = 0; i < self->slotsCount; ++i) {
+		if (self->drawOrder[i] == self->slots[drawOrder[i]]) continue;
+		self->drawOrder[i] = self->slots[drawOrder[i]];
+		spSkeleton_invalidateTopology(self);
+	}
+}
+
+/**/
+
+typedef struct {
+	int size;
+	int bonesCount, slotsCount, ikConstraintsCount;
+	spSkin* skin;
+	float r, g, b, a;
+	float time;
+	int/*bool*/flipX, flipY;
+	int/*bool*/yDown;
+	float x, y;
+} _spSkeletonSnapshot;
+
+int spSkeleton_getSnapshotSize (const spSkeleton* self) {
+	return sizeof(_spSkeletonSnapshot) + _spSkeleton_getPoseSize(self) + sizeof(float) * self->slotsCount;
+}
+
+int spSkeleton_snapshot (const spSkeleton* self, void* buffer) {
+	int i, poseSize = _spSkeleton_getPoseSize(self);
+	_spSkeletonSnapshot* snapshot = (_spSkeletonSnapshot*)buffer;
+	char* pose = (char*)(snapshot + 1);
+	float* attachmentTimes = (float*)(pose + poseSize);
+
+	snapshot->size = sizeof(_spSkeletonSnapshot) + poseSize + sizeof(float) * self->slotsCount;
+	snapshot->bonesCount = self->bonesCount;
+	snapshot->slotsCount = self->slotsCount;
+	snapshot->ikConstraintsCount = self->ikConstraintsCount;
+	snapshot->skin = self->skin;
+	snapshot->r = self->r;
+	snapshot->g = self->g;
+	snapshot->b = self->b;
+	snapshot->a = self->a;
+	snapshot->time = self->time;
+	snapshot->flipX = self->flipX;
+	snapshot->flipY = self->flipY;
+	snapshot->yDown = self->yDown;
+	snapshot->x = self->x;
+	snapshot->y = self->y;
+
+	_spSkeleton_writePose(self, pose);
+	for (i = 0; i < self->slotsCount; ++i)
+		attachmentTimes[i] = SUB_CAST(_spSlot, self->slots[i])->attachmentTime;
+	return snapshot->size;
+}
+
+int spSkeleton_restore (spSkeleton* self, const void* buffer) {
+	int i;
+	const _spSkeletonSnapshot* snapshot = (const _spSkeletonSnapshot*)buffer;
+	const char* pose = (const char*)(snapshot + 1);
+	const float* attachmentTimes = (const float*)((const char*)buffer + snapshot->size) - self->slotsCount;
+
+	if (snapshot->bonesCount != self->bonesCount || snapshot->slotsCount != self->slotsCount
+			|| snapshot->ikConstraintsCount != self->ikConstraintsCount) return 0;
+
+	CONST_CAST(spSkin*, self->skin) = snapshot->skin;
+	self->r = snapshot->r;
+	self->g = snapshot->g;
+	self->b = snapshot->b;
+	self->a = snapshot->a;
+	self->time = snapshot->time;
+	self->flipX = snapshot->flipX;
+	self->flipY = snapshot->flipY;
+	self->yDown = snapshot->yDown;
+	self->x = snapshot->x;
+	self->y = snapshot->y;
+
+	_spSkeleton_readPose(self, pose);
+	for (i = 0; i < self->slotsCount; ++i)
+		SUB_CAST(_spSlot, self->slots[i])->attachmentTime = attachmentTimes[i];
+	spSkeleton_invalidateWorldTransform(self);
+	return snapshot->size;
+}
@@ -34,11 +34,69 @@
 #include <spine/extension.h>
 
 spSkeletonData* spSkeletonData_create () {
-	return NEW(spSkeletonData);
+	return SUPER(NEW(_spSkeletonData));
+}
+
+static void _spSkeletonData_disposeCache (_spSkeletonData* self) {
+	FREE(self->bones);
+	FREE(self->boneParentIndices);
+	FREE(self->slots);
+	FREE(self->slotBoneIndices);
+	FREE(self->ikConstraintBoneIndices);
+	FREE(self->ikConstraintTargetIndices);
+	FREE(self->skeletonCache);
+	FREE(self->boneCacheIndices);
+}
+
+void _spSkeletonData_internStrings (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	_spStringPool* strings;
+	int i;
+
+	if (!internal->strings) internal->strings = _spStringPool_create();
+	strings = internal->strings;
+	for (i = 0; i < self->bonesCount; ++i)
+		_spStringPool_intern(strings, &CONST_CAST(const char*, self->bones[i]->name));
+	for (i = 0; i < self->slotsCount; ++i)
+		_spStringPool_intern(strings, &CONST_CAST(const char*, self->slots[i]->name));
+	for (i = 0; i < self->skinsCount; ++i)
+		_spSkin_internStrings(self->skins[i], strings);
+	for (i = 0; i < self->eventsCount; ++i) {
+		_spStringPool_intern(strings, &CONST_CAST(const char*, self->events[i]->name));
+		_spStringPool_intern(strings, &self->events[i]->stringValue);
+	}
+	for (i = 0; i < self->animationsCount; ++i)
+		_spStringPool_intern(strings, &CONST_CAST(const char*, self->animations[i]->name));
+	for (i = 0; i < self->ikConstraintsCount; ++i)
+		_spStringPool_intern(strings, &CONST_CAST(const char*, self->ikConstraints[i]->name));
+}
+
+/* Clears the pooled strings, so disposing the objects doesn't free them. Attachment timelines know the pool. */
+static void _spSkeletonData_releaseStrings (spSkeletonData* self) {
+	const _spStringPool* strings = SUB_CAST(_spSkeletonData, self)->strings;
+	int i;
+	for (i = 0; i < self->bonesCount; ++i)
+		_spStringPool_release(strings, &CONST_CAST(const char*, self->bones[i]->name));
+	for (i = 0; i < self->slotsCount; ++i)
+		_spStringPool_release(strings, &CONST_CAST(const char*, self->slots[i]->name));
+	for (i = 0; i < self->skinsCount; ++i)
+		_spSkin_releaseStrings(self->skins[i], strings);
+	for (i = 0; i < self->eventsCount; ++i) {
+		_spStringPool_release(strings, &CONST_CAST(const char*, self->events[i]->name));
+		_spStringPool_release(strings, &self->events[i]->stringValue);
+	}
+	for (i = 0; i < self->animationsCount; ++i)
+		_spStringPool_release(strings, &CONST_CAST(const char*, self->animations[i]->name));
+	for (i = 0; i < self->ikConstraintsCount; ++i)
+		_spStringPool_release(strings, &CONST_CAST(const char*, self->ikConstraints[i]->name));
 }
 
 void spSkeletonData_dispose (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
 	int i;
+
+	if (internal->strings) _spSkeletonData_releaseStrings(self);
+	_spSkeletonData_disposeCache(internal);
 	for (i = 0; i < self->bonesCount; ++i)
 		spBoneData_dispose(self->bones[i]);
 	FREE(self->bones);
@@ -58,6 +116,7 @@ void spSkeletonData_dispose (spSkeletonData* self) {
 	for (i = 0; i < self->animationsCount; ++i)
 		spAnimation_dispose(self->animations[i]);
 	FREE(self->animations);
+	if (internal->animationDecoder) internal->animationDecoder->dispose(internal->animationDecoder);
 
 	for (i = 0; i < self->ikConstraintsCount; ++i)
 		spIkConstraintData_dispose(self->ikConstraints[i]);
@@ -66,6 +125,8 @@ void spSkeletonData_dispose (spSkeletonData* self) {
 	FREE(self->hash);
 	FREE(self->version);
 
+	/* Last, the attachment timelines check the pool when disposed. */
+	if (internal->strings) _spStringPool_dispose(internal->strings);
 	FREE(self);
 }
 
@@ -113,14 +174,116 @@ spEventData* spSkeletonData_findEvent (const spSkeletonData* self, const char* e
 
 spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const char* animationName) {
 	int i;
-	for (i = 0; i < self->animationsCount; ++i)
-		if (strcmp(self->animations[i]->name, animationName) == 0) return self->animations[i];
+	for (i = 0; i < self->animationsCount; ++i) {
+		if (strcmp(self->animations[i]->name, animationName) == 0) {
+			spAnimation_decode(self->animations[i]);
+			return self->animations[i];
+		}
+	}
 	return 0;
 }
 
+int spSkeletonData_getAnimationsMemory (const spSkeletonData* self) {
+	_spAnimationDecoder* decoder = SUB_CAST(_spSkeletonData, self)->animationDecoder;
+	return decoder ? _spAtomic_get(&decoder->memoryUsed) : 0;
+}
+
+int spSkeletonData_getAttachmentsMemory (const spSkeletonData* self, spAttachmentType type) {
+	int i, memory = 0;
+	for (i = 0; i < self->skinsCount; ++i)
+		memory += _spSkin_getAttachmentsMemory(self->skins[i], type);
+	return memory;
+}
+
 spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self, const char* ikConstraintName) {
 	int i;
 	for (i = 0; i < self->ikConstraintsCount; ++i)
 		if (strcmp(self->ikConstraints[i]->name, ikConstraintName) == 0) return self->ikConstraints[i];
 	return 0;
 }
+
+static int _spSkeletonData_indexOfBone (const spSkeletonData* self, const spBoneData* boneData) {
+	int i;
+	for (i = 0; i < self->bonesCount; ++i)
+		if (self->bones[i] == boneData) return i;
+	return -1;
+}
+
+void spSkeletonData_updateCache (spSkeletonData* self) {
+	int i, ii, n;
+	int* ikParentIndices;
+	int* ikChildIndices;
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+
+	_spSkeletonData_disposeCache(internal);
+	internal->cacheValid = 1;
+	internal->cacheBonesCount = self->bonesCount;
+	internal->cacheSlotsCount = self->slotsCount;
+	internal->cacheIkConstraintsCount = self->ikConstraintsCount;
+
+	internal->bones = CALLOC(spBone, self->bonesCount);
+	internal->boneParentIndices = MALLOC(int, self->bonesCount);
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = internal->bones + i;
+		CONST_CAST(spBoneData*, bone->data) = self->bones[i];
+		spBone_setToSetupPose(bone);
+		internal->boneParentIndices[i] = -1;
+		if (self->bones[i]->parent) {
+			/* Parents usually precede their children. */
+			for (ii = i - 1; ii >= 0; --ii) {
+				if (self->bones[ii] == self->bones[i]->parent) {
+					internal->boneParentIndices[i] = ii;
+					break;
+				}
+			}
+			if (ii < 0) internal->boneParentIndices[i] = _spSkeletonData_indexOfBone(self, self->bones[i]->parent);
+		}
+	}
+
+	internal->slots = CALLOC(_spSlot, self->slotsCount);
+	internal->slotBoneIndices = MALLOC(int, self->slotsCount);
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlotData* slotData = self->slots[i];
+		spSlot* slot = &internal->slots[i].super;
+		CONST_CAST(spSlotData*, slot->data) = slotData;
+		slot->r = slotData->r;
+		slot->g = slotData->g;
+		slot->b = slotData->b;
+		slot->a = slotData->a;
+		if (slotData->attachmentName && self->defaultSkin)
+			CONST_CAST(spAttachment*, slot->attachment) = spSkin_getAttachment(self->defaultSkin, i, slotData->attachmentName);
+		internal->slotBoneIndices[i] = _spSkeletonData_indexOfBone(self, slotData->boneData);
+	}
+
+	for (i = 0, n = 0; i < self->ikConstraintsCount; ++i)
+		n += self->ikConstraints[i]->bonesCount;
+	internal->ikConstraintBonesCount = n;
+	internal->ikConstraintBoneIndices = MALLOC(int, n);
+	internal->ikConstraintTargetIndices = MALLOC(int, self->ikConstraintsCount);
+	for (i = 0, n = 0; i < self->ikConstraintsCount; ++i) {
+		spIkConstraintData* ikConstraintData = self->ikConstraints[i];
+		for (ii = 0; ii < ikConstraintData->bonesCount; ++ii)
+			internal->ikConstraintBoneIndices[n++] = _spSkeletonData_indexOfBone(self, ikConstraintData->bones[ii]);
+		internal->ikConstraintTargetIndices[i] = _spSkeletonData_indexOfBone(self, ikConstraintData->target);
+	}
+
+	/* The update order and bone indices copied by spSkeleton_create. */
+	ikParentIndices = MALLOC(int, self->ikConstraintsCount * 2);
+	ikChildIndices = ikParentIndices + self->ikConstraintsCount;
+	for (i = 0, n = 0; i < self->ikConstraintsCount; n += self->ikConstraints[i++]->bonesCount) {
+		ikParentIndices[i] = internal->ikConstraintBoneIndices[n];
+		ikChildIndices[i] = internal->ikConstraintBoneIndices[n + self->ikConstraints[i]->bonesCount - 1];
+	}
+	internal->skeletonCache = MALLOC(int, _spSkeleton_getCacheSize(self->bonesCount, self->ikConstraintsCount));
+	internal->boneCacheIndices = MALLOC(int, self->bonesCount * 2);
+	internal->boneCacheIndicesCount = _spSkeleton_computeCache(internal->skeletonCache, internal->boneCacheIndices,
+			self->bonesCount, self->ikConstraintsCount, internal->boneParentIndices, ikParentIndices, ikChildIndices,
+			internal->ikConstraintTargetIndices);
+	FREE(ikParentIndices);
+}
+
+void _spSkeletonData_validateCache (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	if (!internal->cacheValid || internal->cacheBonesCount != self->bonesCount || internal->cacheSlotsCount != self->slotsCount
+			|| internal->cacheIkConstraintsCount != self->ikConstraintsCount) spSkeletonData_updateCache(self);
+}
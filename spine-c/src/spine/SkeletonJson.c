@@ -31,7 +31,6 @@
 
 #include <spine/SkeletonJson.h>
 #include <stdio.h>
-#include <locale.h>
 #include "Json.h"
 #include <spine/extension.h>
 #include <spine/AtlasAttachmentLoader.h>
@@ -45,6 +44,7 @@ spSkeletonJson* spSkeletonJson_createWithLoader (spAttachmentLoader* attachmentL
 	spSkeletonJson* self = SUPER(NEW(_spSkeletonJson));
 	self->scale = 1;
 	self->attachmentLoader = attachmentLoader;
+	self->meshWeightBits = 16;
 	return self;
 }
 
@@ -62,13 +62,8 @@ void spSkeletonJson_dispose (spSkeletonJson* self) {
 }
 
 void _spSkeletonJson_setError (spSkeletonJson* self, Json* root, const char* value1, const char* value2) {
-	char message[256];
-	int length;
 	FREE(self->error);
-	strcpy(message, value1);
-	length = (int)strlen(value1);
-	if (value2) strncat(message + length, value2, 255 - length);
-	MALLOC_STR(self->error, message);
+	CONST_CAST(char*, self->error) = _formatError(value1, value2);
 	if (root) Json_dispose(root);
 }
 
@@ -103,9 +98,10 @@ static void readCurve (spCurveTimeline* timeline, int frameIndex, Json* frame) {
 	}
 }
 
-static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* root, spSkeletonData *skeletonData) {
+/* Sets the animation's timelines and the duration of the last frame. On failure the timelines are disposed of and error is set. */
+static int/*bool*/_spSkeletonJson_readTimelines (float scale, Json* root, spSkeletonData *skeletonData, spAnimation* animation,
+		float* animationDuration, char** error) {
 	int i;
-	spAnimation* animation;
 	Json* frame;
 	float duration;
 	int timelinesCount = 0;
@@ -134,9 +130,9 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 	if (flipX) ++timelinesCount;
 	if (flipY) ++timelinesCount;
 
-	animation = spAnimation_create(root->name, timelinesCount);
-	animation->timelinesCount = 0;
-	skeletonData->animations[skeletonData->animationsCount++] = animation;
+	_spAnimation_disposeTimelines(animation);
+	animation->timelines = MALLOC(spTimeline*, timelinesCount);
+	*animationDuration = 0;
 
 	/* Slot timelines. */
 	for (slotMap = slots ? slots->child : 0; slotMap; slotMap = slotMap->next) {
@@ -144,8 +140,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 
 		int slotIndex = spSkeletonData_findSlotIndex(skeletonData, slotMap->name);
 		if (slotIndex == -1) {
-			spAnimation_dispose(animation);
-			_spSkeletonJson_setError(self, root, "Slot not found: ", slotMap->name);
+			_spAnimation_disposeTimelines(animation);
+			*error = _formatError("Slot not found: ", slotMap->name);
 			return 0;
 		}
 
@@ -161,11 +157,12 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 				}
 				animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 				duration = timeline->frames[timelineArray->size * 5 - 5];
-				if (duration > animation->duration) animation->duration = duration;
+				if (duration > *animationDuration) *animationDuration = duration;
 
 			} else if (strcmp(timelineArray->name, "attachment") == 0) {
 				spAttachmentTimeline *timeline = spAttachmentTimeline_create(timelineArray->size);
 				timeline->slotIndex = slotIndex;
+				SUB_CAST(_spAttachmentTimeline, timeline)->strings = SUB_CAST(_spSkeletonData, skeletonData)->strings;
 				for (frame = timelineArray->child, i = 0; frame; frame = frame->next, ++i) {
 					Json* name = Json_getItem(frame, "name");
 					spAttachmentTimeline_setFrame(timeline, i, Json_getFloat(frame, "time", 0),
@@ -173,11 +170,11 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 				}
 				animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 				duration = timeline->frames[timelineArray->size - 1];
-				if (duration > animation->duration) animation->duration = duration;
+				if (duration > *animationDuration) *animationDuration = duration;
 
 			} else {
-				spAnimation_dispose(animation);
-				_spSkeletonJson_setError(self, 0, "Invalid timeline type for a slot: ", timelineArray->name);
+				_spAnimation_disposeTimelines(animation);
+				*error = _formatError("Invalid timeline type for a slot: ", timelineArray->name);
 				return 0;
 			}
 		}
@@ -189,8 +186,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 
 		int boneIndex = spSkeletonData_findBoneIndex(skeletonData, boneMap->name);
 		if (boneIndex == -1) {
-			spAnimation_dispose(animation);
-			_spSkeletonJson_setError(self, root, "Bone not found: ", boneMap->name);
+			_spAnimation_disposeTimelines(animation);
+			*error = _formatError("Bone not found: ", boneMap->name);
 			return 0;
 		}
 
@@ -204,23 +201,23 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 				}
 				animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 				duration = timeline->frames[timelineArray->size * 2 - 2];
-				if (duration > animation->duration) animation->duration = duration;
+				if (duration > *animationDuration) *animationDuration = duration;
 
 			} else {
 				int isScale = strcmp(timelineArray->name, "scale") == 0;
 				if (isScale || strcmp(timelineArray->name, "translate") == 0) {
-					float scale = isScale ? 1 : self->scale;
+					float timelineScale = isScale ? 1 : scale;
 					spTranslateTimeline *timeline =
 							isScale ? spScaleTimeline_create(timelineArray->size) : spTranslateTimeline_create(timelineArray->size);
 					timeline->boneIndex = boneIndex;
 					for (frame = timelineArray->child, i = 0; frame; frame = frame->next, ++i) {
-						spTranslateTimeline_setFrame(timeline, i, Json_getFloat(frame, "time", 0), Json_getFloat(frame, "x", 0) * scale,
-								Json_getFloat(frame, "y", 0) * scale);
+						spTranslateTimeline_setFrame(timeline, i, Json_getFloat(frame, "time", 0), Json_getFloat(frame, "x", 0) * timelineScale,
+								Json_getFloat(frame, "y", 0) * timelineScale);
 						readCurve(SUPER(timeline), i, frame);
 					}
 					animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 					duration = timeline->frames[timelineArray->size * 3 - 3];
-					if (duration > animation->duration) animation->duration = duration;
+					if (duration > *animationDuration) *animationDuration = duration;
 				} else if (strcmp(timelineArray->name, "flipX") == 0 || strcmp(timelineArray->name, "flipY") == 0) {
 					int x = strcmp(timelineArray->name, "flipX") == 0;
 					const char* field = x ? "x" : "y";
@@ -230,11 +227,11 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 						spFlipTimeline_setFrame(timeline, i, Json_getFloat(frame, "time", 0), Json_getInt(frame, field, 0));
 					animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 					duration = timeline->frames[timelineArray->size * 2 - 2];
-					if (duration > animation->duration) animation->duration = duration;
+					if (duration > *animationDuration) *animationDuration = duration;
 
 				} else {
-					spAnimation_dispose(animation);
-					_spSkeletonJson_setError(self, 0, "Invalid timeline type for a bone: ", timelineArray->name);
+					_spAnimation_disposeTimelines(animation);
+					*error = _formatError("Invalid timeline type for a bone: ", timelineArray->name);
 					return 0;
 				}
 			}
@@ -258,7 +255,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		}
 		animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 		duration = timeline->frames[ikMap->size * 3 - 3];
-		if (duration > animation->duration) animation->duration = duration;
+		if (duration > *animationDuration) *animationDuration = duration;
 	}
 
 	/* FFD timelines. */
@@ -275,8 +272,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 
 				spAttachment* attachment = spSkin_getAttachment(skin, slotIndex, timelineArray->name);
 				if (!attachment) {
-					spAnimation_dispose(animation);
-					_spSkeletonJson_setError(self, 0, "Attachment not found: ", timelineArray->name);
+					_spAnimation_disposeTimelines(animation);
+					*error = _formatError("Attachment not found: ", timelineArray->name);
 					return 0;
 				}
 				if (attachment->type == SP_ATTACHMENT_MESH)
@@ -304,12 +301,12 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 						Json* vertex;
 						frameVertices = tempVertices;
 						memset(frameVertices, 0, sizeof(float) * start);
-						if (self->scale == 1) {
+						if (scale == 1) {
 							for (vertex = vertices->child, v = start; vertex; vertex = vertex->next, ++v)
 								frameVertices[v] = vertex->valueFloat;
 						} else {
 							for (vertex = vertices->child, v = start; vertex; vertex = vertex->next, ++v)
-								frameVertices[v] = vertex->valueFloat * self->scale;
+								frameVertices[v] = vertex->valueFloat * scale;
 						}
 						memset(frameVertices + v, 0, sizeof(float) * (verticesCount - v));
 						if (attachment->type == SP_ATTACHMENT_MESH) {
@@ -325,7 +322,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 
 				animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 				duration = timeline->frames[timelineArray->size - 1];
-				if (duration > animation->duration) animation->duration = duration;
+				if (duration > *animationDuration) *animationDuration = duration;
 			}
 		}
 	}
@@ -349,8 +346,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 				for (offsetMap = offsets->child; offsetMap; offsetMap = offsetMap->next) {
 					int slotIndex = spSkeletonData_findSlotIndex(skeletonData, Json_getString(offsetMap, "slot", 0));
 					if (slotIndex == -1) {
-						spAnimation_dispose(animation);
-						_spSkeletonJson_setError(self, 0, "Slot not found: ", Json_getString(offsetMap, "slot", 0));
+						_spAnimation_disposeTimelines(animation);
+						*error = _formatError("Slot not found: ", Json_getString(offsetMap, "slot", 0));
 						return 0;
 					}
 					/* Collect unchanged items. */
@@ -373,7 +370,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		}
 		animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 		duration = timeline->frames[drawOrder->size - 1];
-		if (duration > animation->duration) animation->duration = duration;
+		if (duration > *animationDuration) *animationDuration = duration;
 	}
 
 	/* Event timeline. */
@@ -386,8 +383,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 			const char* stringValue;
 			spEventData* eventData = spSkeletonData_findEvent(skeletonData, Json_getString(frame, "name", 0));
 			if (!eventData) {
-				spAnimation_dispose(animation);
-				_spSkeletonJson_setError(self, 0, "Event not found: ", Json_getString(frame, "name", 0));
+				_spAnimation_disposeTimelines(animation);
+				*error = _formatError("Event not found: ", Json_getString(frame, "name", 0));
 				return 0;
 			}
 			event = spEvent_create(eventData);
@@ -399,12 +396,114 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		}
 		animation->timelines[animation->timelinesCount++] = SUPER_CAST(spTimeline, timeline);
 		duration = timeline->frames[events->size - 1];
-		if (duration > animation->duration) animation->duration = duration;
+		if (duration > *animationDuration) *animationDuration = duration;
 	}
 
+	return 1;
+}
+
+static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* root, spSkeletonData *skeletonData, char** error) {
+	spAnimation* animation = spAnimation_create(root->name, 0);
+	if (!_spSkeletonJson_readTimelines(self->scale, root, skeletonData, animation, &animation->duration, error)) {
+		spAnimation_dispose(animation);
+		return 0;
+	}
 	return animation;
 }
 
+typedef struct {
+	_spAnimationDecoder super;
+	float scale;
+	char* source; /* The JSON of all the animations. */
+} _spJsonAnimationDecoder;
+
+static int _spJsonAnimationDecoder_decode (_spAnimationDecoder* decoder, spAnimation* animation, const char* source) {
+	char* error = 0;
+	float duration;
+	int decoded;
+	Json* root = Json_create(source, 0);
+	if (!root) return 0;
+	decoded = _spSkeletonJson_readTimelines(SUB_CAST(_spJsonAnimationDecoder, decoder)->scale, root, decoder->skeletonData,
+			animation, &duration, &error);
+	Json_dispose(root);
+	FREE(error);
+	return decoded;
+}
+
+static void _spJsonAnimationDecoder_dispose (_spAnimationDecoder* decoder) {
+	FREE(SUB_CAST(_spJsonAnimationDecoder, decoder)->source);
+	FREE(decoder);
+}
+
+/* Returns the largest frame time in the JSON of an animation, which is its duration, without parsing the rest. */
+static float _spSkeletonJson_scanDuration (const char* json, int length) {
+	const char* end = json + length;
+	float duration = 0;
+	while (json < end) {
+		const char* name;
+		if (*json++ != '"') continue;
+		for (name = json; json < end && *json != '"'; ++json)
+			if (*json == '\\') ++json;
+		if (json++ - name != 4 || strncmp(name, "time", 4) != 0) continue;
+		while (json < end && (unsigned char)*json <= 32)
+			++json;
+		if (json < end && *json == ':') {
+			Json* time = Json_create(json + 1, 0);
+			if (time) {
+				if (time->type == Json_Number && time->valueFloat > duration) duration = time->valueFloat;
+				Json_dispose(time);
+			}
+		}
+	}
+	return duration;
+}
+
+/* Creates the animations with only their name and duration, keeping their JSON to decode the timelines later. */
+static void _spSkeletonJson_readLazyAnimations (spSkeletonJson* self, Json* animations, spSkeletonData* skeletonData) {
+	_spJsonAnimationDecoder* decoder = NEW(_spJsonAnimationDecoder);
+	const char *start = 0, *end = 0;
+	Json* animationMap;
+	int i;
+
+	for (animationMap = animations->child; animationMap; animationMap = animationMap->next) {
+		if (!start || animationMap->valueString < start) start = animationMap->valueString;
+		if (animationMap->valueString + animationMap->valueInt > end) end = animationMap->valueString + animationMap->valueInt;
+	}
+	decoder->source = MALLOC(char, end - start + 1);
+	memcpy(decoder->source, start, end - start);
+	decoder->source[end - start] = '\0';
+	decoder->scale = self->scale;
+	decoder->super.decode = _spJsonAnimationDecoder_decode;
+	decoder->super.dispose = _spJsonAnimationDecoder_dispose;
+	decoder->super.skeletonData = skeletonData;
+	decoder->super.memoryBudget = self->animationsBudget;
+	SUB_CAST(_spSkeletonData, skeletonData)->animationDecoder = SUPER(decoder);
+
+	skeletonData->animations = MALLOC(spAnimation*, animations->size);
+	for (animationMap = animations->child, i = 0; animationMap; animationMap = animationMap->next, ++i) {
+		spAnimation* animation = spAnimation_create(animationMap->name, 0);
+		_spAnimation* internal = SUB_CAST(_spAnimation, animation);
+		internal->decoder = SUPER(decoder);
+		internal->source = decoder->source + (animationMap->valueString - start);
+		animation->duration = _spSkeletonJson_scanDuration(animationMap->valueString, animationMap->valueInt);
+		skeletonData->animations[i] = animation;
+	}
+	skeletonData->animationsCount = animations->size;
+}
+
+typedef struct {
+	spSkeletonJson* self;
+	spSkeletonData* skeletonData;
+	Json** animationMaps;
+	char** errors;
+} _spReadAnimations;
+
+static void _spSkeletonJson_readAnimationTask (void* context, int index) {
+	_spReadAnimations* read = (_spReadAnimations*)context;
+	read->skeletonData->animations[index] = _spSkeletonJson_readAnimation(read->self, read->animationMaps[index],
+			read->skeletonData, read->errors + index);
+}
+
 spSkeletonData* spSkeletonJson_readSkeletonDataFile (spSkeletonJson* self, const char* path) {
 	int length;
 	spSkeletonData* skeletonData;
@@ -422,16 +521,15 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 	int i, ii;
 	spSkeletonData* skeletonData;
 	Json *root, *skeleton, *bones, *boneMap, *ik, *slots, *skins, *animations, *events;
-	char* oldLocale;
+	const char* jsonError;
 
 	FREE(self->error);
 	CONST_CAST(char*, self->error) = 0;
 
-	oldLocale = setlocale(LC_NUMERIC, "C");
-	root = Json_create(json);
-	setlocale(LC_NUMERIC, oldLocale);
+	/* Lazy animations are skipped by the parser and only scanned for their duration. */
+	root = self->lazyAnimations ? Json_createRaw(json, &jsonError, "animations") : Json_create(json, &jsonError);
 	if (!root) {
-		_spSkeletonJson_setError(self, 0, "Invalid skeleton JSON: ", Json_getError());
+		_spSkeletonJson_setError(self, 0, "Invalid skeleton JSON: ", jsonError);
 		return 0;
 	}
 
@@ -658,7 +756,10 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 						for (entry = entry->child, i = 0; entry; entry = entry->next, ++i)
 							mesh->regionUVs[i] = entry->valueFloat;
 
-						spMeshAttachment_updateUVs(mesh);
+						if (self->compactMeshes)
+							spMeshAttachment_compact(mesh);
+						else
+							spMeshAttachment_updateUVs(mesh);
 
 						color = Json_getString(attachmentMap, "color", 0);
 						if (color) {
@@ -729,7 +830,10 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 						for (entry = entry->child, i = 0; entry; entry = entry->next, ++i)
 							mesh->triangles[i] = entry->valueInt;
 
-						spSkinnedMeshAttachment_updateUVs(mesh);
+						if (self->compactMeshes)
+							spSkinnedMeshAttachment_compact(mesh, self->meshWeightBits);
+						else
+							spSkinnedMeshAttachment_updateUVs(mesh);
 
 						color = Json_getString(attachmentMap, "color", 0);
 						if (color) {
@@ -787,15 +891,54 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 		}
 	}
 
+	/* Pool the names before the animations are read, so the attachment timelines can share them. */
+	_spSkeletonData_internStrings(skeletonData);
+
 	/* Animations. */
 	animations = Json_getItem(root, "animations");
-	if (animations) {
+	if (animations && self->lazyAnimations) {
+		if (animations->size) _spSkeletonJson_readLazyAnimations(self, animations, skeletonData);
+	} else if (animations) {
 		Json *animationMap;
-		skeletonData->animations = MALLOC(spAnimation*, animations->size);
-		for (animationMap = animations->child; animationMap; animationMap = animationMap->next)
-			_spSkeletonJson_readAnimation(self, animationMap, skeletonData);
+		_spReadAnimations read;
+		int count = animations->size;
+		read.self = self;
+		read.skeletonData = skeletonData;
+		read.animationMaps = MALLOC(Json*, count);
+		read.errors = CALLOC(char*, count);
+		for (animationMap = animations->child, i = 0; animationMap; animationMap = animationMap->next, ++i)
+			read.animationMaps[i] = animationMap;
+
+		/* Each animation only reads the setup data, so they can be read in any order and on any thread. */
+		skeletonData->animations = CALLOC(spAnimation*, count);
+		if (self->parallelFor && count > 1)
+			self->parallelFor(count, _spSkeletonJson_readAnimationTask, &read);
+		else {
+			for (i = 0; i < count; ++i)
+				_spSkeletonJson_readAnimationTask(&read, i);
+		}
+
+		/* Report the first animation in the file that failed, whichever finished first. */
+		for (i = 0; i < count; ++i)
+			if (read.errors[i]) break;
+		if (i < count) {
+			_spSkeletonJson_setError(self, root, read.errors[i], 0);
+			for (i = 0; i < count; ++i) {
+				if (skeletonData->animations[i]) spAnimation_dispose(skeletonData->animations[i]);
+				FREE(read.errors[i]);
+			}
+			FREE(read.animationMaps);
+			FREE(read.errors);
+			spSkeletonData_dispose(skeletonData);
+			return 0;
+		}
+		skeletonData->animationsCount = count;
+		FREE(read.animationMaps);
+		FREE(read.errors);
 	}
 
+	_spSkeletonData_internStrings(skeletonData); /* Animation names. */
 	Json_dispose(root);
+	spSkeletonData_updateCache(skeletonData);
 	return skeletonData;
 }
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonPool.h>
+#include <spine/extension.h>
+
+typedef struct {
+	spSkeletonPool super;
+	int capacity;
+	spSkeleton** skeletons;
+} _spSkeletonPool;
+
+spSkeletonPool* spSkeletonPool_create (spSkeletonData* data, int max) {
+	_spSkeletonPool* internal = NEW(_spSkeletonPool);
+	spSkeletonPool* self = SUPER(internal);
+	CONST_CAST(spSkeletonData*, self->data) = data;
+	self->max = max;
+	return self;
+}
+
+void spSkeletonPool_dispose (spSkeletonPool* self) {
+	int i;
+	_spSkeletonPool* internal = SUB_CAST(_spSkeletonPool, self);
+	for (i = 0; i < self->freeCount; ++i)
+		spSkeleton_dispose(internal->skeletons[i]);
+	FREE(internal->skeletons);
+	FREE(self);
+}
+
+spSkeleton* spSkeletonPool_obtain (spSkeletonPool* self) {
+	_spSkeletonPool* internal = SUB_CAST(_spSkeletonPool, self);
+	if (self->freeCount == 0) return spSkeleton_create(self->data);
+	return internal->skeletons[--CONST_CAST(int, self->freeCount)];
+}
+
+static void _spSkeletonPool_push (_spSkeletonPool* internal, spSkeleton* skeleton) {
+	spSkeletonPool* self = SUPER(internal);
+	if (self->freeCount == internal->capacity) {
+		spSkeleton** skeletons;
+		internal->capacity = internal->capacity ? internal->capacity * 2 : 16;
+		if (internal->capacity > self->max) internal->capacity = self->max;
+		skeletons = MALLOC(spSkeleton*, internal->capacity);
+		if (self->freeCount) memcpy(skeletons, internal->skeletons, sizeof(spSkeleton*) * self->freeCount);
+		FREE(internal->skeletons);
+		internal->skeletons = skeletons;
+	}
+	internal->skeletons[CONST_CAST(int, self->freeCount)++] = skeleton;
+}
+
+void spSkeletonPool_free (spSkeletonPool* self, spSkeleton* skeleton) {
+	if (self->freeCount >= self->max) {
+		spSkeleton_dispose(skeleton);
+		return;
+	}
+
+	CONST_CAST(spSkin*, skeleton->skin) = 0;
+	skeleton->time = 0;
+	spSkeleton_setToSetupPose(skeleton);
+	skeleton->r = 1;
+	skeleton->g = 1;
+	skeleton->b = 1;
+	skeleton->a = 1;
+	skeleton->flipX = 0;
+	skeleton->flipY = 0;
+	skeleton->x = 0;
+	skeleton->y = 0;
+	spSkeleton_invalidateWorldTransform(skeleton);
+
+	_spSkeletonPool_push(SUB_CAST(_spSkeletonPool, self), skeleton);
+}
+
+void spSkeletonPool_fill (spSkeletonPool* self, int freeCount) {
+	if (freeCount > self->max) freeCount = self->max;
+	while (self->freeCount < freeCount)
+		_spSkeletonPool_push(SUB_CAST(_spSkeletonPool, self), spSkeleton_create(self->data));
+}
@@ -88,7 +88,8 @@ void spSkin_addAttachment (spSkin* self, int slotIndex, const char* name, spAtta
 spAttachment* spSkin_getAttachment (const spSkin* self, int slotIndex, const char* name) {
 	const _Entry* entry = SUB_CAST(_spSkin, self)->entries;
 	while (entry) {
-		if (entry->slotIndex == slotIndex && strcmp(entry->name, name) == 0) return entry->attachment;
+		/* Names from the skeleton data's string pool are usually the same pointer. */
+		if (entry->slotIndex == slotIndex && (entry->name == name || strcmp(entry->name, name) == 0)) return entry->attachment;
 		entry = entry->next;
 	}
 	return 0;
@@ -107,6 +108,81 @@ const char* spSkin_getAttachmentName (const spSkin* self, int slotIndex, int att
 	return 0;
 }
 
+static const char** _spAttachment_getPath (spAttachment* attachment) {
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		return &SUB_CAST(spRegionAttachment, attachment)->path;
+	case SP_ATTACHMENT_MESH:
+		return &SUB_CAST(spMeshAttachment, attachment)->path;
+	case SP_ATTACHMENT_SKINNED_MESH:
+		return &SUB_CAST(spSkinnedMeshAttachment, attachment)->path;
+	default:
+		return 0;
+	}
+}
+
+void _spSkin_internStrings (spSkin* self, _spStringPool* strings) {
+	_Entry* entry;
+	_spStringPool_intern(strings, &CONST_CAST(const char*, self->name));
+	for (entry = SUB_CAST(_spSkin, self)->entries; entry; entry = entry->next) {
+		const char** path = _spAttachment_getPath(entry->attachment);
+		_spStringPool_intern(strings, &entry->name);
+		_spStringPool_intern(strings, &CONST_CAST(const char*, entry->attachment->name));
+		if (path) _spStringPool_intern(strings, path);
+	}
+}
+
+void _spSkin_releaseStrings (spSkin* self, const _spStringPool* strings) {
+	_Entry* entry;
+	_spStringPool_release(strings, &CONST_CAST(const char*, self->name));
+	for (entry = SUB_CAST(_spSkin, self)->entries; entry; entry = entry->next) {
+		const char** path = _spAttachment_getPath(entry->attachment);
+		_spStringPool_release(strings, &entry->name);
+		_spStringPool_release(strings, &CONST_CAST(const char*, entry->attachment->name));
+		if (path) _spStringPool_release(strings, path);
+	}
+}
+
+/* Returns the bytes used by the attachment and its arrays, without its name and path. */
+static int _spAttachment_getMemory (const spAttachment* attachment) {
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		return sizeof(spRegionAttachment);
+	case SP_ATTACHMENT_BOUNDING_BOX:
+		return sizeof(spBoundingBoxAttachment) + sizeof(float) * ((const spBoundingBoxAttachment*)attachment)->verticesCount;
+	case SP_ATTACHMENT_MESH: {
+		const spMeshAttachment* mesh = (const spMeshAttachment*)attachment;
+		int memory = sizeof(spMeshAttachment) + sizeof(float) * mesh->verticesCount * (mesh->uvs ? 3 : 2)
+				+ sizeof(int) * mesh->edgesCount;
+		memory += (mesh->shortTriangles ? sizeof(unsigned short) : sizeof(int)) * mesh->trianglesCount;
+		return memory;
+	}
+	case SP_ATTACHMENT_SKINNED_MESH: {
+		const spSkinnedMeshAttachment* mesh = (const spSkinnedMeshAttachment*)attachment;
+		int weightsCount = mesh->weightsCount / 3;
+		int memory = sizeof(spSkinnedMeshAttachment) + sizeof(float) * mesh->uvsCount * (mesh->uvs ? 2 : 1)
+				+ sizeof(int) * mesh->edgesCount;
+		memory += (mesh->shortTriangles ? sizeof(unsigned short) : sizeof(int)) * mesh->trianglesCount;
+		if (mesh->shortBones) {
+			memory += sizeof(unsigned short) * mesh->bonesCount + sizeof(float) * weightsCount * 2;
+			memory += (mesh->byteWeights ? sizeof(unsigned char) : sizeof(unsigned short)) * weightsCount;
+		} else
+			memory += sizeof(int) * mesh->bonesCount + sizeof(float) * mesh->weightsCount;
+		return memory;
+	}
+	default:
+		return 0;
+	}
+}
+
+int _spSkin_getAttachmentsMemory (const spSkin* self, spAttachmentType type) {
+	const _Entry* entry;
+	int memory = 0;
+	for (entry = SUB_CAST(_spSkin, self)->entries; entry; entry = entry->next)
+		if (entry->attachment->type == type) memory += _spAttachment_getMemory(entry->attachment);
+	return memory;
+}
+
 void spSkin_attachAll (const spSkin* self, spSkeleton* skeleton, const spSkin* oldSkin) {
 	const _Entry *entry = SUB_CAST(_spSkin, oldSkin)->entries;
 	while (entry) {
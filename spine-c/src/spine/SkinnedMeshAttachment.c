@@ -42,6 +42,11 @@ void _spSkinnedMeshAttachment_dispose (spAttachment* attachment) {
 	FREE(self->uvs);
 	FREE(self->triangles);
 	FREE(self->edges);
+	FREE(self->shortBones);
+	FREE(self->weightVertices);
+	FREE(self->byteWeights);
+	FREE(self->shortWeights);
+	FREE(self->shortTriangles);
 	FREE(self);
 }
 
@@ -56,29 +61,122 @@ spSkinnedMeshAttachment* spSkinnedMeshAttachment_create (const char* name) {
 }
 
 void spSkinnedMeshAttachment_updateUVs (spSkinnedMeshAttachment* self) {
-	int i;
-	float width = self->regionU2 - self->regionU, height = self->regionV2 - self->regionV;
 	FREE(self->uvs);
 	self->uvs = MALLOC(float, self->uvsCount);
+	spSkinnedMeshAttachment_computeUVs(self, self->uvs);
+}
+
+void spSkinnedMeshAttachment_computeUVs (const spSkinnedMeshAttachment* self, float* uvs) {
+	int i;
+	float width = self->regionU2 - self->regionU, height = self->regionV2 - self->regionV;
 	if (self->regionRotate) {
 		for (i = 0; i < self->uvsCount; i += 2) {
-			self->uvs[i] = self->regionU + self->regionUVs[i + 1] * width;
-			self->uvs[i + 1] = self->regionV + height - self->regionUVs[i] * height;
+			uvs[i] = self->regionU + self->regionUVs[i + 1] * width;
+			uvs[i + 1] = self->regionV + height - self->regionUVs[i] * height;
 		}
 	} else {
 		for (i = 0; i < self->uvsCount; i += 2) {
-			self->uvs[i] = self->regionU + self->regionUVs[i] * width;
-			self->uvs[i + 1] = self->regionV + self->regionUVs[i + 1] * height;
+			uvs[i] = self->regionU + self->regionUVs[i] * width;
+			uvs[i + 1] = self->regionV + self->regionUVs[i + 1] * height;
 		}
 	}
 }
 
+void spSkinnedMeshAttachment_compact (spSkinnedMeshAttachment* self, int weightBits) {
+	int i, v, b, weightsCount = self->weightsCount / 3;
+	int max = weightBits == 8 ? 0xFF : 0xFFFF;
+	int* weights;
+
+	FREE(self->uvs);
+	self->uvs = 0;
+	if (self->triangles) {
+		self->shortTriangles = _toShorts(self->triangles, self->trianglesCount);
+		if (self->shortTriangles) {
+			FREE(self->triangles);
+			self->triangles = 0;
+		}
+	}
+	if (!self->bones) return;
+	self->shortBones = _toShorts(self->bones, self->bonesCount);
+	if (!self->shortBones) return;
+
+	self->weightVertices = MALLOC(float, weightsCount * 2);
+	weights = MALLOC(int, weightsCount);
+	for (v = 0, b = 0; v < self->bonesCount;) {
+		int count = self->bones[v], nn = count + v, largest = b, total = 0;
+		for (v++; v <= nn; v++, b++) {
+			self->weightVertices[b * 2] = self->weights[b * 3];
+			self->weightVertices[b * 2 + 1] = self->weights[b * 3 + 1];
+			weights[b] = (int)(self->weights[b * 3 + 2] * max + 0.5f);
+			if (weights[b] < 0) weights[b] = 0;
+			if (weights[b] > max) weights[b] = max;
+			if (weights[b] > weights[largest]) largest = b;
+			total += weights[b];
+		}
+		/* Gives the rounding error to the largest weight, so the weights of the vertex still add up to 1. */
+		if (total - max <= count && max - total <= count) weights[largest] += max - total;
+	}
+	if (weightBits == 8) {
+		self->byteWeights = MALLOC(unsigned char, weightsCount);
+		for (i = 0; i < weightsCount; ++i)
+			self->byteWeights[i] = (unsigned char)weights[i];
+	} else {
+		self->shortWeights = MALLOC(unsigned short, weightsCount);
+		for (i = 0; i < weightsCount; ++i)
+			self->shortWeights[i] = (unsigned short)weights[i];
+	}
+	FREE(weights);
+	FREE(self->bones);
+	self->bones = 0;
+	FREE(self->weights);
+	self->weights = 0;
+}
+
 void spSkinnedMeshAttachment_computeWorldVertices (spSkinnedMeshAttachment* self, spSlot* slot, float* worldVertices) {
-	int w = 0, v = 0, b = 0, f = 0;
+	spSkinnedMeshAttachment_computeWorldVerticesStrided(self, slot, worldVertices, 0, 2);
+}
+
+/* Decodes the bones and weights of a compact mesh as it goes. */
+static void _spSkinnedMeshAttachment_computeCompactWorldVertices (const spSkinnedMeshAttachment* self, const spSlot* slot,
+		float* worldVertices, int start, int stride) {
+	int w = start, v = 0, b = 0;
+	float x = slot->bone->skeleton->x, y = slot->bone->skeleton->y;
+	spBone** skeletonBones = slot->bone->skeleton->bones;
+	const unsigned short* bones = self->shortBones;
+	const float* vertices = self->weightVertices;
+	const float* ffd = slot->attachmentVerticesCount ? slot->attachmentVertices : 0;
+	const float scale = self->byteWeights ? 1.0f / 0xFF : 1.0f / 0xFFFF;
+	for (; v < self->bonesCount; w += stride) {
+		float wx = 0, wy = 0;
+		const int nn = bones[v] + v;
+		v++;
+		for (; v <= nn; v++, b++) {
+			const spBone* bone = skeletonBones[bones[v]];
+			float vx = vertices[b << 1], vy = vertices[(b << 1) + 1];
+			const float weight = (self->byteWeights ? self->byteWeights[b] : self->shortWeights[b]) * scale;
+			if (ffd) {
+				vx += ffd[b << 1];
+				vy += ffd[(b << 1) + 1];
+			}
+			wx += (vx * bone->m00 + vy * bone->m01 + bone->worldX) * weight;
+			wy += (vx * bone->m10 + vy * bone->m11 + bone->worldY) * weight;
+		}
+		worldVertices[w] = wx + x;
+		worldVertices[w + 1] = wy + y;
+	}
+}
+
+void spSkinnedMeshAttachment_computeWorldVerticesStrided (spSkinnedMeshAttachment* self, spSlot* slot, float* worldVertices,
+		int start, int stride) {
+	int w = start, v = 0, b = 0, f = 0;
 	float x = slot->bone->skeleton->x, y = slot->bone->skeleton->y;
 	spBone** skeletonBones = slot->bone->skeleton->bones;
+	if (self->shortBones) {
+		_spSkinnedMeshAttachment_computeCompactWorldVertices(self, slot, worldVertices, start, stride);
+		return;
+	}
 	if (slot->attachmentVerticesCount == 0) {
-		for (; v < self->bonesCount; w += 2) {
+		for (; v < self->bonesCount; w += stride) {
 			float wx = 0, wy = 0;
 			const int nn = self->bones[v] + v;
 			v++;
@@ -93,7 +191,7 @@ void spSkinnedMeshAttachment_computeWorldVertices (spSkinnedMeshAttachment* self
 		}
 	} else {
 		const float* ffd = slot->attachmentVertices;
-		for (; v < self->bonesCount; w += 2) {
+		for (; v < self->bonesCount; w += stride) {
 			float wx = 0, wy = 0;
 			const int nn = self->bones[v] + v;
 			v++;
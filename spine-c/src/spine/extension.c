@@ -31,6 +31,9 @@
 
 #include <spine/extension.h>
 #include <stdio.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 static void* (*mallocFunc) (size_t size) = malloc;
 static void* (*debugMallocFunc) (size_t size, const char* file, int line) = NULL;
@@ -77,3 +80,256 @@ char* _readFile (const char* path, int* length) {
 
 	return data;
 }
+
+unsigned short* _toShorts (const int* values, int count) {
+	unsigned short* shorts;
+	int i;
+	for (i = 0; i < count; ++i)
+		if (values[i] < 0 || values[i] > 0xFFFF) return 0;
+	shorts = MALLOC(unsigned short, count);
+	for (i = 0; i < count; ++i)
+		shorts[i] = (unsigned short)values[i];
+	return shorts;
+}
+
+char* _formatError (const char* value1, const char* value2) {
+	char message[256];
+	char* error;
+	int length;
+	strncpy(message, value1, 255);
+	message[255] = '\0';
+	length = (int)strlen(message);
+	if (value2) strncat(message + length, value2, 255 - length);
+	MALLOC_STR(error, message);
+	return error;
+}
+
+int _spBinaryInput_readInt (_spBinaryInput* self) {
+	int value;
+	if (self->end - self->cursor < 4) {
+		self->error = 1;
+		return 0;
+	}
+	value = (int)(((unsigned int)self->cursor[0] << 24) | ((unsigned int)self->cursor[1] << 16)
+			| ((unsigned int)self->cursor[2] << 8) | (unsigned int)self->cursor[3]);
+	self->cursor += 4;
+	return value;
+}
+
+float _spBinaryInput_readFloat (_spBinaryInput* self) {
+	int bits = _spBinaryInput_readInt(self);
+	float value;
+	memcpy(&value, &bits, 4);
+	return value;
+}
+
+void _spBinary_writeInt (unsigned char** output, int value) {
+	unsigned char* bytes = *output;
+	bytes[0] = (unsigned char)((unsigned int)value >> 24);
+	bytes[1] = (unsigned char)((unsigned int)value >> 16);
+	bytes[2] = (unsigned char)((unsigned int)value >> 8);
+	bytes[3] = (unsigned char)value;
+	*output += 4;
+}
+
+void _spBinary_writeFloat (unsigned char** output, float value) {
+	int bits;
+	memcpy(&bits, &value, 4);
+	_spBinary_writeInt(output, bits);
+}
+
+#if defined(_MSC_VER)
+
+int _spAtomic_get (volatile int* value) {
+	return (int)_InterlockedCompareExchange((volatile long*)value, 0, 0);
+}
+
+void _spAtomic_set (volatile int* value, int newValue) {
+	_InterlockedExchange((volatile long*)value, newValue);
+}
+
+int _spAtomic_compareAndSet (volatile int* value, int expected, int newValue) {
+	return _InterlockedCompareExchange((volatile long*)value, newValue, expected) == expected;
+}
+
+#elif defined(__ATOMIC_SEQ_CST)
+
+int _spAtomic_get (volatile int* value) {
+	return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+
+void _spAtomic_set (volatile int* value, int newValue) {
+	__atomic_store_n(value, newValue, __ATOMIC_SEQ_CST);
+}
+
+int _spAtomic_compareAndSet (volatile int* value, int expected, int newValue) {
+	return __atomic_compare_exchange_n(value, &expected, newValue, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#elif defined(__GNUC__)
+
+int _spAtomic_get (volatile int* value) {
+	return __sync_fetch_and_add(value, 0);
+}
+
+void _spAtomic_set (volatile int* value, int newValue) {
+	__sync_synchronize();
+	*value = newValue;
+	__sync_synchronize();
+}
+
+int _spAtomic_compareAndSet (volatile int* value, int expected, int newValue) {
+	return __sync_bool_compare_and_swap(value, expected, newValue);
+}
+
+#elif defined(SPINE_SINGLE_THREADED)
+
+int _spAtomic_get (volatile int* value) {
+	return *value;
+}
+
+void _spAtomic_set (volatile int* value, int newValue) {
+	*value = newValue;
+}
+
+int _spAtomic_compareAndSet (volatile int* value, int expected, int newValue) {
+	if (*value != expected) return 0;
+	*value = newValue;
+	return 1;
+}
+
+#else
+#error "Atomic operations are not available for this compiler. Define SPINE_SINGLE_THREADED to use spine-c on one thread only."
+#endif
+
+int _spAtomic_add (volatile int* value, int delta) {
+	int current;
+	do {
+		current = _spAtomic_get(value);
+	} while (!_spAtomic_compareAndSet(value, current, current + delta));
+	return current + delta;
+}
+
+/**/
+
+typedef struct _spStringBlock _spStringBlock;
+struct _spStringBlock {
+	_spStringBlock* next;
+	int capacity, used;
+	char* chars;
+};
+
+struct _spStringPool {
+	_spStringBlock* blocks; /* The newest block first. Each block is twice as large as the one before, so there are few. */
+	const char** table; /* Open addressing hash table of the strings, capacity is a power of two. */
+	int tableCapacity, count;
+	int memory;
+};
+
+static unsigned int _spStringPool_hash (const char* string, int length) {
+	unsigned int hash = 2166136261u; /* FNV-1a */
+	int i;
+	for (i = 0; i < length; ++i) {
+		hash ^= (unsigned char)string[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* Returns the index of the string in the table, or of the empty slot where it belongs. */
+static int _spStringPool_slot (const _spStringPool* self, const char* string, int length) {
+	int mask = self->tableCapacity - 1;
+	int i = (int)(_spStringPool_hash(string, length) & mask);
+	while (self->table[i] && (strncmp(self->table[i], string, length) != 0 || self->table[i][length] != '\0'))
+		i = (i + 1) & mask;
+	return i;
+}
+
+_spStringPool* _spStringPool_create () {
+	_spStringPool* self = NEW(_spStringPool);
+	self->tableCapacity = 64;
+	self->table = CALLOC(const char*, self->tableCapacity);
+	self->memory = (int)(sizeof(_spStringPool) + sizeof(const char*) * self->tableCapacity);
+	return self;
+}
+
+void _spStringPool_dispose (_spStringPool* self) {
+	_spStringBlock* block = self->blocks;
+	while (block) {
+		_spStringBlock* next = block->next;
+		FREE(block->chars);
+		FREE(block);
+		block = next;
+	}
+	FREE(self->table);
+	FREE(self);
+}
+
+const char* _spStringPool_addLength (_spStringPool* self, const char* string, int length) {
+	_spStringBlock* block = self->blocks;
+	char* copy;
+	int i = _spStringPool_slot(self, string, length);
+	if (self->table[i]) return self->table[i];
+
+	if (!block || block->capacity - block->used < length + 1) {
+		int capacity = block ? block->capacity * 2 : 1024;
+		while (capacity < length + 1)
+			capacity *= 2;
+		block = NEW(_spStringBlock);
+		block->chars = MALLOC(char, capacity);
+		block->capacity = capacity;
+		block->next = self->blocks;
+		self->blocks = block;
+		self->memory += (int)sizeof(_spStringBlock) + capacity;
+	}
+	copy = block->chars + block->used;
+	memcpy(copy, string, length);
+	copy[length] = '\0';
+	block->used += length + 1;
+	self->table[i] = copy;
+
+	if (++self->count * 2 > self->tableCapacity) {
+		/* Keep the table at most half full. */
+		const char** table = self->table;
+		int n = self->tableCapacity;
+		self->tableCapacity <<= 1;
+		self->table = CALLOC(const char*, self->tableCapacity);
+		self->memory += (int)sizeof(const char*) * n;
+		for (i = 0; i < n; ++i)
+			if (table[i]) self->table[_spStringPool_slot(self, table[i], (int)strlen(table[i]))] = table[i];
+		FREE(table);
+	}
+	return copy;
+}
+
+const char* _spStringPool_add (_spStringPool* self, const char* string) {
+	return _spStringPool_addLength(self, string, (int)strlen(string));
+}
+
+const char* _spStringPool_find (const _spStringPool* self, const char* string) {
+	return self->table[_spStringPool_slot(self, string, (int)strlen(string))];
+}
+
+int/*bool*/_spStringPool_owns (const _spStringPool* self, const char* string) {
+	const _spStringBlock* block;
+	if (!self || !string) return 0;
+	for (block = self->blocks; block; block = block->next)
+		if (string >= block->chars && string < block->chars + block->used) return 1;
+	return 0;
+}
+
+void _spStringPool_intern (_spStringPool* self, const char** string) {
+	const char* pooled;
+	if (!*string || _spStringPool_owns(self, *string)) return;
+	pooled = _spStringPool_add(self, *string);
+	FREE(*string);
+	*string = pooled;
+}
+
+void _spStringPool_release (const _spStringPool* self, const char** string) {
+	if (_spStringPool_owns(self, *string)) *string = 0;
+}
+
+int _spStringPool_getMemory (const _spStringPool* self) {
+	return self->memory;
+}
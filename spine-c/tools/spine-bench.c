@@ -0,0 +1,338 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Measures the speed of spine-c features on the sample skeletons.
+ *
+ * Usage: spine-bench [data directory]
+ *
+ * The data directory has the sample skeletons, ../spine-sfml/data by default. Times are CPU time measured with clock(), so
+ * only compare numbers from the same machine. */
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	/* Only the data is needed, the size is what a 1024x1024 texture would have. */
+	(void)path;
+	self->width = 1024;
+	self->height = 1024;
+	self->rendererObject = self;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+	(void)self;
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+/**/
+
+static const char* dataDirectory = "../spine-sfml/data";
+
+typedef struct {
+	spAtlas* atlas;
+	spSkeletonData* skeletonData;
+} Sample;
+
+static Sample loadSample (const char* name) {
+	Sample sample;
+	char path[1024];
+	spSkeletonJson* json;
+	sprintf(path, "%s/%s.atlas", dataDirectory, name);
+	sample.atlas = spAtlas_createFromFile(path, 0);
+	if (!sample.atlas) {
+		printf("Unable to read atlas: %s\n", path);
+		exit(1);
+	}
+	json = spSkeletonJson_create(sample.atlas);
+	sprintf(path, "%s/%s.json", dataDirectory, name);
+	sample.skeletonData = spSkeletonJson_readSkeletonDataFile(json, path);
+	if (!sample.skeletonData) {
+		printf("Unable to read skeleton: %s\n", json->error);
+		exit(1);
+	}
+	spSkeletonJson_dispose(json);
+	return sample;
+}
+
+static void disposeSample (Sample sample) {
+	spSkeletonData_dispose(sample.skeletonData);
+	spAtlas_dispose(sample.atlas);
+}
+
+static double seconds (clock_t start) {
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**/
+
+/* Snapshots and restores per second of a skeleton and its animation state, as a game does to roll back and resimulate
+ * frames. */
+static void benchSnapshot (void) {
+	const int count = 100000;
+	Sample sample = loadSample("raptor");
+	spSkeleton* skeleton = spSkeleton_create(sample.skeletonData);
+	spAnimationState* state = spAnimationState_create(spAnimationStateData_create(sample.skeletonData));
+	void *skeletonBuffer, *stateBuffer;
+	clock_t start;
+	double snapshotTime, restoreTime;
+	int i;
+
+	spAnimationState_setAnimationByName(state, 0, "walk", 1);
+	spAnimationState_update(state, 0.5f);
+	spAnimationState_apply(state, skeleton);
+	spSkeleton_updateWorldTransform(skeleton);
+	skeletonBuffer = malloc(spSkeleton_getSnapshotSize(skeleton));
+	stateBuffer = malloc(spAnimationState_getSnapshotSize(state));
+
+	start = clock();
+	for (i = 0; i < count; ++i) {
+		spSkeleton_snapshot(skeleton, skeletonBuffer);
+		spAnimationState_snapshot(state, stateBuffer);
+	}
+	snapshotTime = seconds(start);
+	start = clock();
+	for (i = 0; i < count; ++i) {
+		spSkeleton_restore(skeleton, skeletonBuffer);
+		spAnimationState_restore(state, stateBuffer);
+	}
+	restoreTime = seconds(start);
+
+	printf("snapshot: raptor, %d + %d bytes, %.0f snapshots/s, %.0f restores/s\n", spSkeleton_getSnapshotSize(skeleton),
+			spAnimationState_getSnapshotSize(state), count / snapshotTime, count / restoreTime);
+
+	free(skeletonBuffer);
+	free(stateBuffer);
+	spAnimationStateData_dispose(state->data);
+	spAnimationState_dispose(state);
+	spSkeleton_dispose(skeleton);
+	disposeSample(sample);
+}
+
+/* Frame times of building the vertices of many skeletons with spine-sfml's vertex layout, the way SkeletonBatch does each frame.
+ * "before" grows the buffers on demand and scales the UVs to pixels every frame, as spine-sfml did before the buffers were
+ * reserved from the skeleton data and the pixel UVs cached per attachment. "after" is what spine-sfml does now. */
+typedef struct {
+	float x, y;
+	unsigned char r, g, b, a;
+	float u, v;
+} SfmlVertex;
+
+#define RENDER_SKELETONS 100
+
+static void buildFrame (spRenderList* renderList, spSkeleton** skeletons, int/*bool*/scaleUVs) {
+	int i, ii;
+	spRenderList_clear(renderList);
+	for (i = 0; i < RENDER_SKELETONS; ++i)
+		spRenderList_addSkeleton(renderList, skeletons[i]);
+	if (!scaleUVs) return;
+	for (i = 0; i < renderList->batchesCount; ++i) {
+		spRenderBatch* batch = renderList->batches + i;
+		SfmlVertex* vertex = (SfmlVertex*)renderList->vertices + batch->firstVertex;
+		for (ii = 0; ii < batch->verticesCount; ++ii, ++vertex) {
+			vertex->u *= batch->page->width;
+			vertex->v *= batch->page->height;
+		}
+	}
+}
+
+static void benchRenderListVariant (const char* name, spSkeletonData* skeletonData, spSkeleton** skeletons, int/*bool*/after) {
+	const int lists = 200, frames = 1000;
+	spVertexFormat format;
+	spRenderList* renderList;
+	clock_t start;
+	double firstTime, frameTime;
+	int i;
+
+	memset(&format, 0, sizeof(format));
+	format.stride = sizeof(SfmlVertex);
+	format.positionOffset = offsetof(SfmlVertex, x);
+	format.uvOffset = offsetof(SfmlVertex, u);
+	format.colorOffset = offsetof(SfmlVertex, r);
+	format.color = SP_VERTEX_COLOR_BYTES;
+	format.pixelUVs = after;
+	format.triangleList = 1;
+
+	/* The first frame of a new render list, where the buffers are allocated. */
+	start = clock();
+	for (i = 0; i < lists; ++i) {
+		renderList = spRenderList_create(&format);
+		if (after) spRenderList_reserveForSkeletonData(renderList, skeletonData, RENDER_SKELETONS);
+		buildFrame(renderList, skeletons, !after);
+		spRenderList_dispose(renderList);
+	}
+	firstTime = seconds(start) / lists;
+
+	renderList = spRenderList_create(&format);
+	if (after) spRenderList_reserveForSkeletonData(renderList, skeletonData, RENDER_SKELETONS);
+	buildFrame(renderList, skeletons, !after);
+	start = clock();
+	for (i = 0; i < frames; ++i)
+		buildFrame(renderList, skeletons, !after);
+	frameTime = seconds(start) / frames;
+
+	printf("renderlist: raptor x %d, %s, %d vertices, first frame %.3f ms, frame %.3f ms\n", RENDER_SKELETONS, name,
+			renderList->verticesCount, firstTime * 1000, frameTime * 1000);
+	spRenderList_dispose(renderList);
+}
+
+static void benchRenderList (void) {
+	Sample sample = loadSample("raptor");
+	spAnimation* animation = spSkeletonData_findAnimation(sample.skeletonData, "walk");
+	spSkeleton* skeletons[RENDER_SKELETONS];
+	int i;
+
+	for (i = 0; i < RENDER_SKELETONS; ++i) {
+		skeletons[i] = spSkeleton_create(sample.skeletonData);
+		spAnimation_apply(animation, skeletons[i], 0, animation->duration * i / RENDER_SKELETONS, 1, 0, 0);
+		spSkeleton_updateWorldTransform(skeletons[i]);
+	}
+
+	benchRenderListVariant("before", sample.skeletonData, skeletons, 0);
+	benchRenderListVariant("after", sample.skeletonData, skeletons, 1);
+
+	for (i = 0; i < RENDER_SKELETONS; ++i)
+		spSkeleton_dispose(skeletons[i]);
+	disposeSample(sample);
+}
+
+/* Calls per second of the SPINE_FAST_MATH approximations compared to the libm functions they replace. spine-check checks their
+ * errors. */
+#define MATH_COUNT 1000000
+
+static float mathInputs[MATH_COUNT], mathInputs2[MATH_COUNT];
+
+static float libmSin (float radians) {
+	return (float)sin(radians);
+}
+static float libmCos (float radians) {
+	return (float)cos(radians);
+}
+static float libmAcos (float x) {
+	return (float)acos(x);
+}
+static float libmAtan2 (float y, float x) {
+	return (float)atan2(y, x);
+}
+
+static double benchMathFunction (float (*function) (float x)) {
+	volatile float sum = 0;
+	clock_t start = clock();
+	int i;
+	for (i = 0; i < MATH_COUNT; ++i)
+		sum += function(mathInputs[i]);
+	return MATH_COUNT / seconds(start);
+}
+
+static double benchMathFunction2 (float (*function) (float y, float x)) {
+	volatile float sum = 0;
+	clock_t start = clock();
+	int i;
+	for (i = 0; i < MATH_COUNT; ++i)
+		sum += function(mathInputs[i], mathInputs2[i]);
+	return MATH_COUNT / seconds(start);
+}
+
+static void printMath (const char* name, double fastCalls, double libmCalls) {
+	printf("math: %s, %.0f calls/s, libm %.0f calls/s\n", name, fastCalls, libmCalls);
+}
+
+static void benchMath (void) {
+	int i;
+
+	for (i = 0; i < MATH_COUNT; ++i)
+		mathInputs[i] = -1000 + 2000.0f * i / (MATH_COUNT - 1);
+	printMath("sin, |radians| < 1000", benchMathFunction(_spMath_sin), benchMathFunction(libmSin));
+	printMath("cos, |radians| < 1000", benchMathFunction(_spMath_cos), benchMathFunction(libmCos));
+
+	for (i = 0; i < MATH_COUNT; ++i) {
+		float angle = (float)(PI * 2 * i / MATH_COUNT), length = 0.01f + 100.0f * (i % 1000) / 1000;
+		mathInputs[i] = length * (float)sin(angle);
+		mathInputs2[i] = length * (float)cos(angle);
+	}
+	printMath("atan2", benchMathFunction2(_spMath_atan2), benchMathFunction2(libmAtan2));
+
+	for (i = 0; i < MATH_COUNT; ++i)
+		mathInputs[i] = -1 + 2.0f * i / (MATH_COUNT - 1);
+	printMath("acos", benchMathFunction(_spMath_acos), benchMathFunction(libmAcos));
+}
+
+/**/
+
+/* Poses per second of every frame of every animation of a sample, with the trigonometry this tool was built with. make bench
+ * runs it built with and without SPINE_FAST_MATH. */
+static void benchPoses (const char* name) {
+	Sample sample = loadSample(name);
+	spSkeleton* skeleton = spSkeleton_create(sample.skeletonData);
+	clock_t start;
+	int i, frame, count = 0;
+
+	if (sample.skeletonData->skinsCount > 1) spSkeleton_setSkin(skeleton, sample.skeletonData->skins[1]);
+	start = clock();
+	while (seconds(start) < 0.5) {
+		for (i = 0; i < sample.skeletonData->animationsCount; ++i) {
+			const spAnimation* animation = sample.skeletonData->animations[i];
+			for (frame = 0; frame <= 60; ++frame, ++count) {
+				float time = animation->duration * frame / 60;
+				spSkeleton_setBonesToSetupPose(skeleton);
+				spAnimation_apply(animation, skeleton, time, time, 1, 0, 0);
+				spSkeleton_updateWorldTransform(skeleton);
+			}
+		}
+	}
+#ifdef SPINE_FAST_MATH
+	printf("poses: %s, %.0f poses/s, SPINE_FAST_MATH\n", name, count / seconds(start));
+#else
+	printf("poses: %s, %.0f poses/s, libm\n", name, count / seconds(start));
+#endif
+
+	spSkeleton_dispose(skeleton);
+	disposeSample(sample);
+}
+
+int main (int argc, char** argv) {
+	if (argc > 1) dataDirectory = argv[1];
+	benchSnapshot();
+	benchRenderList();
+	benchMath();
+	benchPoses("spineboy");
+	benchPoses("raptor");
+	benchPoses("goblins-mesh");
+	return 0;
+}
@@ -0,0 +1,390 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Checks that the optional ways of loading and posing skeletons give the same poses as the defaults, on every frame of every
+ * animation of the sample skeletons. Prints the maximum error of each and fails if one is above its tolerance:
+ * - lazy transforms: spSkeleton_updateBoneWorldTransform for each bone, compared to spSkeleton_updateWorldTransform.
+ * - lazy decode: skeleton data read with lazyAnimations and a budget so small that animations are evicted after each use.
+ * - parallel: skeleton data whose animations were read in parallel with parallelFor.
+ * - compact16 and compact8: skeleton data read with compactMeshes and 16 or 8 bit weights, compared by the spRenderList vertex
+ *   positions and UVs. Quantized weights move vertices slightly, the others must be exact.
+ * - math: the SPINE_FAST_MATH approximations, compared to libm with the maximum errors documented in extension.h.
+ * - fast math: with a poses file, a build without SPINE_FAST_MATH writes the poses to it and a build with SPINE_FAST_MATH
+ *   compares its poses to them.
+ *
+ * Usage: spine-check [data directory] [poses file]
+ *
+ * The data directory has the sample skeletons, ../spine-sfml/data by default. Uses POSIX threads. */
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	/* Only the data is needed, the size is what a 1024x1024 texture would have. */
+	(void)path;
+	self->width = 1024;
+	self->height = 1024;
+	self->rendererObject = self;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+	(void)self;
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+/**/
+
+#define PARALLEL_THREADS 4
+
+typedef struct {
+	spParallelTask task;
+	void* context;
+	int count, next;
+	pthread_mutex_t mutex;
+} ParallelWork;
+
+static void* runParallelWork (void* argument) {
+	ParallelWork* work = (ParallelWork*)argument;
+	while (1) {
+		int index;
+		pthread_mutex_lock(&work->mutex);
+		index = work->next++;
+		pthread_mutex_unlock(&work->mutex);
+		if (index >= work->count) break;
+		work->task(work->context, index);
+	}
+	return 0;
+}
+
+static void parallelFor (int count, spParallelTask task, void* context) {
+	pthread_t threads[PARALLEL_THREADS];
+	ParallelWork work;
+	int i;
+	work.task = task;
+	work.context = context;
+	work.count = count;
+	work.next = 0;
+	pthread_mutex_init(&work.mutex, 0);
+	for (i = 0; i < PARALLEL_THREADS; ++i)
+		pthread_create(threads + i, 0, runParallelWork, &work);
+	for (i = 0; i < PARALLEL_THREADS; ++i)
+		pthread_join(threads[i], 0);
+	pthread_mutex_destroy(&work.mutex);
+}
+
+/**/
+
+typedef enum {
+	VARIANT_LAZY_TRANSFORMS, VARIANT_LAZY_DECODE, VARIANT_PARALLEL, VARIANT_COMPACT16, VARIANT_COMPACT8, VARIANTS_COUNT
+} Variant;
+
+static const char* variantNames[VARIANTS_COUNT] = {"lazy transforms", "lazy decode", "parallel", "compact16", "compact8"};
+/* Skeleton units for bones, pixels for UVs. */
+static const double tolerances[VARIANTS_COUNT] = {0, 0, 0, 0.1, 4};
+
+#ifdef SPINE_FAST_MATH
+/* Bone world transforms in skeleton units. */
+static const double fastMathTolerance = 0.01;
+#endif
+
+static const char* dataDirectory = "../spine-sfml/data";
+static FILE* posesFile = 0;
+
+/* Returns true if the error is within the tolerance. */
+static int/*bool*/report (const char* name, const char* check, double error, double tolerance) {
+	int/*bool*/ok = error <= tolerance;
+	printf("check: %s, %s, max error %g, tolerance %g%s\n", name, check, error, tolerance, ok ? "" : ", FAILED");
+	return ok;
+}
+
+static spSkeletonData* readSkeletonData (spAtlas* atlas, const char* path, Variant variant) {
+	spSkeletonJson* json = spSkeletonJson_create(atlas);
+	spSkeletonData* skeletonData;
+	if (variant == VARIANT_LAZY_DECODE) {
+		json->lazyAnimations = 1;
+		json->animationsBudget = 1;
+	}
+	if (variant == VARIANT_PARALLEL) json->parallelFor = parallelFor;
+	if (variant == VARIANT_COMPACT16 || variant == VARIANT_COMPACT8) {
+		json->compactMeshes = 1;
+		json->meshWeightBits = variant == VARIANT_COMPACT8 ? 8 : 16;
+	}
+	skeletonData = spSkeletonJson_readSkeletonDataFile(json, path);
+	if (!skeletonData) {
+		printf("Unable to read skeleton: %s\n", json->error);
+		exit(1);
+	}
+	spSkeletonJson_dispose(json);
+	return skeletonData;
+}
+
+static spSkeleton* createSkeleton (spSkeletonData* skeletonData) {
+	spSkeleton* skeleton = spSkeleton_create(skeletonData);
+	if (skeletonData->skinsCount > 1) {
+		spSkeleton_setSkin(skeleton, skeletonData->skins[1]);
+		spSkeleton_setSlotsToSetupPose(skeleton);
+	}
+	return skeleton;
+}
+
+static double maxError (double error, double value) {
+	value = fabs(value);
+	return value > error ? value : error;
+}
+
+/* Returns the largest difference of the bones' world transforms and the slots' attachment vertices, or HUGE_VAL if the
+ * attachments or draw order differ. */
+static double comparePoses (const spSkeleton* a, const spSkeleton* b) {
+	double error = 0;
+	int i, ii;
+	for (i = 0; i < a->bonesCount; ++i) {
+		const spBone* boneA = a->bones[i];
+		const spBone* boneB = b->bones[i];
+		error = maxError(error, boneA->m00 - boneB->m00);
+		error = maxError(error, boneA->m01 - boneB->m01);
+		error = maxError(error, boneA->m10 - boneB->m10);
+		error = maxError(error, boneA->m11 - boneB->m11);
+		error = maxError(error, boneA->worldX - boneB->worldX);
+		error = maxError(error, boneA->worldY - boneB->worldY);
+	}
+	for (i = 0; i < a->slotsCount; ++i) {
+		const spSlot* slotA = a->slots[i];
+		const spSlot* slotB = b->slots[i];
+		if ((slotA->attachment == 0) != (slotB->attachment == 0)) return HUGE_VAL;
+		if (slotA->attachment && strcmp(slotA->attachment->name, slotB->attachment->name) != 0) return HUGE_VAL;
+		if (strcmp(a->drawOrder[i]->data->name, b->drawOrder[i]->data->name) != 0) return HUGE_VAL;
+		if (slotA->attachmentVerticesCount != slotB->attachmentVerticesCount) return HUGE_VAL;
+		for (ii = 0; ii < slotA->attachmentVerticesCount; ++ii)
+			error = maxError(error, slotA->attachmentVertices[ii] - slotB->attachmentVertices[ii]);
+	}
+	return error;
+}
+
+/* Returns the largest difference of the vertex positions and pixel UVs, or HUGE_VAL if the vertices or indices differ. */
+static double compareRenderLists (const spRenderList* a, const spRenderList* b) {
+	double error = 0;
+	int i;
+	if (a->verticesCount != b->verticesCount || a->indicesCount != b->indicesCount) return HUGE_VAL;
+	if (a->indicesCount && memcmp(a->indices, b->indices, a->indicesCount * sizeof(unsigned short)) != 0) return HUGE_VAL;
+	for (i = 0; i < a->verticesCount * 4; ++i)
+		error = maxError(error, ((const float*)a->vertices)[i] - ((const float*)b->vertices)[i]);
+	return error;
+}
+
+#ifdef SPINE_FAST_MATH
+/* Returns the largest difference of the bones' world transforms and the ones written by the build without SPINE_FAST_MATH, or
+ * HUGE_VAL if the file ends. */
+static double comparePosesFile (const spSkeleton* skeleton) {
+	double error = 0;
+	float values[6];
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i) {
+		const spBone* bone = skeleton->bones[i];
+		if (fread(values, sizeof(float), 6, posesFile) != 6) return HUGE_VAL;
+		error = maxError(error, bone->m00 - values[0]);
+		error = maxError(error, bone->m01 - values[1]);
+		error = maxError(error, bone->m10 - values[2]);
+		error = maxError(error, bone->m11 - values[3]);
+		error = maxError(error, bone->worldX - values[4]);
+		error = maxError(error, bone->worldY - values[5]);
+	}
+	return error;
+}
+#else
+/* Writes the bones' world transforms for the build with SPINE_FAST_MATH to compare. */
+static double comparePosesFile (const spSkeleton* skeleton) {
+	float values[6];
+	int i;
+	for (i = 0; i < skeleton->bonesCount; ++i) {
+		const spBone* bone = skeleton->bones[i];
+		values[0] = bone->m00;
+		values[1] = bone->m01;
+		values[2] = bone->m10;
+		values[3] = bone->m11;
+		values[4] = bone->worldX;
+		values[5] = bone->worldY;
+		fwrite(values, sizeof(float), 6, posesFile);
+	}
+	return 0;
+}
+#endif
+
+static void poseSkeleton (spSkeleton* skeleton, const spAnimation* animation, float time) {
+	spSkeleton_setToSetupPose(skeleton);
+	spAnimation_apply(animation, skeleton, time, time, 1, 0, 0);
+	spSkeleton_updateWorldTransform(skeleton);
+}
+
+/* Returns true if every variant is within its tolerance. */
+static int/*bool*/checkSample (const char* name) {
+	char atlasPath[1024], jsonPath[1024];
+	spAtlas* atlas;
+	spSkeletonData* skeletonData;
+	spSkeletonData* variantData[VARIANTS_COUNT];
+	spSkeleton* skeleton;
+	spSkeleton* variantSkeletons[VARIANTS_COUNT];
+	spRenderList* renderList;
+	spRenderList* variantRenderList;
+	spVertexFormat format;
+	double errors[VARIANTS_COUNT], fastMathError = 0;
+	int/*bool*/passed = 1;
+	int i, ii, frame;
+
+	sprintf(atlasPath, "%s/%s.atlas", dataDirectory, name);
+	atlas = spAtlas_createFromFile(atlasPath, 0);
+	if (!atlas) {
+		printf("Unable to read atlas: %s\n", atlasPath);
+		exit(1);
+	}
+	sprintf(jsonPath, "%s/%s.json", dataDirectory, name);
+	skeletonData = readSkeletonData(atlas, jsonPath, VARIANTS_COUNT);
+	skeleton = createSkeleton(skeletonData);
+	for (i = 0; i < VARIANTS_COUNT; ++i) {
+		variantData[i] = i == VARIANT_LAZY_TRANSFORMS ? skeletonData : readSkeletonData(atlas, jsonPath, (Variant)i);
+		variantSkeletons[i] = createSkeleton(variantData[i]);
+		errors[i] = 0;
+	}
+
+	/* Positions and pixel UVs only, so the vertices are 4 floats. */
+	memset(&format, 0, sizeof(format));
+	format.stride = 16;
+	format.uvOffset = 8;
+	format.pixelUVs = 1;
+	format.indexSize = 2;
+	renderList = spRenderList_create(&format);
+	variantRenderList = spRenderList_create(&format);
+
+	for (i = 0; i < skeletonData->animationsCount; ++i) {
+		const spAnimation* animation = skeletonData->animations[i];
+		for (frame = 0; frame <= 60; ++frame) {
+			float time = animation->duration * frame / 60;
+			poseSkeleton(skeleton, animation, time);
+			if (posesFile) fastMathError = maxError(fastMathError, comparePosesFile(skeleton));
+			spRenderList_clear(renderList);
+			spRenderList_addSkeleton(renderList, skeleton);
+
+			/* Children first, so each bone computes the ancestors not yet computed. */
+			spSkeleton_setToSetupPose(variantSkeletons[VARIANT_LAZY_TRANSFORMS]);
+			spAnimation_apply(animation, variantSkeletons[VARIANT_LAZY_TRANSFORMS], time, time, 1, 0, 0);
+			spSkeleton_invalidateWorldTransform(variantSkeletons[VARIANT_LAZY_TRANSFORMS]);
+			for (ii = skeleton->bonesCount - 1; ii >= 0; --ii)
+				spSkeleton_updateBoneWorldTransform(variantSkeletons[VARIANT_LAZY_TRANSFORMS], ii);
+			errors[VARIANT_LAZY_TRANSFORMS] = maxError(errors[VARIANT_LAZY_TRANSFORMS],
+					comparePoses(skeleton, variantSkeletons[VARIANT_LAZY_TRANSFORMS]));
+
+			for (ii = VARIANT_LAZY_DECODE; ii < VARIANTS_COUNT; ++ii) {
+				spSkeletonData* data = variantData[ii];
+				spAnimation* variantAnimation = spSkeletonData_findAnimation(data, animation->name);
+				/* Lazy animations must be held while applied. */
+				spAnimation_acquire(variantAnimation);
+				poseSkeleton(variantSkeletons[ii], variantAnimation, time);
+				spAnimation_release(variantAnimation);
+				if (ii == VARIANT_COMPACT16 || ii == VARIANT_COMPACT8) {
+					spRenderList_clear(variantRenderList);
+					spRenderList_addSkeleton(variantRenderList, variantSkeletons[ii]);
+					errors[ii] = maxError(errors[ii], compareRenderLists(renderList, variantRenderList));
+				} else
+					errors[ii] = maxError(errors[ii], comparePoses(skeleton, variantSkeletons[ii]));
+			}
+		}
+	}
+
+	for (i = 0; i < VARIANTS_COUNT; ++i)
+		if (!report(name, variantNames[i], errors[i], tolerances[i])) passed = 0;
+#ifdef SPINE_FAST_MATH
+	if (posesFile && !report(name, "fast math", fastMathError, fastMathTolerance)) passed = 0;
+#endif
+
+	spRenderList_dispose(variantRenderList);
+	spRenderList_dispose(renderList);
+	for (i = 0; i < VARIANTS_COUNT; ++i) {
+		spSkeleton_dispose(variantSkeletons[i]);
+		if (variantData[i] != skeletonData) spSkeletonData_dispose(variantData[i]);
+	}
+	spSkeleton_dispose(skeleton);
+	spSkeletonData_dispose(skeletonData);
+	spAtlas_dispose(atlas);
+	return passed;
+}
+
+/* Returns true if the SPINE_FAST_MATH approximations are within the maximum errors documented in extension.h. */
+static int/*bool*/checkMath (void) {
+	double sinError = 0, cosError = 0, atan2Error = 0, acosError = 0;
+	int/*bool*/passed = 1;
+	int i;
+	for (i = 0; i < 1000000; ++i) {
+		float radians = -1000 + 2000.0f * i / 999999;
+		float angle = (float)(PI * 2 * i / 1000000), length = 0.01f + 100.0f * (i % 1000) / 1000;
+		float y = length * (float)sin(angle), x = length * (float)cos(angle);
+		float cosine = -1 + 2.0f * i / 999999;
+		double error = fabs(_spMath_atan2(y, x) - atan2(y, x));
+		/* -PI and PI are the same angle. */
+		if (error > PI) error = fabs(error - PI * 2);
+		atan2Error = maxError(atan2Error, error);
+		sinError = maxError(sinError, _spMath_sin(radians) - sin(radians));
+		cosError = maxError(cosError, _spMath_cos(radians) - cos(radians));
+		acosError = maxError(acosError, _spMath_acos(cosine) - acos(cosine));
+	}
+	if (!report("math", "sin, |radians| < 1000", sinError, 9e-7)) passed = 0;
+	if (!report("math", "cos, |radians| < 1000", cosError, 9e-7)) passed = 0;
+	if (!report("math", "atan2", atan2Error, 2e-6)) passed = 0;
+	if (!report("math", "acos", acosError, 5e-7)) passed = 0;
+	return passed;
+}
+
+int main (int argc, char** argv) {
+	int/*bool*/passed = 1;
+	if (argc > 1) dataDirectory = argv[1];
+	if (argc > 2) {
+#ifdef SPINE_FAST_MATH
+		posesFile = fopen(argv[2], "rb");
+#else
+		posesFile = fopen(argv[2], "wb");
+#endif
+		if (!posesFile) {
+			printf("Unable to open poses file: %s\n", argv[2]);
+			return 1;
+		}
+	}
+	if (!checkMath()) passed = 0;
+	if (!checkSample("spineboy")) passed = 0;
+	if (!checkSample("raptor")) passed = 0;
+	if (!checkSample("goblins-mesh")) passed = 0;
+	if (posesFile) fclose(posesFile);
+	return passed ? 0 : 1;
+}
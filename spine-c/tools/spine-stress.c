@@ -0,0 +1,244 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Plays the sample skeletons on many threads at once and checks every thread computes the same poses as a single thread, to
+ * exercise what the README's thread safety section allows. Build it and spine-c with -fsanitize=thread to find data races.
+ *
+ * Usage: spine-stress [data directory] [threads]
+ *
+ * The data directory has the sample skeletons, ../spine-sfml/data by default. 8 threads are used by default. Each thread plays
+ * every animation of every sample with its own skeleton, animation state and render list, using:
+ * - skeleton data and animation state data shared by all threads,
+ * - shared skeleton data read with lazyAnimations and a budget so small that animations are decoded and evicted constantly,
+ * - skeleton data it reads itself, with a shared atlas.
+ * Odd threads use yDown. Uses POSIX threads. */
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	/* Only the data is needed, the size is what a 1024x1024 texture would have. */
+	(void)path;
+	self->width = 1024;
+	self->height = 1024;
+	self->rendererObject = self;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+	(void)self;
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+/**/
+
+#define SAMPLES_COUNT 3
+#define MAX_THREADS 64
+
+static const char* sampleNames[SAMPLES_COUNT] = {"spineboy", "raptor", "goblins-mesh"};
+
+static const char* dataDirectory = "../spine-sfml/data";
+
+typedef struct {
+	char jsonPath[1024];
+	spAtlas* atlas;
+	spSkeletonData* skeletonData;
+	spAnimationStateData* stateData;
+	spSkeletonData* lazySkeletonData;
+	double expected[2]; /* Indexed by yDown. */
+} Sample;
+
+static Sample samples[SAMPLES_COUNT];
+
+static spSkeletonData* readSkeletonData (Sample* sample, int/*bool*/lazy) {
+	spSkeletonJson* json = spSkeletonJson_create(sample->atlas);
+	spSkeletonData* skeletonData;
+	json->lazyAnimations = lazy;
+	json->animationsBudget = 1;
+	skeletonData = spSkeletonJson_readSkeletonDataFile(json, sample->jsonPath);
+	if (!skeletonData) {
+		printf("Unable to read skeleton: %s\n", json->error);
+		exit(1);
+	}
+	spSkeletonJson_dispose(json);
+	return skeletonData;
+}
+
+static void loadSample (Sample* sample, const char* name) {
+	char path[1024];
+	sprintf(path, "%s/%s.atlas", dataDirectory, name);
+	sample->atlas = spAtlas_createFromFile(path, 0);
+	if (!sample->atlas) {
+		printf("Unable to read atlas: %s\n", path);
+		exit(1);
+	}
+	sprintf(sample->jsonPath, "%s/%s.json", dataDirectory, name);
+	sample->skeletonData = readSkeletonData(sample, 0);
+	sample->stateData = spAnimationStateData_create(sample->skeletonData);
+	sample->lazySkeletonData = readSkeletonData(sample, 1);
+}
+
+static void disposeSample (Sample* sample) {
+	spAnimationStateData_dispose(sample->stateData);
+	spSkeletonData_dispose(sample->lazySkeletonData);
+	spSkeletonData_dispose(sample->skeletonData);
+	spAtlas_dispose(sample->atlas);
+}
+
+/* Plays every animation of the skeleton data and returns a checksum of the world transforms and render list bounds. The
+ * animation state data is used only when it was created for the skeleton data. */
+static double play (spSkeletonData* skeletonData, spAnimationStateData* stateData, int/*bool*/yDown) {
+	int/*bool*/ownsStateData = stateData->skeletonData != skeletonData;
+	spSkeleton* skeleton = spSkeleton_create(skeletonData);
+	spAnimationState* state;
+	spRenderList* renderList;
+	spVertexFormat format;
+	void* snapshot = 0;
+	int snapshotCapacity = 0;
+	double checksum = 0;
+	int i, ii, frame;
+
+	if (ownsStateData) stateData = spAnimationStateData_create(skeletonData);
+	state = spAnimationState_create(stateData);
+	skeleton->yDown = yDown;
+	memset(&format, 0, sizeof(format));
+	format.stride = 20;
+	format.uvOffset = 8;
+	format.colorOffset = 16;
+	format.color = SP_VERTEX_COLOR_BYTES;
+	format.indexSize = 2;
+	renderList = spRenderList_create(&format);
+
+	for (i = 0; i < skeletonData->animationsCount; ++i) {
+		spAnimationState_setAnimation(state, 0, skeletonData->animations[i], 1);
+		for (frame = 0; frame < 120; ++frame) {
+			spAnimationState_update(state, 1 / 30.0f);
+			spAnimationState_apply(state, skeleton);
+			/* Rolls back and replays every fifth frame. */
+			if (frame % 5 == 0) {
+				if (spSkeleton_getSnapshotSize(skeleton) > snapshotCapacity) {
+					snapshotCapacity = spSkeleton_getSnapshotSize(skeleton);
+					free(snapshot);
+					snapshot = malloc(snapshotCapacity);
+				}
+				spSkeleton_snapshot(skeleton, snapshot);
+				spSkeleton_setToSetupPose(skeleton);
+				spSkeleton_restore(skeleton, snapshot);
+			}
+			spSkeleton_updateWorldTransform(skeleton);
+			spRenderList_updateSkeleton(renderList, skeleton);
+			for (ii = 0; ii < skeleton->bonesCount; ++ii)
+				checksum += skeleton->bones[ii]->worldX * (ii + 1) + skeleton->bones[ii]->worldY;
+			checksum += renderList->minX + renderList->minY + renderList->maxX + renderList->maxY;
+		}
+	}
+
+	spRenderList_dispose(renderList);
+	free(snapshot);
+	spAnimationState_dispose(state);
+	if (ownsStateData) spAnimationStateData_dispose(stateData);
+	spSkeleton_dispose(skeleton);
+	return checksum;
+}
+
+typedef struct {
+	int index;
+	int failures;
+} Thread;
+
+static void check (Thread* thread, const char* sampleName, const char* dataName, double checksum, double expected) {
+	if (checksum == expected) return;
+	printf("Thread %d, %s, %s data: checksum %.3f, expected %.3f\n", thread->index, sampleName, dataName, checksum, expected);
+	thread->failures++;
+}
+
+static void* runThread (void* argument) {
+	Thread* thread = (Thread*)argument;
+	int yDown = thread->index & 1;
+	int i;
+	for (i = 0; i < SAMPLES_COUNT; ++i) {
+		Sample* sample = samples + i;
+		spSkeletonData* skeletonData;
+		check(thread, sampleNames[i], "shared", play(sample->skeletonData, sample->stateData, yDown), sample->expected[yDown]);
+		check(thread, sampleNames[i], "lazy", play(sample->lazySkeletonData, sample->stateData, yDown),
+				sample->expected[yDown]);
+		skeletonData = readSkeletonData(sample, 0);
+		check(thread, sampleNames[i], "own", play(skeletonData, sample->stateData, yDown), sample->expected[yDown]);
+		spSkeletonData_dispose(skeletonData);
+	}
+	return 0;
+}
+
+int main (int argc, char** argv) {
+	pthread_t threads[MAX_THREADS];
+	Thread threadStates[MAX_THREADS];
+	int threadsCount = 8, failures = 0;
+	int i;
+
+	if (argc > 1) dataDirectory = argv[1];
+	if (argc > 2) threadsCount = atoi(argv[2]);
+	if (threadsCount < 1 || threadsCount > MAX_THREADS) {
+		printf("Threads must be 1 to %d.\n", MAX_THREADS);
+		return 1;
+	}
+
+	/* Loading and the expected results are done on one thread. */
+	for (i = 0; i < SAMPLES_COUNT; ++i) {
+		loadSample(samples + i, sampleNames[i]);
+		samples[i].expected[0] = play(samples[i].skeletonData, samples[i].stateData, 0);
+		samples[i].expected[1] = play(samples[i].skeletonData, samples[i].stateData, 1);
+	}
+
+	for (i = 0; i < threadsCount; ++i) {
+		threadStates[i].index = i;
+		threadStates[i].failures = 0;
+		if (pthread_create(threads + i, 0, runThread, threadStates + i)) {
+			printf("Unable to start thread %d.\n", i);
+			return 1;
+		}
+	}
+	for (i = 0; i < threadsCount; ++i) {
+		pthread_join(threads[i], 0);
+		failures += threadStates[i].failures;
+	}
+
+	for (i = 0; i < SAMPLES_COUNT; ++i)
+		disposeSample(samples + i);
+
+	printf("stress: %d threads, %d samples, %d mismatches\n", threadsCount, SAMPLES_COUNT, failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,1081 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Strips the data a game doesn't use from a JSON skeleton and its text atlas.
+ *
+ * Usage: spine-strip [--keep-setup-keys] skeleton.json skeleton.atlas manifest.txt out.json out.atlas
+ *
+ * The manifest lists what the game uses, one "animation <name>", "skin <name>" or "attachment <slot> <name>" per line.
+ * Lines starting with # are comments. The default skin is always kept. If the manifest lists no animations, all
+ * animations are kept, the same for skins. Then:
+ *
+ * - Animations and skins not in the manifest are removed, with the FFD timelines for the removed skins.
+ * - Attachments of the kept skins that are not a slot's setup pose attachment, keyed by a kept animation or listed in the
+ * manifest are removed, with their FFD timelines.
+ * - Events not keyed by a kept animation are removed.
+ * - Keys between two keys with the same value are removed, and timelines with the same value for all keys keep only
+ * their first key. Attachment, flip, draw order and event keys are kept. Unless --keep-setup-keys is given, timelines that only key the setup pose are removed. This changes
+ * how the animation mixes when it is applied without resetting the skeleton to the setup pose first. Animations keep
+ * their duration.
+ * - Atlas regions not used by the remaining attachments are removed, and pages left without regions.
+ *
+ * The JSON is written without whitespace and with the shortest numbers that read back as the same float. Mesh UV and
+ * triangle arrays that are the same in several attachments are reported, the JSON format has no way to share them. The
+ * output is loaded with spine-c to check it. */
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/spine/Json.h"
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	/* Only the data is checked, textures are not needed. */
+	(void)path;
+	if (!self->width) self->width = 1;
+	if (!self->height) self->height = 1;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+	(void)self;
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+/**/
+
+typedef struct {
+	const char** names;
+	int count, capacity;
+} NameSet;
+
+static void NameSet_add (NameSet* self, const char* name) {
+	int i;
+	for (i = 0; i < self->count; ++i)
+		if (strcmp(self->names[i], name) == 0) return;
+	if (self->count == self->capacity) {
+		const char** names;
+		self->capacity = self->capacity ? self->capacity * 2 : 16;
+		names = MALLOC(const char*, self->capacity);
+		if (self->count) memcpy(names, self->names, sizeof(const char*) * self->count);
+		FREE(self->names);
+		self->names = names;
+	}
+	self->names[self->count++] = name;
+}
+
+static int/*bool*/NameSet_contains (const NameSet* self, const char* name) {
+	int i;
+	for (i = 0; i < self->count; ++i)
+		if (strcmp(self->names[i], name) == 0) return 1;
+	return 0;
+}
+
+/**/
+
+typedef struct {
+	char* data;
+	int length, capacity;
+} Buffer;
+
+static void Buffer_append (Buffer* self, const char* text, int length) {
+	if (self->length + length > self->capacity) {
+		char* data;
+		self->capacity = (self->length + length) * 2 + 256;
+		data = MALLOC(char, self->capacity);
+		if (self->length) memcpy(data, self->data, self->length);
+		FREE(self->data);
+		self->data = data;
+	}
+	memcpy(self->data + self->length, text, length);
+	self->length += length;
+}
+
+static void Buffer_appendString (Buffer* self, const char* text) {
+	Buffer_append(self, text, (int)strlen(text));
+}
+
+static void writeString (Buffer* buffer, const char* value) {
+	char escape[8];
+	const char* start = value;
+	Buffer_append(buffer, "\"", 1);
+	for (; *value; ++value) {
+		unsigned char c = (unsigned char)*value;
+		if (c >= 32 && c != '"' && c != '\\') continue;
+		Buffer_append(buffer, start, (int)(value - start));
+		start = value + 1;
+		switch (c) {
+		case '"':
+			Buffer_append(buffer, "\\\"", 2);
+			break;
+		case '\\':
+			Buffer_append(buffer, "\\\\", 2);
+			break;
+		case '\n':
+			Buffer_append(buffer, "\\n", 2);
+			break;
+		case '\t':
+			Buffer_append(buffer, "\\t", 2);
+			break;
+		default:
+			sprintf(escape, "\\u%04x", c);
+			Buffer_appendString(buffer, escape);
+		}
+	}
+	Buffer_append(buffer, start, (int)(value - start));
+	Buffer_append(buffer, "\"", 1);
+}
+
+/* Writes the shortest number that spine-c's parser reads back as the same float. */
+static void writeNumber (Buffer* buffer, const Json* number) {
+	char text[32];
+	int precision;
+	if ((float)number->valueInt == number->valueFloat) {
+		sprintf(text, "%d", number->valueInt);
+		Buffer_appendString(buffer, text);
+		return;
+	}
+	for (precision = 1; precision < 9; ++precision) {
+		Json* parsed;
+		int/*bool*/same;
+		sprintf(text, "%.*g", precision, number->valueFloat);
+		parsed = Json_create(text, 0);
+		same = parsed && parsed->valueFloat == number->valueFloat;
+		Json_dispose(parsed);
+		if (same) break;
+	}
+	if (precision == 9) sprintf(text, "%.9g", number->valueFloat);
+	Buffer_appendString(buffer, text);
+}
+
+static void writeJson (Buffer* buffer, const Json* json) {
+	const Json* child;
+	switch (json->type) {
+	case Json_False:
+		Buffer_append(buffer, "false", 5);
+		break;
+	case Json_True:
+		Buffer_append(buffer, "true", 4);
+		break;
+	case Json_NULL:
+		Buffer_append(buffer, "null", 4);
+		break;
+	case Json_Number:
+		writeNumber(buffer, json);
+		break;
+	case Json_String:
+		writeString(buffer, json->valueString);
+		break;
+	case Json_Array:
+	case Json_Object:
+		Buffer_append(buffer, json->type == Json_Array ? "[" : "{", 1);
+		for (child = json->child; child; child = child->next) {
+			if (child != json->child) Buffer_append(buffer, ",", 1);
+			if (json->type == Json_Object) {
+				writeString(buffer, child->name);
+				Buffer_append(buffer, ":", 1);
+			}
+			writeJson(buffer, child);
+		}
+		Buffer_append(buffer, json->type == Json_Array ? "]" : "}", 1);
+		break;
+	}
+}
+
+static int measureJson (const Json* json) {
+	Buffer buffer = {0, 0, 0};
+	writeJson(&buffer, json);
+	FREE(buffer.data);
+	return buffer.length;
+}
+
+/**/
+
+/* Json_getItem ignores case, names in skeleton data don't. */
+static Json* findChild (Json* json, const char* name) {
+	Json* child;
+	if (!json) return 0;
+	for (child = json->child; child; child = child->next)
+		if (child->name && strcmp(child->name, name) == 0) return child;
+	return 0;
+}
+
+/* Removes and disposes a child, returns the child after it. */
+static Json* removeChild (Json* parent, Json* child) {
+	Json* next = child->next;
+	if (parent->child == child)
+		parent->child = next;
+	else {
+		Json* previous = parent->child;
+		while (previous->next != child)
+			previous = previous->next;
+		previous->next = next;
+	}
+	parent->size--;
+	child->next = 0;
+	Json_dispose(child);
+	return next;
+}
+
+/* Removes the children of parent that have no children left. */
+static void removeEmptyChildren (Json* parent) {
+	Json* child = parent->child;
+	while (child)
+		child = child->child ? child->next : removeChild(parent, child);
+}
+
+static float getFloat (Json* json, const char* name, float defaultValue) {
+	Json* item = findChild(json, name);
+	return item ? item->valueFloat : defaultValue;
+}
+
+static const char* getString (Json* json, const char* name) {
+	Json* item = findChild(json, name);
+	return item && item->type == Json_String ? item->valueString : 0;
+}
+
+static int/*bool*/getBool (Json* json, const char* name, int/*bool*/defaultValue) {
+	Json* item = findChild(json, name);
+	if (!item) return defaultValue;
+	return item->type == Json_True || (item->type == Json_Number && item->valueInt);
+}
+
+static float getLastTime (Json* frames) {
+	Json* frame = frames->child;
+	if (!frame) return 0;
+	while (frame->next)
+		frame = frame->next;
+	return getFloat(frame, "time", 0);
+}
+
+/**/
+
+typedef struct {
+	int/*bool*/keepSetupKeys;
+	NameSet animations, skins, attachments;
+	char* manifest; /* Holds the names of the sets. */
+	Json* root;
+	int animationsRemoved, skinsRemoved, attachmentsRemoved, eventsRemoved, keysRemoved, timelinesRemoved;
+	int duplicateArrays, duplicateBytes;
+} Stripper;
+
+/* Reads a file with a terminating NUL. */
+static char* readText (const char* path, int* length) {
+	char* text;
+	char* data = _readFile(path, length);
+	if (!data) return 0;
+	text = MALLOC(char, *length + 1);
+	memcpy(text, data, *length);
+	text[*length] = 0;
+	FREE(data);
+	return text;
+}
+
+static int/*bool*/readManifest (Stripper* self, const char* path) {
+	int length;
+	char* data = readText(path, &length);
+	char* line;
+	if (!data) return 0;
+	for (line = strtok(data, "\r\n"); line; line = strtok(0, "\r\n")) {
+		char* name, *end;
+		while (*line == ' ' || *line == '\t')
+			line++;
+		if (!*line || *line == '#') continue;
+		name = strchr(line, ' ');
+		if (!name) {
+			fprintf(stderr, "Invalid manifest line: %s\n", line);
+			continue;
+		}
+		*name++ = 0;
+		end = name + strlen(name);
+		while (end > name && (end[-1] == ' ' || end[-1] == '\t'))
+			*--end = 0;
+		if (strcmp(line, "animation") == 0)
+			NameSet_add(&self->animations, name);
+		else if (strcmp(line, "skin") == 0)
+			NameSet_add(&self->skins, name);
+		else if (strcmp(line, "attachment") == 0)
+			NameSet_add(&self->attachments, name);
+		else
+			fprintf(stderr, "Unknown manifest entry: %s\n", line);
+	}
+	self->manifest = data;
+	return 1;
+}
+
+static void stripAnimations (Stripper* self) {
+	Json* animations = findChild(self->root, "animations");
+	Json* animation;
+	int i;
+	if (!animations || !self->animations.count) return;
+	for (i = 0; i < self->animations.count; ++i)
+		if (!findChild(animations, self->animations.names[i]))
+			fprintf(stderr, "Animation not found: %s\n", self->animations.names[i]);
+	animation = animations->child;
+	while (animation) {
+		if (NameSet_contains(&self->animations, animation->name))
+			animation = animation->next;
+		else {
+			animation = removeChild(animations, animation);
+			self->animationsRemoved++;
+		}
+	}
+}
+
+/* Removes the FFD timelines for attachments that are no longer in their skin. */
+static void stripFFD (Stripper* self) {
+	Json* skins = findChild(self->root, "skins");
+	Json* animation = findChild(self->root, "animations");
+	for (animation = animation ? animation->child : 0; animation; animation = animation->next) {
+		Json* ffd = findChild(animation, "ffd");
+		Json* skinMap;
+		if (!ffd) continue;
+		for (skinMap = ffd->child; skinMap; skinMap = skinMap->next) {
+			Json* skin = findChild(skins, skinMap->name);
+			Json* slotMap;
+			for (slotMap = skinMap->child; slotMap; slotMap = slotMap->next) {
+				Json* timeline = slotMap->child;
+				while (timeline) {
+					if (findChild(findChild(skin, slotMap->name), timeline->name))
+						timeline = timeline->next;
+					else {
+						timeline = removeChild(slotMap, timeline);
+						self->timelinesRemoved++;
+					}
+				}
+			}
+			removeEmptyChildren(skinMap);
+		}
+		removeEmptyChildren(ffd);
+		if (!ffd->child) removeChild(animation, ffd);
+	}
+}
+
+static void stripSkins (Stripper* self) {
+	Json* skins = findChild(self->root, "skins");
+	Json* skin;
+	int i;
+	if (!skins || !self->skins.count) return;
+	for (i = 0; i < self->skins.count; ++i)
+		if (!findChild(skins, self->skins.names[i])) fprintf(stderr, "Skin not found: %s\n", self->skins.names[i]);
+	skin = skins->child;
+	while (skin) {
+		if (strcmp(skin->name, "default") == 0 || NameSet_contains(&self->skins, skin->name))
+			skin = skin->next;
+		else {
+			skin = removeChild(skins, skin);
+			self->skinsRemoved++;
+		}
+	}
+	stripFFD(self);
+}
+
+static int/*bool*/isAttachmentKeyed (Stripper* self, const char* slotName, const char* attachmentName) {
+	Json* animation = findChild(self->root, "animations");
+	for (animation = animation ? animation->child : 0; animation; animation = animation->next) {
+		Json* frames = findChild(findChild(findChild(animation, "slots"), slotName), "attachment");
+		Json* frame;
+		for (frame = frames ? frames->child : 0; frame; frame = frame->next) {
+			const char* name = getString(frame, "name");
+			if (name && strcmp(name, attachmentName) == 0) return 1;
+		}
+	}
+	return 0;
+}
+
+/* Attachments set by the game are listed in the manifest as "attachment <slot> <attachment>". */
+static int/*bool*/isAttachmentListed (Stripper* self, const char* slotName, const char* attachmentName) {
+	int i, slotLength = (int)strlen(slotName);
+	for (i = 0; i < self->attachments.count; ++i) {
+		const char* name = self->attachments.names[i];
+		if (strncmp(name, slotName, slotLength) == 0 && name[slotLength] == ' ' && strcmp(name + slotLength + 1, attachmentName) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+static void stripAttachments (Stripper* self) {
+	Json* slots = findChild(self->root, "slots");
+	Json* skins = findChild(self->root, "skins");
+	Json* skin;
+	if (!skins) return;
+	for (skin = skins->child; skin; skin = skin->next) {
+		Json* slotMap;
+		for (slotMap = skin->child; slotMap; slotMap = slotMap->next) {
+			const char* setupName = 0;
+			Json* slot, *attachment;
+			for (slot = slots ? slots->child : 0; slot; slot = slot->next) {
+				const char* name = getString(slot, "name");
+				if (name && strcmp(name, slotMap->name) == 0) {
+					setupName = getString(slot, "attachment");
+					break;
+				}
+			}
+			attachment = slotMap->child;
+			while (attachment) {
+				if ((setupName && strcmp(setupName, attachment->name) == 0) || isAttachmentKeyed(self, slotMap->name, attachment->name)
+						|| isAttachmentListed(self, slotMap->name, attachment->name))
+					attachment = attachment->next;
+				else {
+					attachment = removeChild(slotMap, attachment);
+					self->attachmentsRemoved++;
+				}
+			}
+		}
+		removeEmptyChildren(skin);
+	}
+	stripFFD(self);
+}
+
+static void stripEvents (Stripper* self) {
+	Json* events = findChild(self->root, "events");
+	Json* animation = findChild(self->root, "animations");
+	Json* event;
+	NameSet keyed = {0, 0, 0};
+	if (!events) return;
+	for (animation = animation ? animation->child : 0; animation; animation = animation->next) {
+		Json* frames = findChild(animation, "events");
+		Json* frame;
+		for (frame = frames ? frames->child : 0; frame; frame = frame->next) {
+			const char* name = getString(frame, "name");
+			if (name) NameSet_add(&keyed, name);
+		}
+	}
+	event = events->child;
+	while (event) {
+		if (NameSet_contains(&keyed, event->name))
+			event = event->next;
+		else {
+			event = removeChild(events, event);
+			self->eventsRemoved++;
+		}
+	}
+	if (!events->child) removeChild(self->root, events);
+	FREE(keyed.names);
+}
+
+/**/
+
+typedef enum {
+	KEY_OTHER, KEY_ROTATE, KEY_TRANSLATE, KEY_SCALE, KEY_COLOR, KEY_IK, KEY_FFD
+} KeyType;
+
+typedef struct {
+	Json* parent;
+	Json* frames;
+	KeyType type;
+	Json* setup; /* The slot or IK constraint of color and IK timelines. */
+	int/*bool*/remove, removeLast;
+} Timeline;
+
+typedef struct {
+	Timeline* timelines;
+	int count, capacity;
+} Timelines;
+
+static void Timelines_add (Timelines* self, Json* parent, Json* frames, KeyType type, Json* setup) {
+	Timeline* timeline;
+	if (frames->type != Json_Array) return;
+	if (self->count == self->capacity) {
+		Timeline* timelines;
+		self->capacity = self->capacity ? self->capacity * 2 : 32;
+		timelines = MALLOC(Timeline, self->capacity);
+		if (self->count) memcpy(timelines, self->timelines, sizeof(Timeline) * self->count);
+		FREE(self->timelines);
+		self->timelines = timelines;
+	}
+	timeline = self->timelines + self->count++;
+	timeline->parent = parent;
+	timeline->frames = frames;
+	timeline->type = type;
+	timeline->setup = setup;
+	timeline->remove = 0;
+	timeline->removeLast = 0;
+}
+
+static Json* findNamed (Json* array, const char* name) {
+	Json* item;
+	for (item = array ? array->child : 0; item; item = item->next) {
+		const char* itemName = getString(item, "name");
+		if (itemName && strcmp(itemName, name) == 0) return item;
+	}
+	return 0;
+}
+
+static float getFFDVertex (Json* frame, int index) {
+	Json* vertices = findChild(frame, "vertices");
+	Json* vertex;
+	index -= (int)getFloat(frame, "offset", 0);
+	if (!vertices || index < 0) return 0;
+	for (vertex = vertices->child; vertex && index > 0; vertex = vertex->next, --index) {
+	}
+	return vertex ? vertex->valueFloat : 0;
+}
+
+static int getFFDEnd (Json* frame) {
+	Json* vertices = findChild(frame, "vertices");
+	return vertices ? (int)getFloat(frame, "offset", 0) + vertices->size : 0;
+}
+
+static unsigned long getColor (Json* json, const char* name) {
+	const char* color = getString(json, name);
+	return color ? strtoul(color, 0, 16) : 0xfffffffful;
+}
+
+/* Uses the same defaults as SkeletonJson. */
+static int/*bool*/isSameKey (const Timeline* timeline, Json* a, Json* b) {
+	int i, n;
+	switch (timeline->type) {
+	case KEY_ROTATE:
+		return getFloat(a, "angle", 0) == getFloat(b, "angle", 0);
+	case KEY_TRANSLATE:
+	case KEY_SCALE:
+		return getFloat(a, "x", 0) == getFloat(b, "x", 0) && getFloat(a, "y", 0) == getFloat(b, "y", 0);
+	case KEY_COLOR:
+		return getColor(a, "color") == getColor(b, "color");
+	case KEY_IK:
+		return getFloat(a, "mix", 0) == getFloat(b, "mix", 0) && getBool(a, "bendPositive", 1) == getBool(b, "bendPositive", 1);
+	case KEY_FFD:
+		n = getFFDEnd(a) > getFFDEnd(b) ? getFFDEnd(a) : getFFDEnd(b);
+		for (i = 0; i < n; ++i)
+			if (getFFDVertex(a, i) != getFFDVertex(b, i)) return 0;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static int/*bool*/isSetupKey (const Timeline* timeline, Json* frame) {
+	int i, n;
+	switch (timeline->type) {
+	case KEY_ROTATE:
+		return getFloat(frame, "angle", 0) == 0;
+	case KEY_TRANSLATE:
+		return getFloat(frame, "x", 0) == 0 && getFloat(frame, "y", 0) == 0;
+	case KEY_SCALE:
+		return getFloat(frame, "x", 0) == 1 && getFloat(frame, "y", 0) == 1;
+	case KEY_COLOR:
+		return timeline->setup && getColor(frame, "color") == getColor(timeline->setup, "color");
+	case KEY_IK:
+		return timeline->setup && getFloat(frame, "mix", 0) == getFloat(timeline->setup, "mix", 1)
+				&& getBool(frame, "bendPositive", 1) == getBool(timeline->setup, "bendPositive", 1);
+	case KEY_FFD:
+		for (i = 0, n = getFFDEnd(frame); i < n; ++i)
+			if (getFFDVertex(frame, i) != 0) return 0;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* Attachment and flip keys are not stripped, they are applied only when the animation time passes them. */
+static void collectTimelines (Stripper* self, Json* animation, Timelines* timelines) {
+	Json* map, *timeline, *slotMap;
+	for (map = animation->child; map; map = map->next) {
+		if (strcmp(map->name, "bones") == 0) {
+			for (slotMap = map->child; slotMap; slotMap = slotMap->next) {
+				for (timeline = slotMap->child; timeline; timeline = timeline->next) {
+					KeyType type = KEY_OTHER;
+					if (strcmp(timeline->name, "rotate") == 0)
+						type = KEY_ROTATE;
+					else if (strcmp(timeline->name, "translate") == 0)
+						type = KEY_TRANSLATE;
+					else if (strcmp(timeline->name, "scale") == 0)
+						type = KEY_SCALE;
+					Timelines_add(timelines, slotMap, timeline, type, 0);
+				}
+			}
+		} else if (strcmp(map->name, "slots") == 0) {
+			for (slotMap = map->child; slotMap; slotMap = slotMap->next) {
+				Json* slot = findNamed(findChild(self->root, "slots"), slotMap->name);
+				for (timeline = slotMap->child; timeline; timeline = timeline->next)
+					Timelines_add(timelines, slotMap, timeline, strcmp(timeline->name, "color") == 0 ? KEY_COLOR : KEY_OTHER, slot);
+			}
+		} else if (strcmp(map->name, "ik") == 0) {
+			for (timeline = map->child; timeline; timeline = timeline->next)
+				Timelines_add(timelines, map, timeline, KEY_IK, findNamed(findChild(self->root, "ik"), timeline->name));
+		} else if (strcmp(map->name, "ffd") == 0) {
+			Json* skinMap;
+			for (skinMap = map->child; skinMap; skinMap = skinMap->next)
+				for (slotMap = skinMap->child; slotMap; slotMap = slotMap->next)
+					for (timeline = slotMap->child; timeline; timeline = timeline->next)
+						Timelines_add(timelines, slotMap, timeline, KEY_FFD, 0);
+		} else
+			Timelines_add(timelines, animation, map, KEY_OTHER, 0);
+	}
+}
+
+static void stripKeys (Stripper* self, Json* animation) {
+	Timelines timelines = {0, 0, 0};
+	float duration = 0;
+	int i, durationKept = 0;
+
+	collectTimelines(self, animation, &timelines);
+	for (i = 0; i < timelines.count; ++i) {
+		float time = getLastTime(timelines.timelines[i].frames);
+		if (time > duration) duration = time;
+	}
+
+	for (i = 0; i < timelines.count; ++i) {
+		Timeline* timeline = timelines.timelines + i;
+		Json* frames = timeline->frames;
+		Json* previous = frames->child, *frame;
+		if (timeline->type == KEY_OTHER || !previous) {
+			if (getLastTime(frames) == duration) durationKept = 1;
+			continue;
+		}
+
+		/* Remove keys between two keys with the same value. */
+		frame = previous->next;
+		while (frame && frame->next) {
+			if (isSameKey(timeline, previous, frame) && isSameKey(timeline, frame, frame->next)) {
+				frame = removeChild(frames, frame);
+				self->keysRemoved++;
+			} else {
+				previous = frame;
+				frame = frame->next;
+			}
+		}
+
+		/* A timeline with one value only needs its first key. */
+		if (frames->size == 1 || (frames->size == 2 && isSameKey(timeline, frames->child, frames->child->next))) {
+			if (!self->keepSetupKeys && isSetupKey(timeline, frames->child))
+				timeline->remove = 1;
+			else
+				timeline->removeLast = frames->size == 2;
+		}
+		if (!timeline->remove && (timeline->removeLast ? getFloat(frames->child, "time", 0) : getLastTime(frames)) == duration)
+			durationKept = 1;
+	}
+
+	/* Keep a key at the end of the animation, so its duration doesn't change. */
+	for (i = 0; i < timelines.count && !durationKept; ++i) {
+		Timeline* timeline = timelines.timelines + i;
+		if ((timeline->remove || timeline->removeLast) && getLastTime(timeline->frames) == duration) {
+			timeline->remove = 0;
+			timeline->removeLast = 0;
+			durationKept = 1;
+		}
+	}
+
+	for (i = 0; i < timelines.count; ++i) {
+		Timeline* timeline = timelines.timelines + i;
+		if (timeline->remove) {
+			self->keysRemoved += timeline->frames->size;
+			self->timelinesRemoved++;
+			removeChild(timeline->parent, timeline->frames);
+		} else if (timeline->removeLast) {
+			/* The last key has no curve. */
+			Json* curve = findChild(timeline->frames->child, "curve");
+			if (curve) removeChild(timeline->frames->child, curve);
+			self->keysRemoved++;
+			removeChild(timeline->frames, timeline->frames->child->next);
+		}
+	}
+	FREE(timelines.timelines);
+
+	/* Remove the maps left empty. */
+	{
+		Json* map = animation->child;
+		while (map) {
+			if (strcmp(map->name, "ffd") == 0) {
+				Json* skinMap;
+				for (skinMap = map->child; skinMap; skinMap = skinMap->next)
+					removeEmptyChildren(skinMap);
+				removeEmptyChildren(map);
+			} else if (strcmp(map->name, "bones") == 0 || strcmp(map->name, "slots") == 0)
+				removeEmptyChildren(map);
+			map = map->child || map->type != Json_Object ? map->next : removeChild(animation, map);
+		}
+	}
+}
+
+/**/
+
+static int/*bool*/isTextured (Json* attachment) {
+	const char* type = getString(attachment, "type");
+	return !type || strcmp(type, "region") == 0 || strcmp(type, "mesh") == 0 || strcmp(type, "skinnedmesh") == 0;
+}
+
+static int/*bool*/isMesh (Json* attachment) {
+	const char* type = getString(attachment, "type");
+	return type && (strcmp(type, "mesh") == 0 || strcmp(type, "skinnedmesh") == 0);
+}
+
+/* Collects the atlas region names of the attachments, the same as AtlasAttachmentLoader looks them up. */
+static void collectRegions (Stripper* self, NameSet* regions) {
+	Json* skin = findChild(self->root, "skins");
+	for (skin = skin ? skin->child : 0; skin; skin = skin->next) {
+		Json* slotMap, *attachment;
+		for (slotMap = skin->child; slotMap; slotMap = slotMap->next) {
+			for (attachment = slotMap->child; attachment; attachment = attachment->next) {
+				const char* name = getString(attachment, "path");
+				if (!isTextured(attachment)) continue;
+				if (!name) name = getString(attachment, "name");
+				NameSet_add(regions, name ? name : attachment->name);
+			}
+		}
+	}
+}
+
+/* Counts mesh UV and triangle arrays that are the same as one in another mesh. */
+static void findDuplicateMeshArrays (Stripper* self) {
+	Buffer* arrays = 0;
+	int arraysCount = 0, arraysCapacity = 0, i;
+	Json* skin = findChild(self->root, "skins");
+	for (skin = skin ? skin->child : 0; skin; skin = skin->next) {
+		Json* slotMap, *attachment;
+		for (slotMap = skin->child; slotMap; slotMap = slotMap->next) {
+			for (attachment = slotMap->child; attachment; attachment = attachment->next) {
+				int ii;
+				if (!isMesh(attachment)) continue;
+				for (ii = 0; ii < 2; ++ii) {
+					Json* array = findChild(attachment, ii ? "triangles" : "uvs");
+					Buffer buffer = {0, 0, 0};
+					if (!array) continue;
+					writeJson(&buffer, array);
+					for (i = 0; i < arraysCount; ++i)
+						if (arrays[i].length == buffer.length && memcmp(arrays[i].data, buffer.data, buffer.length) == 0) break;
+					if (i < arraysCount) {
+						self->duplicateArrays++;
+						self->duplicateBytes += buffer.length;
+						FREE(buffer.data);
+						continue;
+					}
+					if (arraysCount == arraysCapacity) {
+						Buffer* newArrays;
+						arraysCapacity = arraysCapacity ? arraysCapacity * 2 : 32;
+						newArrays = MALLOC(Buffer, arraysCapacity);
+						if (arraysCount) memcpy(newArrays, arrays, sizeof(Buffer) * arraysCount);
+						FREE(arrays);
+						arrays = newArrays;
+					}
+					arrays[arraysCount++] = buffer;
+				}
+			}
+		}
+	}
+	for (i = 0; i < arraysCount; ++i)
+		FREE(arrays[i].data);
+	FREE(arrays);
+}
+
+/**/
+
+typedef struct {
+	int pages, regions;
+} AtlasCounts;
+
+static void endPage (Buffer* output, Buffer* page, int pageRegions, AtlasCounts* after) {
+	if (pageRegions) {
+		Buffer_append(output, "\n", 1);
+		Buffer_append(output, page->data, page->length);
+		after->pages++;
+	}
+	page->length = 0;
+}
+
+/* Copies the text atlas without the unused regions and the pages left without regions. */
+static void stripTextAtlas (const char* data, int length, const NameSet* regions, Buffer* output, AtlasCounts* before,
+		AtlasCounts* after) {
+	const char* end = data + length;
+	Buffer page = {0, 0, 0};
+	int/*bool*/inPage = 0, inRegions = 0, keepLine = 0;
+	int pageRegions = 0;
+	while (data < end) {
+		const char* lineEnd = data;
+		int lineLength;
+		while (lineEnd < end && *lineEnd != '\n')
+			lineEnd++;
+		lineLength = (int)(lineEnd - data);
+		if (lineLength && data[lineLength - 1] == '\r') lineLength--;
+
+		if (!lineLength) {
+			/* A blank line ends the page. */
+			if (inPage) endPage(output, &page, pageRegions, after);
+			inPage = 0;
+		} else {
+			if (!inPage) {
+				/* Page name. */
+				inPage = 1;
+				inRegions = 0;
+				pageRegions = 0;
+				keepLine = 1;
+				before->pages++;
+			} else if (*data == ' ' || *data == '\t' || (!inRegions && memchr(data, ':', lineLength))) {
+				/* Region or page field. */
+			} else {
+				/* Region name. */
+				char* name = MALLOC(char, lineLength + 1);
+				memcpy(name, data, lineLength);
+				name[lineLength] = 0;
+				inRegions = 1;
+				keepLine = NameSet_contains(regions, name);
+				FREE(name);
+				before->regions++;
+				if (keepLine) {
+					after->regions++;
+					pageRegions++;
+				}
+			}
+			if (keepLine) {
+				Buffer_append(&page, data, lineLength);
+				Buffer_append(&page, "\n", 1);
+			}
+		}
+		data = lineEnd + 1;
+	}
+	if (inPage) endPage(output, &page, pageRegions, after);
+	FREE(page.data);
+}
+
+/* Writes the binary atlas without the unused regions and the pages left without regions. */
+static unsigned char* stripBinaryAtlas (spAtlas* atlas, const NameSet* regions, int* length, AtlasCounts* before,
+		AtlasCounts* after) {
+	spAtlasPage** pages;
+	spAtlasRegion** allRegions;
+	spAtlasPage* page, **lastPage;
+	spAtlasRegion* region, **lastRegion;
+	unsigned char* data;
+	int i;
+
+	for (page = atlas->pages; page; page = page->next)
+		before->pages++;
+	for (region = atlas->regions; region; region = region->next)
+		before->regions++;
+	pages = MALLOC(spAtlasPage*, before->pages + 1);
+	allRegions = MALLOC(spAtlasRegion*, before->regions + 1);
+	for (page = atlas->pages, i = 0; page; page = page->next)
+		pages[i++] = page;
+	pages[i] = 0;
+	for (region = atlas->regions, i = 0; region; region = region->next)
+		allRegions[i++] = region;
+	allRegions[i] = 0;
+
+	/* Link only the used regions and pages while writing. */
+	lastRegion = &atlas->regions;
+	for (i = 0; i < before->regions; ++i) {
+		if (!NameSet_contains(regions, allRegions[i]->name)) continue;
+		*lastRegion = allRegions[i];
+		lastRegion = &allRegions[i]->next;
+		after->regions++;
+	}
+	*lastRegion = 0;
+	lastPage = &atlas->pages;
+	for (i = 0; i < before->pages; ++i) {
+		for (region = atlas->regions; region && region->page != pages[i]; region = region->next) {
+		}
+		if (!region) continue;
+		*lastPage = pages[i];
+		lastPage = &pages[i]->next;
+		after->pages++;
+	}
+	*lastPage = 0;
+
+	data = spAtlas_writeBinary(atlas, length);
+
+	/* The atlas disposes its regions in their original order. */
+	atlas->pages = pages[0];
+	for (i = 0; i < before->pages; ++i)
+		pages[i]->next = pages[i + 1];
+	atlas->regions = allRegions[0];
+	for (i = 0; i < before->regions; ++i)
+		allRegions[i]->next = allRegions[i + 1];
+	FREE(pages);
+	FREE(allRegions);
+	return data;
+}
+
+/**/
+
+static int/*bool*/writeFile (const char* path, const char* data, int length) {
+	FILE* file = fopen(path, "wb");
+	int/*bool*/written;
+	if (!file) return 0;
+	written = (int)fwrite(data, 1, length, file) == length;
+	return fclose(file) == 0 && written;
+}
+
+static void printSaving (const char* category, int removed, int before, int after) {
+	char label[64];
+	if (removed >= 0)
+		sprintf(label, "%s (%d removed)", category, removed);
+	else
+		sprintf(label, "%s", category);
+	printf("  %-32s %9d bytes\n", label, before - after);
+}
+
+int main (int argc, char** argv) {
+	Stripper self;
+	const char* skeletonPath, *atlasPath, *manifestPath, *outputPath, *outputAtlasPath;
+	const char* error = 0;
+	char* json, *atlasData;
+	int jsonLength, atlasLength, outputAtlasLength, size, stepSize, i;
+	NameSet regions = {0, 0, 0};
+	AtlasCounts atlasBefore = {0, 0}, atlasAfter = {0, 0};
+	Buffer output = {0, 0, 0}, outputAtlas = {0, 0, 0};
+	spAtlas* atlas;
+	spSkeletonJson* skeletonJson;
+	spSkeletonData* skeletonData;
+	Json* animation;
+
+	memset(&self, 0, sizeof(self));
+	i = 1;
+	if (argc > 1 && strcmp(argv[1], "--keep-setup-keys") == 0) {
+		self.keepSetupKeys = 1;
+		i++;
+	}
+	if (argc - i != 5) {
+		fprintf(stderr, "Usage: spine-strip [--keep-setup-keys] skeleton.json skeleton.atlas manifest.txt out.json out.atlas\n");
+		return 1;
+	}
+	skeletonPath = argv[i];
+	atlasPath = argv[i + 1];
+	manifestPath = argv[i + 2];
+	outputPath = argv[i + 3];
+	outputAtlasPath = argv[i + 4];
+
+	if (!readManifest(&self, manifestPath)) {
+		fprintf(stderr, "Unable to read manifest: %s\n", manifestPath);
+		return 1;
+	}
+	json = readText(skeletonPath, &jsonLength);
+	if (!json) {
+		fprintf(stderr, "Unable to read skeleton: %s\n", skeletonPath);
+		return 1;
+	}
+	self.root = Json_create(json, &error);
+	FREE(json);
+	if (!self.root) {
+		fprintf(stderr, "Invalid JSON in %s near: %.32s\n", skeletonPath, error ? error : "");
+		return 1;
+	}
+	atlasData = _readFile(atlasPath, &atlasLength);
+	if (!atlasData) {
+		fprintf(stderr, "Unable to read atlas: %s\n", atlasPath);
+		return 1;
+	}
+
+	printf("%s: %d bytes\n", skeletonPath, jsonLength);
+	size = measureJson(self.root);
+	printSaving("whitespace and numbers", -1, jsonLength, size);
+
+	stripAnimations(&self);
+	stepSize = measureJson(self.root);
+	printSaving("animations", self.animationsRemoved, size, stepSize);
+	size = stepSize;
+
+	stripSkins(&self);
+	stepSize = measureJson(self.root);
+	printSaving("skins", self.skinsRemoved, size, stepSize);
+	size = stepSize;
+
+	stripAttachments(&self);
+	stepSize = measureJson(self.root);
+	printSaving("attachments", self.attachmentsRemoved, size, stepSize);
+	size = stepSize;
+
+	stripEvents(&self);
+	stepSize = measureJson(self.root);
+	printSaving("events", self.eventsRemoved, size, stepSize);
+	size = stepSize;
+
+	i = self.timelinesRemoved;
+	animation = findChild(self.root, "animations");
+	for (animation = animation ? animation->child : 0; animation; animation = animation->next)
+		stripKeys(&self, animation);
+	stepSize = measureJson(self.root);
+	printSaving("keys", self.keysRemoved, size, stepSize);
+	printf("  %-32s %9d\n", "timelines removed", self.timelinesRemoved - i);
+
+	writeJson(&output, self.root);
+	printf("  %-32s %9d bytes (%.1f%%)\n", "total", jsonLength - output.length,
+			jsonLength ? 100.0 * (jsonLength - output.length) / jsonLength : 0.0);
+	findDuplicateMeshArrays(&self);
+	if (self.duplicateArrays)
+		printf("  %d mesh UV and triangle arrays (%d bytes) are duplicates, JSON has no way to share them.\n",
+				self.duplicateArrays, self.duplicateBytes);
+	if (!writeFile(outputPath, output.data, output.length)) {
+		fprintf(stderr, "Unable to write skeleton: %s\n", outputPath);
+		return 1;
+	}
+
+	collectRegions(&self, &regions);
+	atlas = spAtlas_createFromBinary((unsigned char*)atlasData, atlasLength, "", 0);
+	if (atlas) {
+		unsigned char* data = stripBinaryAtlas(atlas, &regions, &outputAtlasLength, &atlasBefore, &atlasAfter);
+		Buffer_append(&outputAtlas, (const char*)data, outputAtlasLength);
+		FREE(data);
+		spAtlas_dispose(atlas);
+	} else
+		stripTextAtlas(atlasData, atlasLength, &regions, &outputAtlas, &atlasBefore, &atlasAfter);
+	if (!writeFile(outputAtlasPath, outputAtlas.data, outputAtlas.length)) {
+		fprintf(stderr, "Unable to write atlas: %s\n", outputAtlasPath);
+		return 1;
+	}
+	printf("%s: %d bytes\n", atlasPath, atlasLength);
+	printf("  %-32s %9d\n", "pages removed", atlasBefore.pages - atlasAfter.pages);
+	printf("  %-32s %9d\n", "regions removed", atlasBefore.regions - atlasAfter.regions);
+	printf("  %-32s %9d bytes\n", "total", atlasLength - outputAtlas.length);
+
+	FREE(regions.names);
+	FREE(self.animations.names);
+	FREE(self.skins.names);
+	FREE(self.attachments.names);
+	FREE(self.manifest);
+	FREE(output.data);
+	FREE(outputAtlas.data);
+	FREE(atlasData);
+	Json_dispose(self.root);
+
+	/* Check that spine-c loads the output. */
+	atlas = spAtlas_createFromFile(outputAtlasPath, 0);
+	if (!atlas) {
+		fprintf(stderr, "Unable to load the written atlas: %s\n", outputAtlasPath);
+		return 1;
+	}
+	skeletonJson = spSkeletonJson_create(atlas);
+	skeletonData = spSkeletonJson_readSkeletonDataFile(skeletonJson, outputPath);
+	if (!skeletonData) {
+		fprintf(stderr, "Unable to load the written skeleton: %s\n", skeletonJson->error);
+		spSkeletonJson_dispose(skeletonJson);
+		spAtlas_dispose(atlas);
+		return 1;
+	}
+	printf("%s: %d bones, %d slots, %d skins, %d animations, %d events\n", outputPath, skeletonData->bonesCount,
+			skeletonData->slotsCount, skeletonData->skinsCount, skeletonData->animationsCount, skeletonData->eventsCount);
+	spSkeletonData_dispose(skeletonData);
+	spSkeletonJson_dispose(skeletonJson);
+	spAtlas_dispose(atlas);
+	return 0;
+}
@@ -31,8 +31,12 @@
 
 #include <spine/PolygonBatch.h>
 #include <spine/extension.h>
+#include <algorithm>
+#include <stddef.h>
 
 USING_NS_CC;
+using std::max;
+using std::min;
 
 namespace spine {
 
@@ -44,65 +48,116 @@ PolygonBatch* PolygonBatch::createWithCapacity (int capacity) {
 }
 
 PolygonBatch::PolygonBatch () :
-	capacity(0), 
+	verticesCapacity(0), trianglesCapacity(0),
 	vertices(nullptr), verticesCount(0),
 	triangles(nullptr), trianglesCount(0),
-	texture(nullptr)
-{}
+	texture(nullptr),
+	bufferIndex(0),
+	flushCount(0), drawnVerticesCount(0)
+{
+	memset(buffers, 0, sizeof(buffers));
+}
 
 bool PolygonBatch::initWithCapacity (int capacity) {
-	// 32767 is max index, so 32767 / 3 - (32767 / 3 % 3) = 10920.
-	CCAssert(capacity <= 10920, "capacity cannot be > 10920");
 	CCAssert(capacity >= 0, "capacity cannot be < 0");
-	this->capacity = capacity;
-	vertices = MALLOC(ccV2F_C4B_T2F, capacity);
-	triangles = MALLOC(GLushort, capacity * 3);
+	ensureCapacity(capacity, capacity * 3);
+	glGenBuffers(BUFFERS_COUNT * 2, buffers);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+	CCNotificationCenter::sharedNotificationCenter()->addObserver(this,
+		callfuncO_selector(PolygonBatch::listenBackToForeground), EVENT_COME_TO_FOREGROUND, nullptr);
+#endif
 	return true;
 }
 
 PolygonBatch::~PolygonBatch () {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+	CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, EVENT_COME_TO_FOREGROUND);
+#endif
 	FREE(vertices);
 	FREE(triangles);
+	glDeleteBuffers(BUFFERS_COUNT * 2, buffers);
+}
+
+void PolygonBatch::listenBackToForeground (CCObject* object) {
+	// The names belonged to the lost context and may now be used by other objects, so they are not deleted.
+	glGenBuffers(BUFFERS_COUNT * 2, buffers);
+	bufferIndex = 0;
+}
+
+void PolygonBatch::ensureCapacity (int verticesCount, int trianglesCount) {
+	verticesCount = min(verticesCount, MAX_VERTICES);
+	if (verticesCount > verticesCapacity) {
+		ccV2F_C4B_T2F* newVertices = MALLOC(ccV2F_C4B_T2F, verticesCount);
+		memcpy(newVertices, vertices, sizeof(ccV2F_C4B_T2F) * this->verticesCount);
+		FREE(vertices);
+		vertices = newVertices;
+		verticesCapacity = verticesCount;
+	}
+	if (trianglesCount > trianglesCapacity) {
+		GLushort* newTriangles = MALLOC(GLushort, trianglesCount);
+		memcpy(newTriangles, triangles, sizeof(GLushort) * this->trianglesCount);
+		FREE(triangles);
+		triangles = newTriangles;
+		trianglesCapacity = trianglesCount;
+	}
 }
 
 void PolygonBatch::add (CCTexture2D* addTexture,
-		const float* addVertices, const float* uvs, int addVerticesCount,
-		const int* addTriangles, int addTrianglesCount,
-		ccColor4B* color) {
+		const ccV2F_C4B_T2F* addVertices, int addVerticesCount,
+		const GLushort* addTriangles, int addTrianglesCount) {
 
 	if (
 		addTexture != texture
-		|| verticesCount + (addVerticesCount >> 1) > capacity
-		|| trianglesCount + addTrianglesCount > capacity * 3) {
+		|| verticesCount + addVerticesCount > verticesCapacity
+		|| trianglesCount + addTrianglesCount > trianglesCapacity) {
 		this->flush();
 		texture = addTexture;
+		ensureCapacity(addVerticesCount, addTrianglesCount);
 	}
 
 	for (int i = 0; i < addTrianglesCount; ++i, ++trianglesCount)
 		triangles[trianglesCount] = addTriangles[i] + verticesCount;
 
-	for (int i = 0; i < addVerticesCount; i += 2, ++verticesCount) {
-		ccV2F_C4B_T2F* vertex = vertices + verticesCount;
-		vertex->vertices.x = addVertices[i];
-		vertex->vertices.y = addVertices[i + 1];
-		vertex->colors = *color;
-		vertex->texCoords.u = uvs[i];
-		vertex->texCoords.v = uvs[i + 1];
-	}
+	memcpy(vertices + verticesCount, addVertices, sizeof(ccV2F_C4B_T2F) * addVerticesCount);
+	verticesCount += addVerticesCount;
 }
 
 void PolygonBatch::flush () {
 	if (!verticesCount) return;
 
+	GLuint vertexBuffer = buffers[bufferIndex * 2], indexBuffer = buffers[bufferIndex * 2 + 1];
+	bufferIndex = (bufferIndex + 1) % BUFFERS_COUNT;
+
+	GLsizeiptr verticesSize = sizeof(ccV2F_C4B_T2F) * verticesCount;
+	GLsizeiptr trianglesSize = sizeof(GLushort) * trianglesCount;
+
 	ccGLBindTexture2D(texture->getName());
+
+	// Orphan the previous storage, then upload.
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, verticesSize, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, verticesSize, vertices);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, trianglesSize, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, trianglesSize, triangles);
+
 	glEnableVertexAttribArray(kCCVertexAttrib_Position);
 	glEnableVertexAttribArray(kCCVertexAttrib_Color);
 	glEnableVertexAttribArray(kCCVertexAttrib_TexCoords);
-	glVertexAttribPointer(kCCVertexAttrib_Position, 2, GL_FLOAT, GL_FALSE, sizeof(ccV2F_C4B_T2F), &vertices[0].vertices);
-	glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ccV2F_C4B_T2F), &vertices[0].colors);
-	glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(ccV2F_C4B_T2F), &vertices[0].texCoords);
+	glVertexAttribPointer(kCCVertexAttrib_Position, 2, GL_FLOAT, GL_FALSE, sizeof(ccV2F_C4B_T2F),
+		(GLvoid*)offsetof(ccV2F_C4B_T2F, vertices));
+	glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ccV2F_C4B_T2F),
+		(GLvoid*)offsetof(ccV2F_C4B_T2F, colors));
+	glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(ccV2F_C4B_T2F),
+		(GLvoid*)offsetof(ccV2F_C4B_T2F, texCoords));
 
-	glDrawElements(GL_TRIANGLES, trianglesCount, GL_UNSIGNED_SHORT, triangles);
+	glDrawElements(GL_TRIANGLES, trianglesCount, GL_UNSIGNED_SHORT, 0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	flushCount++;
+	drawnVerticesCount += verticesCount;
 
 	verticesCount = 0;
 	trianglesCount = 0;
@@ -110,4 +165,9 @@ void PolygonBatch::flush () {
 	CHECK_GL_ERROR_DEBUG();
 }
 
+void PolygonBatch::resetCounters () {
+	flushCount = 0;
+	drawnVerticesCount = 0;
+}
+
 }
@@ -36,8 +36,13 @@
 
 namespace spine {
 
+/** Collects textured triangles and draws them with one draw call per texture. Each flush uploads the vertices and indices to the
+ * next of a ring of vertex and index buffers, orphaning the buffer's previous storage so the driver does not wait for draws
+ * still using it. The buffers are created again when the app comes back to the foreground after losing its GL context. */
 class PolygonBatch : public cocos2d::CCObject {
 public:
+	/** @param capacity The number of vertices that can be drawn with one draw call. The capacity grows if needed, up to 65536
+	 * vertices. */
 	static PolygonBatch* createWithCapacity (int capacity);
 
 	/** @js ctor */
@@ -48,19 +53,40 @@ public:
 	virtual ~PolygonBatch();
 
 	bool initWithCapacity (int capacity);
+	/* Triangles index the vertices being added. */
 	void add (cocos2d::CCTexture2D* texture,
-		const float* vertices, const float* uvs, int verticesCount,
-		const int* triangles, int trianglesCount,
-		cocos2d::ccColor4B* color);
+		const cocos2d::ccV2F_C4B_T2F* vertices, int verticesCount,
+		const GLushort* triangles, int trianglesCount);
 	void flush ();
 
+	/** Grows the batch so the specified number of vertices and triangle indices can be drawn with one draw call. */
+	void ensureCapacity (int verticesCount, int trianglesCount);
+
+	/** The number of draw calls and vertices drawn since the counters were reset. */
+	int getFlushCount () const { return flushCount; }
+	int getDrawnVerticesCount () const { return drawnVerticesCount; }
+	void resetCounters ();
+
+	/** Creates the buffers again, the previous ones were lost with the GL context. */
+	void listenBackToForeground (cocos2d::CCObject* object);
+
 private:
-	int capacity;
+	static const int BUFFERS_COUNT = 3;
+	// 16-bit indices can address at most 65536 vertices.
+	static const int MAX_VERTICES = 65536;
+
+	int verticesCapacity, trianglesCapacity;
 	cocos2d::ccV2F_C4B_T2F* vertices;
 	int verticesCount;
 	GLushort* triangles;
 	int trianglesCount;
 	cocos2d::CCTexture2D* texture;
+
+	GLuint buffers[BUFFERS_COUNT * 2];
+	int bufferIndex;
+
+	int flushCount;
+	int drawnVerticesCount;
 };
 
 }
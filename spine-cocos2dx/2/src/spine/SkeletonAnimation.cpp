@@ -97,6 +97,9 @@ void SkeletonAnimation::initialize () {
 
 	_spAnimationState* stateInternal = (_spAnimationState*)state;
 	stateInternal->disposeTrackEntry = disposeTrackEntry;
+
+	imposter = 0;
+	imposterScale = 0;
 }
 
 SkeletonAnimation::SkeletonAnimation (spSkeletonData *skeletonData)
@@ -126,6 +129,60 @@ void SkeletonAnimation::update (float deltaTime) {
 	spAnimationState_update(state, deltaTime);
 	spAnimationState_apply(state, skeleton);
 	spSkeleton_updateWorldTransform(skeleton);
+	invalidateRenderList();
+}
+
+void SkeletonAnimation::draw () {
+	if (imposter && drawImposter()) return;
+	super::draw();
+}
+
+bool SkeletonAnimation::drawImposter () {
+	CCAffineTransform transform = nodeToWorldTransform();
+	float scale = sqrtf(fabsf(transform.a * transform.d - transform.b * transform.c));
+	if (scale > imposterScale || !state->tracksCount || !state->tracks[0]) return false;
+
+	spTrackEntry* entry = state->tracks[0];
+	const spImposterFrame* frame = spImposter_getFrame(imposter, entry->animation, entry->time, entry->loop);
+	if (!frame) return false;
+
+	const spImposterPage* page = imposter->pages + frame->page;
+	float x = skeleton->x + frame->offsetX, y = skeleton->y + frame->offsetY;
+	float width = frame->width / imposter->scale, height = frame->height / imposter->scale;
+	float u = frame->x / (float)page->width, v = frame->y / (float)page->height;
+	float u2 = (frame->x + frame->width) / (float)page->width, v2 = (frame->y + frame->height) / (float)page->height;
+	ccColor3B nodeColor = getColor();
+	GLubyte alpha = getDisplayedOpacity();
+	ccColor4B color = ccc4(nodeColor.r, nodeColor.g, nodeColor.b, alpha);
+	if (imposter->premultipliedAlpha) {
+		color.r = color.r * alpha / 255;
+		color.g = color.g * alpha / 255;
+		color.b = color.b * alpha / 255;
+	}
+	ccV2F_C4B_T2F vertices[4];
+	vertices[0].vertices = vertex2(x, y);
+	vertices[0].texCoords = tex2(u, v);
+	vertices[1].vertices = vertex2(x + width, y);
+	vertices[1].texCoords = tex2(u2, v);
+	vertices[2].vertices = vertex2(x + width, y + height);
+	vertices[2].texCoords = tex2(u2, v2);
+	vertices[3].vertices = vertex2(x, y + height);
+	vertices[3].texCoords = tex2(u, v2);
+	for (int i = 0; i < 4; ++i)
+		vertices[i].colors = color;
+
+	CC_NODE_DRAW_SETUP();
+	ccGLBindVAO(0);
+	ccGLBlendFunc(imposter->premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	static const GLushort quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+	batch->add((CCTexture2D*)page->rendererObject, vertices, 4, quadTriangles, 6);
+	batch->flush();
+	return true;
+}
+
+void SkeletonAnimation::setImposter (const spImposter* imposter, float scale) {
+	this->imposter = imposter;
+	imposterScale = scale;
 }
 
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
@@ -60,6 +60,12 @@ public:
 	virtual ~SkeletonAnimation ();
 
 	virtual void update (float deltaTime);
+	virtual void draw ();
+
+	/** Draws the imposter's frame for track 0 instead of the skeleton while the node is drawn at the specified scale or smaller.
+	  * The imposter's pages must have textures, see createImposterTextures.
+	  * @param imposter May be null. */
+	void setImposter (const spImposter* imposter, float scale);
 
 	void setAnimationStateData (spAnimationStateData* stateData);
 	void setMix (const char* fromAnimation, const char* toAnimation, float duration);
@@ -88,8 +94,12 @@ protected:
 private:
 	typedef SkeletonRenderer super;
 	bool ownsAnimationStateData;
+	const spImposter* imposter;
+	float imposterScale;
 
 	void initialize ();
+	/* Returns false if the skeleton must be drawn instead. */
+	bool drawImposter ();
 };
 
 }
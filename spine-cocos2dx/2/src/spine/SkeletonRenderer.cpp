@@ -41,8 +41,6 @@ using std::max;
 
 namespace spine {
 
-static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
-
 SkeletonRenderer* SkeletonRenderer::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonRenderer* node = new SkeletonRenderer(skeletonData, ownsSkeletonData);
 	node->autorelease();
@@ -62,9 +60,11 @@ SkeletonRenderer* SkeletonRenderer::createWithFile (const char* skeletonDataFile
 }
 
 void SkeletonRenderer::initialize () {
-	worldVertices = MALLOC(float, 1000); // Max number of vertices per mesh.
+	renderList = 0;
+	renderListFrame = 0;
+	renderListValid = false;
 
-	batch = PolygonBatch::createWithCapacity(2000); // Max number of vertices and triangles per batch.
+	batch = PolygonBatch::createWithCapacity(0); // Sized from the render list when drawn.
 	batch->retain();
 
 	blendFunc.src = GL_ONE;
@@ -82,19 +82,19 @@ void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsS
 }
 
 SkeletonRenderer::SkeletonRenderer ()
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), assetCache(0), debugSlots(false), debugBones(false), timeScale(1) {
 	initialize();
 }
 
 SkeletonRenderer::SkeletonRenderer (spSkeletonData *skeletonData, bool ownsSkeletonData)
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), assetCache(0), debugSlots(false), debugBones(false), timeScale(1) {
 	initialize();
 
 	setSkeletonData(skeletonData, ownsSkeletonData);
 }
 
 SkeletonRenderer::SkeletonRenderer (const char* skeletonDataFile, spAtlas* atlas, float scale)
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), assetCache(0), debugSlots(false), debugBones(false), timeScale(1) {
 	initialize();
 
 	spSkeletonJson* json = spSkeletonJson_create(atlas);
@@ -107,31 +107,31 @@ SkeletonRenderer::SkeletonRenderer (const char* skeletonDataFile, spAtlas* atlas
 }
 
 SkeletonRenderer::SkeletonRenderer (const char* skeletonDataFile, const char* atlasFile, float scale)
-	: atlas(0), debugSlots(false), debugBones(false), timeScale(1) {
+	: atlas(0), assetCache(0), debugSlots(false), debugBones(false), timeScale(1) {
 	initialize();
 
-	atlas = spAtlas_createFromFile(atlasFile, 0);
-	CCAssert(atlas, "Error reading atlas file.");
-
-	spSkeletonJson* json = spSkeletonJson_create(atlas);
-	json->scale = scale;
-	spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, skeletonDataFile);
-	CCAssert(skeletonData, json->error ? json->error : "Error reading skeleton data file.");
-	spSkeletonJson_dispose(json);
+	// Skeletons created from the same files share the skeleton data and atlas.
+	assetCache = getAssetCache();
+	spSkeletonData* skeletonData = spAssetCache_acquireSkeletonData(assetCache, skeletonDataFile, atlasFile, scale);
+	CCAssert(skeletonData, assetCache->error ? assetCache->error : "Error reading skeleton data file.");
 
-	setSkeletonData(skeletonData, true);
+	setSkeletonData(skeletonData, false);
 }
 
 SkeletonRenderer::~SkeletonRenderer () {
-	if (ownsSkeletonData) spSkeletonData_dispose(skeleton->data);
+	if (assetCache)
+		spAssetCache_releaseSkeletonData(assetCache, skeleton->data);
+	else if (ownsSkeletonData)
+		spSkeletonData_dispose(skeleton->data);
 	if (atlas) spAtlas_dispose(atlas);
 	spSkeleton_dispose(skeleton);
-	FREE(worldVertices);
+	if (renderList) spRenderList_dispose(renderList);
 	batch->release();
 }
 
 void SkeletonRenderer::update (float deltaTime) {
 	spSkeleton_update(skeleton, deltaTime * timeScale);
+	invalidateRenderList();
 }
 
 void SkeletonRenderer::draw () {
@@ -144,86 +144,33 @@ void SkeletonRenderer::draw () {
 	skeleton->b = nodeColor.b / (float)255;
 	skeleton->a = getDisplayedOpacity() / (float)255;
 
+	updateRenderList();
+	batch->ensureCapacity(renderList->verticesCount, renderList->indicesCount);
+
+	const ccV2F_C4B_T2F* vertices = (const ccV2F_C4B_T2F*)renderList->vertices;
+	const GLushort* triangles = (const GLushort*)renderList->indices;
 	int blendMode = -1;
-	ccColor4B color;
-	const float* uvs = nullptr;
-	int verticesCount = 0;
-	const int* triangles = nullptr;
-	int trianglesCount = 0;
-	float r = 0, g = 0, b = 0, a = 0;
-	for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
-		spSlot* slot = skeleton->drawOrder[i];
-		if (!slot->attachment) continue;
-		CCTexture2D *texture = nullptr;
-		switch (slot->attachment->type) {
-		case SP_ATTACHMENT_REGION: {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = 8;
-			triangles = quadTriangles;
-			trianglesCount = 6;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_MESH: {
-			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(attachment, slot, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->verticesCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_SKINNED_MESH: {
-			spSkinnedMeshAttachment* attachment = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(attachment, slot, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->uvsCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		}
-		if (texture) {
-			if (slot->data->blendMode != blendMode) {
-				batch->flush();
-				blendMode = slot->data->blendMode;
-				switch (slot->data->blendMode) {
-				case SP_BLEND_MODE_ADDITIVE:
-					ccGLBlendFunc(premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
-					break;
-				case SP_BLEND_MODE_MULTIPLY:
-					ccGLBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
-					break;
-				case SP_BLEND_MODE_SCREEN:
-					ccGLBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-					break;
-				default:
-					ccGLBlendFunc(blendFunc.src, blendFunc.dst);
-				}
+	for (int i = 0, n = renderList->batchesCount; i < n; i++) {
+		const spRenderBatch* renderBatch = renderList->batches + i;
+		if (renderBatch->blendMode != blendMode) {
+			batch->flush();
+			blendMode = renderBatch->blendMode;
+			switch (renderBatch->blendMode) {
+			case SP_BLEND_MODE_ADDITIVE:
+				ccGLBlendFunc(premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
+				break;
+			case SP_BLEND_MODE_MULTIPLY:
+				ccGLBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
+				break;
+			case SP_BLEND_MODE_SCREEN:
+				ccGLBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+				break;
+			default:
+				ccGLBlendFunc(blendFunc.src, blendFunc.dst);
 			}
-			color.a = skeleton->a * slot->a * a * 255;
-			float multiplier = premultipliedAlpha ? color.a : 255;
-			color.r = skeleton->r * slot->r * r * multiplier;
-			color.g = skeleton->g * slot->g * g * multiplier;
-			color.b = skeleton->b * slot->b * b * multiplier;
-			batch->add(texture, worldVertices, uvs, verticesCount, triangles, trianglesCount, &color);
 		}
+		batch->add((CCTexture2D*)renderBatch->rendererObject, vertices + renderBatch->firstVertex, renderBatch->verticesCount,
+			triangles + renderBatch->firstIndex, renderBatch->indicesCount);
 	}
 	batch->flush();
 
@@ -232,6 +179,7 @@ void SkeletonRenderer::draw () {
 		ccDrawColor4B(0, 0, 255, 255);
 		glLineWidth(1);
 		CCPoint points[4];
+		float worldVertices[8];
 		for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
 			spSlot* slot = skeleton->drawOrder[i];
 			if (!slot->attachment || slot->attachment->type != SP_ATTACHMENT_REGION) continue;
@@ -265,47 +213,37 @@ void SkeletonRenderer::draw () {
 	}
 }
 
-CCTexture2D* SkeletonRenderer::getTexture (spRegionAttachment* attachment) const {
-	return (CCTexture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
-
-CCTexture2D* SkeletonRenderer::getTexture (spMeshAttachment* attachment) const {
-	return (CCTexture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+void SkeletonRenderer::updateRenderList () {
+	if (!renderList || renderList->format.premultipliedAlpha != premultipliedAlpha) {
+		if (renderList) spRenderList_dispose(renderList);
+		spVertexFormat format;
+		format.stride = sizeof(ccV2F_C4B_T2F);
+		format.positionOffset = offsetof(ccV2F_C4B_T2F, vertices);
+		format.uvOffset = offsetof(ccV2F_C4B_T2F, texCoords);
+		format.colorOffset = offsetof(ccV2F_C4B_T2F, colors);
+		format.color = SP_VERTEX_COLOR_BYTES;
+		format.premultipliedAlpha = premultipliedAlpha;
+		format.indexSize = sizeof(GLushort);
+		format.maxBatchVertices = 65536;
+		renderList = spRenderList_create(&format);
+	}
+	spRenderList_updateSkeleton(renderList, skeleton);
+	renderListFrame = CCDirector::sharedDirector()->getTotalFrames();
+	renderListValid = true;
 }
 
-CCTexture2D* SkeletonRenderer::getTexture (spSkinnedMeshAttachment* attachment) const {
-	return (CCTexture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+void SkeletonRenderer::invalidateRenderList () {
+	renderListValid = false;
 }
 
 CCRect SkeletonRenderer::boundingBox () {
-	float minX = FLT_MAX, minY = FLT_MAX, maxX = FLT_MIN, maxY = FLT_MIN;
+	if (!renderList || !renderListValid || renderListFrame != CCDirector::sharedDirector()->getTotalFrames()) updateRenderList();
+	if (!renderList->verticesCount) return CCRect(getPositionX(), getPositionY(), 0, 0);
 	float scaleX = getScaleX(), scaleY = getScaleY();
-	for (int i = 0; i < skeleton->slotsCount; ++i) {
-		spSlot* slot = skeleton->slots[i];
-		if (!slot->attachment) continue;
-		int verticesCount;
-		if (slot->attachment->type == SP_ATTACHMENT_REGION) {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
-			verticesCount = 8;
-		} else if (slot->attachment->type == SP_ATTACHMENT_MESH) {
-			spMeshAttachment* mesh = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-			verticesCount = mesh->verticesCount;
-		} else if (slot->attachment->type == SP_ATTACHMENT_SKINNED_MESH) {
-			spSkinnedMeshAttachment* mesh = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-			verticesCount = mesh->uvsCount;
-		} else
-			continue;
-		for (int ii = 0; ii < verticesCount; ii += 2) {
-			float x = worldVertices[ii] * scaleX, y = worldVertices[ii + 1] * scaleY;
-			minX = min(minX, x);
-			minY = min(minY, y);
-			maxX = max(maxX, x);
-			maxY = max(maxY, y);
-		}
-	}
+	float minX = min(renderList->minX * scaleX, renderList->maxX * scaleX);
+	float maxX = max(renderList->minX * scaleX, renderList->maxX * scaleX);
+	float minY = min(renderList->minY * scaleY, renderList->maxY * scaleY);
+	float maxY = max(renderList->minY * scaleY, renderList->maxY * scaleY);
 	CCPoint position = getPosition();
 	return CCRect(position.x + minX, position.y + minY, maxX - minX, maxY - minY);
 }
@@ -314,16 +252,20 @@ CCRect SkeletonRenderer::boundingBox () {
 
 void SkeletonRenderer::updateWorldTransform () {
 	spSkeleton_updateWorldTransform(skeleton);
+	invalidateRenderList();
 }
 
 void SkeletonRenderer::setToSetupPose () {
 	spSkeleton_setToSetupPose(skeleton);
+	invalidateRenderList();
 }
 void SkeletonRenderer::setBonesToSetupPose () {
 	spSkeleton_setBonesToSetupPose(skeleton);
+	invalidateRenderList();
 }
 void SkeletonRenderer::setSlotsToSetupPose () {
 	spSkeleton_setSlotsToSetupPose(skeleton);
+	invalidateRenderList();
 }
 
 spBone* SkeletonRenderer::findBone (const char* boneName) const {
@@ -335,6 +277,7 @@ spSlot* SkeletonRenderer::findSlot (const char* slotName) const {
 }
 
 bool SkeletonRenderer::setSkin (const char* skinName) {
+	invalidateRenderList();
 	return spSkeleton_setSkinByName(skeleton, skinName) ? true : false;
 }
 
@@ -342,6 +285,7 @@ spAttachment* SkeletonRenderer::getAttachment (const char* slotName, const char*
 	return spSkeleton_getAttachmentForSlotName(skeleton, slotName, attachmentName);
 }
 bool SkeletonRenderer::setAttachment (const char* slotName, const char* attachmentName) {
+	invalidateRenderList();
 	return spSkeleton_setAttachment(skeleton, slotName, attachmentName) ? true : false;
 }
 
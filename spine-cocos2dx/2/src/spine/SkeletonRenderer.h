@@ -94,16 +94,23 @@ public:
 protected:
 	SkeletonRenderer ();
 	void setSkeletonData (spSkeletonData* skeletonData, bool ownsSkeletonData);
-
-	virtual cocos2d::CCTexture2D* getTexture (spRegionAttachment* attachment) const;
-	virtual cocos2d::CCTexture2D* getTexture (spMeshAttachment* attachment) const;
-	virtual cocos2d::CCTexture2D* getTexture (spSkinnedMeshAttachment* attachment) const;
+	/* Updates the render list from the skeleton's current world transform. UVs and indices are rebuilt only when the attachments or
+	 * draw order changed. */
+	void updateRenderList ();
+	/* Marks the render list and the bounding box taken from it as stale. Called whenever the renderer changes the pose. */
+	void invalidateRenderList ();
+
+	spRenderList* renderList;
+	/* The frame the render list was last updated in. boundingBox reuses it for the rest of that frame unless invalidated. */
+	unsigned int renderListFrame;
+	bool renderListValid;
+	PolygonBatch* batch;
 
 private:
 	bool ownsSkeletonData;
 	spAtlas* atlas;
-	PolygonBatch* batch;
-	float* worldVertices;
+	/* The cache the skeleton data was acquired from, or null. */
+	spAssetCache* assetCache;
 	void initialize ();
 };
 
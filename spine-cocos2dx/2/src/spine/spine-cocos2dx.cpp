@@ -53,3 +53,66 @@ char* _spUtil_readFile (const char* path, int* length) {
 	*length = size;
 	return data;
 }
+
+namespace spine {
+
+void createImposterTextures (spImposter* imposter) {
+	for (int i = 0; i < imposter->pagesCount; ++i) {
+		spImposterPage* page = imposter->pages + i;
+		if (page->rendererObject) continue;
+		CCTexture2D* texture = new CCTexture2D();
+		texture->initWithData(page->pixels, kCCTexture2DPixelFormat_RGBA8888, page->width, page->height,
+			CCSizeMake((float)page->width, (float)page->height));
+		page->rendererObject = texture;
+	}
+}
+
+void disposeImposterTextures (spImposter* imposter) {
+	for (int i = 0; i < imposter->pagesCount; ++i) {
+		spImposterPage* page = imposter->pages + i;
+		if (!page->rendererObject) continue;
+		((CCTexture2D*)page->rendererObject)->release();
+		page->rendererObject = 0;
+	}
+}
+
+/**/
+
+static void* decodeAtlasPage (spLoadJob* job, spAtlasPage* page, const char* path) {
+	CCImage* image = new CCImage();
+	if (!image->initWithImageFileThreadSafe(CCFileUtils::sharedFileUtils()->fullPathForFilename(path).c_str())) {
+		image->release();
+		return 0;
+	}
+	page->width = image->getWidth();
+	page->height = image->getHeight();
+	return image;
+}
+
+static void uploadAtlasPage (spLoadJob* job, spAtlasPage* page, void* image) {
+	char* path = _spAtlas_getTexturePath(page->atlas, page);
+	CCTexture2D* texture = CCTextureCache::sharedTextureCache()->addUIImage((CCImage*)image, path);
+	FREE(path);
+	if (!texture) return;
+	texture->retain();
+	page->rendererObject = texture;
+}
+
+static void disposeAtlasImage (spLoadJob* job, void* image) {
+	((CCImage*)image)->release();
+}
+
+spLoadJob* createLoadJob (const char* atlasPath, const char* skeletonPath) {
+	spLoadJob* job = spLoadJob_create(atlasPath, skeletonPath);
+	job->decodePage = decodeAtlasPage;
+	job->uploadPage = uploadAtlasPage;
+	job->disposeImage = disposeAtlasImage;
+	return job;
+}
+
+spAssetCache* getAssetCache () {
+	static spAssetCache* cache = spAssetCache_create();
+	return cache;
+}
+
+}
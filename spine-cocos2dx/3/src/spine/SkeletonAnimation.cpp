@@ -97,10 +97,13 @@ void SkeletonAnimation::initialize () {
 
 	_spAnimationState* stateInternal = (_spAnimationState*)_state;
 	stateInternal->disposeTrackEntry = disposeTrackEntry;
+
+	_imposter = nullptr;
+	_imposterScale = 0;
 }
 
 SkeletonAnimation::SkeletonAnimation ()
-		: SkeletonRenderer() {
+		: SkeletonRenderer(), _imposter(nullptr), _imposterScale(0) {
 }
 
 SkeletonAnimation::SkeletonAnimation (spSkeletonData *skeletonData, bool ownsSkeletonData)
@@ -130,6 +133,62 @@ void SkeletonAnimation::update (float deltaTime) {
 	spAnimationState_update(_state, deltaTime);
 	spAnimationState_apply(_state, _skeleton);
 	spSkeleton_updateWorldTransform(_skeleton);
+	invalidateRenderList();
+}
+
+void SkeletonAnimation::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	if (_imposter && drawImposter(renderer, transform, transformFlags)) return;
+	super::draw(renderer, transform, transformFlags);
+}
+
+bool SkeletonAnimation::drawImposter (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	float scale = sqrtf(fabsf(transform.m[0] * transform.m[5] - transform.m[1] * transform.m[4]));
+	if (scale > _imposterScale || !_state->tracksCount || !_state->tracks[0]) return false;
+
+	spTrackEntry* entry = _state->tracks[0];
+	const spImposterFrame* frame = spImposter_getFrame(_imposter, entry->animation, entry->time, entry->loop);
+	if (!frame) return false;
+
+	const spImposterPage* page = _imposter->pages + frame->page;
+	float x = _skeleton->x + frame->offsetX, y = _skeleton->y + frame->offsetY;
+	float width = frame->width / _imposter->scale, height = frame->height / _imposter->scale;
+	float u = frame->x / (float)page->width, v = frame->y / (float)page->height;
+	float u2 = (frame->x + frame->width) / (float)page->width, v2 = (frame->y + frame->height) / (float)page->height;
+	Color3B nodeColor = getColor();
+	GLubyte alpha = getDisplayedOpacity();
+	Color4B color(nodeColor.r, nodeColor.g, nodeColor.b, alpha);
+	if (_imposter->premultipliedAlpha) {
+		color.r = color.r * alpha / 255;
+		color.g = color.g * alpha / 255;
+		color.b = color.b * alpha / 255;
+	}
+	_imposterVertices[0].vertices = Vec3(x, y, 0);
+	_imposterVertices[0].texCoords = Tex2F(u, v);
+	_imposterVertices[1].vertices = Vec3(x + width, y, 0);
+	_imposterVertices[1].texCoords = Tex2F(u2, v);
+	_imposterVertices[2].vertices = Vec3(x + width, y + height, 0);
+	_imposterVertices[2].texCoords = Tex2F(u2, v2);
+	_imposterVertices[3].vertices = Vec3(x, y + height, 0);
+	_imposterVertices[3].texCoords = Tex2F(u, v2);
+	for (int i = 0; i < 4; ++i)
+		_imposterVertices[i].colors = color;
+
+	static GLushort quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+	TrianglesCommand::Triangles triangles;
+	triangles.verts = _imposterVertices;
+	triangles.vertCount = 4;
+	triangles.indices = quadTriangles;
+	triangles.indexCount = 6;
+	_imposterCommand.init(_globalZOrder, ((Texture2D*)page->rendererObject)->getName(), getGLProgramState(),
+		_imposter->premultipliedAlpha ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED, triangles, transform,
+		transformFlags);
+	renderer->addCommand(&_imposterCommand);
+	return true;
+}
+
+void SkeletonAnimation::setImposter (const spImposter* imposter, float scale) {
+	_imposter = imposter;
+	_imposterScale = scale;
 }
 
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
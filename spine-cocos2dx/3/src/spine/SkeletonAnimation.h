@@ -52,6 +52,12 @@ public:
 	static SkeletonAnimation* createWithFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale = 1);
 
 	virtual void update (float deltaTime);
+	virtual void draw (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags) override;
+
+	/** Draws the imposter's frame for track 0 instead of the skeleton while the node is drawn at the specified scale or smaller.
+	  * The imposter's pages must have textures, see createImposterTextures.
+	  * @param imposter May be null. */
+	void setImposter (const spImposter* imposter, float scale);
 
 	void setAnimationStateData (spAnimationStateData* stateData);
 	void setMix (const std::string& fromAnimation, const std::string& toAnimation, float duration);
@@ -95,6 +101,14 @@ protected:
 	CompleteListener _completeListener;
 	EventListener _eventListener;
 
+	const spImposter* _imposter;
+	float _imposterScale;
+	cocos2d::V3F_C4B_T2F _imposterVertices[4];
+	cocos2d::TrianglesCommand _imposterCommand;
+
+	/** Returns false if the skeleton must be drawn instead. */
+	bool drawImposter (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags);
+
 private:
 	typedef SkeletonRenderer super;
 };
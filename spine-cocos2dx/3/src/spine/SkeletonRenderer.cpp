@@ -32,7 +32,6 @@
 #include <spine/SkeletonRenderer.h>
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
-#include <spine/PolygonBatch.h>
 #include <algorithm>
 
 USING_NS_CC;
@@ -41,8 +40,6 @@ using std::max;
 
 namespace spine {
 
-static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
-
 SkeletonRenderer* SkeletonRenderer::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonRenderer* node = new SkeletonRenderer(skeletonData, ownsSkeletonData);
 	node->autorelease();
@@ -62,15 +59,15 @@ SkeletonRenderer* SkeletonRenderer::createWithFile (const std::string& skeletonD
 }
 
 void SkeletonRenderer::initialize () {
-	_worldVertices = MALLOC(float, 1000); // Max number of vertices per mesh.
-
-	_batch = PolygonBatch::createWithCapacity(2000); // Max number of vertices and triangles per batch.
-	_batch->retain();
+	_renderList = nullptr;
+	_renderListFrame = 0;
+	_renderListValid = false;
 
 	_blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 	setOpacityModifyRGB(true);
 
-	setGLProgram(ShaderCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR));
+	// The renderer transforms the vertices of TrianglesCommands.
+	setGLProgram(ShaderCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
 }
 
 void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsSkeletonData) {
@@ -79,30 +76,32 @@ void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsS
 }
 
 SkeletonRenderer::SkeletonRenderer ()
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _assetCache(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
 }
 
 SkeletonRenderer::SkeletonRenderer (spSkeletonData *skeletonData, bool ownsSkeletonData)
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _assetCache(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
 	initWithData(skeletonData, ownsSkeletonData);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, spAtlas* atlas, float scale)
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _assetCache(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
 	initWithFile(skeletonDataFile, atlas, scale);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, const std::string& atlasFile, float scale)
-	: _atlas(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _atlas(0), _assetCache(0), _debugSlots(false), _debugBones(false), _timeScale(1) {
 	initWithFile(skeletonDataFile, atlasFile, scale);
 }
 
 SkeletonRenderer::~SkeletonRenderer () {
-	if (_ownsSkeletonData) spSkeletonData_dispose(_skeleton->data);
+	if (_assetCache)
+		spAssetCache_releaseSkeletonData(_assetCache, _skeleton->data);
+	else if (_ownsSkeletonData)
+		spSkeletonData_dispose(_skeleton->data);
 	if (_atlas) spAtlas_dispose(_atlas);
 	spSkeleton_dispose(_skeleton);
-	_batch->release();
-	FREE(_worldVertices);
+	if (_renderList) spRenderList_dispose(_renderList);
 }
 
 void SkeletonRenderer::initWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
@@ -124,16 +123,12 @@ void SkeletonRenderer::initWithFile (const std::string& skeletonDataFile, spAtla
 }
 
 void SkeletonRenderer::initWithFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
-	_atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-	CCASSERT(_atlas, "Error reading atlas file.");
+	// Skeletons created from the same files share the skeleton data and atlas.
+	_assetCache = getAssetCache();
+	spSkeletonData* skeletonData = spAssetCache_acquireSkeletonData(_assetCache, skeletonDataFile.c_str(), atlasFile.c_str(), scale);
+	CCASSERT(skeletonData, _assetCache->error ? _assetCache->error : "Error reading skeleton data file.");
 
-	spSkeletonJson* json = spSkeletonJson_create(_atlas);
-	json->scale = scale;
-	spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, skeletonDataFile.c_str());
-	CCASSERT(skeletonData, json->error ? json->error : "Error reading skeleton data file.");
-	spSkeletonJson_dispose(json);
-
-	setSkeletonData(skeletonData, true);
+	setSkeletonData(skeletonData, false);
 
 	initialize();
 }
@@ -141,194 +136,136 @@ void SkeletonRenderer::initWithFile (const std::string& skeletonDataFile, const
 
 void SkeletonRenderer::update (float deltaTime) {
 	spSkeleton_update(_skeleton, deltaTime * _timeScale);
+	invalidateRenderList();
 }
 
 void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
-	_drawCommand.init(_globalZOrder);
-	_drawCommand.func = CC_CALLBACK_0(SkeletonRenderer::drawSkeleton, this, transform, transformFlags);
-	renderer->addCommand(&_drawCommand);
-}
-
-void SkeletonRenderer::drawSkeleton (const Mat4 &transform, uint32_t transformFlags) {
-	getGLProgramState()->apply(transform);
-
 	Color3B nodeColor = getColor();
 	_skeleton->r = nodeColor.r / (float)255;
 	_skeleton->g = nodeColor.g / (float)255;
 	_skeleton->b = nodeColor.b / (float)255;
 	_skeleton->a = getDisplayedOpacity() / (float)255;
 
-	int blendMode = -1;
-	Color4B color;
-	const float* uvs = nullptr;
-	int verticesCount = 0;
-	const int* triangles = nullptr;
-	int trianglesCount = 0;
-	float r = 0, g = 0, b = 0, a = 0;
-	for (int i = 0, n = _skeleton->slotsCount; i < n; i++) {
-		spSlot* slot = _skeleton->drawOrder[i];
-		if (!slot->attachment) continue;
-		Texture2D *texture = nullptr;
-		switch (slot->attachment->type) {
-		case SP_ATTACHMENT_REGION: {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = 8;
-			triangles = quadTriangles;
-			trianglesCount = 6;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
+	updateRenderList();
+
+	// The commands reference the render list, which is kept until the next draw.
+	if ((int)_drawCommands.size() < _renderList->batchesCount) _drawCommands.resize(_renderList->batchesCount);
+	V3F_C4B_T2F* vertices = (V3F_C4B_T2F*)_renderList->vertices;
+	GLushort* triangles = (GLushort*)_renderList->indices;
+	for (int i = 0, n = _renderList->batchesCount; i < n; i++) {
+		const spRenderBatch* batch = _renderList->batches + i;
+		BlendFunc blendFunc;
+		switch (batch->blendMode) {
+		case SP_BLEND_MODE_ADDITIVE:
+			blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+			blendFunc.dst = GL_ONE;
 			break;
-		}
-		case SP_ATTACHMENT_MESH: {
-			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(attachment, slot, _worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->verticesCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
+		case SP_BLEND_MODE_MULTIPLY:
+			blendFunc.src = GL_DST_COLOR;
+			blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
 			break;
-		}
-		case SP_ATTACHMENT_SKINNED_MESH: {
-			spSkinnedMeshAttachment* attachment = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(attachment, slot, _worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->uvsCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
+		case SP_BLEND_MODE_SCREEN:
+			blendFunc.src = GL_ONE;
+			blendFunc.dst = GL_ONE_MINUS_SRC_COLOR;
 			break;
+		default:
+			blendFunc = _blendFunc;
 		}
-		default: ;
-		} 
-		if (texture) {
-			if (slot->data->blendMode != blendMode) {
-				_batch->flush();
-				blendMode = slot->data->blendMode;
-				switch (slot->data->blendMode) {
-				case SP_BLEND_MODE_ADDITIVE:
-					GL::blendFunc(_premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
-					break;
-				case SP_BLEND_MODE_MULTIPLY:
-					GL::blendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
-					break;
-				case SP_BLEND_MODE_SCREEN:
-					GL::blendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-					break;
-				default:
-					GL::blendFunc(_blendFunc.src, _blendFunc.dst);
-				}
-			}
-			color.a = _skeleton->a * slot->a * a * 255;
-			float multiplier = _premultipliedAlpha ? color.a : 255;
-			color.r = _skeleton->r * slot->r * r * multiplier;
-			color.g = _skeleton->g * slot->g * g * multiplier;
-			color.b = _skeleton->b * slot->b * b * multiplier;
-			_batch->add(texture, _worldVertices, uvs, verticesCount, triangles, trianglesCount, &color);
-		}
+		TrianglesCommand::Triangles commandTriangles;
+		commandTriangles.verts = vertices + batch->firstVertex;
+		commandTriangles.vertCount = batch->verticesCount;
+		commandTriangles.indices = triangles + batch->firstIndex;
+		commandTriangles.indexCount = batch->indicesCount;
+		_drawCommands[i].init(_globalZOrder, ((Texture2D*)batch->rendererObject)->getName(), getGLProgramState(), blendFunc,
+			commandTriangles, transform, transformFlags);
+		renderer->addCommand(&_drawCommands[i]);
 	}
-	_batch->flush();
 
 	if (_debugSlots || _debugBones) {
-		Director* director = Director::getInstance();
-		director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-		director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, transform);
-
-		if (_debugSlots) {
-			// Slots.
-			DrawPrimitives::setDrawColor4B(0, 0, 255, 255);
-			glLineWidth(1);
-			Vec2 points[4];
-			V3F_C4B_T2F_Quad quad;
-			for (int i = 0, n = _skeleton->slotsCount; i < n; i++) {
-				spSlot* slot = _skeleton->drawOrder[i];
-				if (!slot->attachment || slot->attachment->type != SP_ATTACHMENT_REGION) continue;
-				spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-				spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices);
-				points[0] = Vec2(_worldVertices[0], _worldVertices[1]);
-				points[1] = Vec2(_worldVertices[2], _worldVertices[3]);
-				points[2] = Vec2(_worldVertices[4], _worldVertices[5]);
-				points[3] = Vec2(_worldVertices[6], _worldVertices[7]);
-				DrawPrimitives::drawPoly(points, 4, true);
-			}
-		}
-		if (_debugBones) {
-			// Bone lengths.
-			glLineWidth(2);
-			DrawPrimitives::setDrawColor4B(255, 0, 0, 255);
-			for (int i = 0, n = _skeleton->bonesCount; i < n; i++) {
-				spBone *bone = _skeleton->bones[i];
-				float x = bone->data->length * bone->m00 + bone->worldX;
-				float y = bone->data->length * bone->m10 + bone->worldY;
-				DrawPrimitives::drawLine(Vec2(bone->worldX, bone->worldY), Vec2(x, y));
-			}
-			// Bone origins.
-			DrawPrimitives::setPointSize(4);
-			DrawPrimitives::setDrawColor4B(0, 0, 255, 255); // Root bone is blue.
-			for (int i = 0, n = _skeleton->bonesCount; i < n; i++) {
-				spBone *bone = _skeleton->bones[i];
-				DrawPrimitives::drawPoint(Vec2(bone->worldX, bone->worldY));
-				if (i == 0) DrawPrimitives::setDrawColor4B(0, 255, 0, 255);
-			}
-		}
-		director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+		_debugCommand.init(_globalZOrder);
+		_debugCommand.func = CC_CALLBACK_0(SkeletonRenderer::drawDebug, this, transform, transformFlags);
+		renderer->addCommand(&_debugCommand);
 	}
 }
 
-Texture2D* SkeletonRenderer::getTexture (spRegionAttachment* attachment) const {
-	return (Texture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
-}
-
-Texture2D* SkeletonRenderer::getTexture (spMeshAttachment* attachment) const {
-	return (Texture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+void SkeletonRenderer::drawDebug (const Mat4 &transform, uint32_t transformFlags) {
+	Director* director = Director::getInstance();
+	director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+	director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, transform);
+
+	if (_debugSlots) {
+		// Slots.
+		DrawPrimitives::setDrawColor4B(0, 0, 255, 255);
+		glLineWidth(1);
+		Vec2 points[4];
+		float worldVertices[8];
+		for (int i = 0, n = _skeleton->slotsCount; i < n; i++) {
+			spSlot* slot = _skeleton->drawOrder[i];
+			if (!slot->attachment || slot->attachment->type != SP_ATTACHMENT_REGION) continue;
+			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
+			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
+			points[0] = Vec2(worldVertices[0], worldVertices[1]);
+			points[1] = Vec2(worldVertices[2], worldVertices[3]);
+			points[2] = Vec2(worldVertices[4], worldVertices[5]);
+			points[3] = Vec2(worldVertices[6], worldVertices[7]);
+			DrawPrimitives::drawPoly(points, 4, true);
+		}
+	}
+	if (_debugBones) {
+		// Bone lengths.
+		glLineWidth(2);
+		DrawPrimitives::setDrawColor4B(255, 0, 0, 255);
+		for (int i = 0, n = _skeleton->bonesCount; i < n; i++) {
+			spBone *bone = _skeleton->bones[i];
+			float x = bone->data->length * bone->m00 + bone->worldX;
+			float y = bone->data->length * bone->m10 + bone->worldY;
+			DrawPrimitives::drawLine(Vec2(bone->worldX, bone->worldY), Vec2(x, y));
+		}
+		// Bone origins.
+		DrawPrimitives::setPointSize(4);
+		DrawPrimitives::setDrawColor4B(0, 0, 255, 255); // Root bone is blue.
+		for (int i = 0, n = _skeleton->bonesCount; i < n; i++) {
+			spBone *bone = _skeleton->bones[i];
+			DrawPrimitives::drawPoint(Vec2(bone->worldX, bone->worldY));
+			if (i == 0) DrawPrimitives::setDrawColor4B(0, 255, 0, 255);
+		}
+	}
+	director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+
+void SkeletonRenderer::updateRenderList () const {
+	if (!_renderList || _renderList->format.premultipliedAlpha != _premultipliedAlpha) {
+		if (_renderList) spRenderList_dispose(_renderList);
+		spVertexFormat format;
+		format.stride = sizeof(V3F_C4B_T2F);
+		format.positionOffset = offsetof(V3F_C4B_T2F, vertices);
+		format.uvOffset = offsetof(V3F_C4B_T2F, texCoords);
+		format.colorOffset = offsetof(V3F_C4B_T2F, colors);
+		format.color = SP_VERTEX_COLOR_BYTES;
+		format.premultipliedAlpha = _premultipliedAlpha;
+		format.indexSize = sizeof(GLushort);
+		// Each TrianglesCommand must fit in the renderer's vertex and index buffers.
+		format.maxBatchVertices = Renderer::VBO_SIZE;
+		format.maxBatchIndices = Renderer::INDEX_VBO_SIZE;
+		_renderList = spRenderList_create(&format);
+	}
+	spRenderList_updateSkeleton(_renderList, _skeleton);
+	_renderListFrame = Director::getInstance()->getTotalFrames();
+	_renderListValid = true;
 }
 
-Texture2D* SkeletonRenderer::getTexture (spSkinnedMeshAttachment* attachment) const {
-	return (Texture2D*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+void SkeletonRenderer::invalidateRenderList () {
+	_renderListValid = false;
 }
 
 Rect SkeletonRenderer::getBoundingBox () const {
-	float minX = FLT_MAX, minY = FLT_MAX, maxX = FLT_MIN, maxY = FLT_MIN;
+	if (!_renderList || !_renderListValid || _renderListFrame != Director::getInstance()->getTotalFrames()) updateRenderList();
+	if (!_renderList->verticesCount) return Rect(getPosition(), Size::ZERO);
 	float scaleX = getScaleX(), scaleY = getScaleY();
-	for (int i = 0; i < _skeleton->slotsCount; ++i) {
-		spSlot* slot = _skeleton->slots[i];
-		if (!slot->attachment) continue;
-		int verticesCount;
-		if (slot->attachment->type == SP_ATTACHMENT_REGION) {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices);
-			verticesCount = 8;
-		} else if (slot->attachment->type == SP_ATTACHMENT_MESH) {
-			spMeshAttachment* mesh = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(mesh, slot, _worldVertices);
-			verticesCount = mesh->verticesCount;
-		} else if (slot->attachment->type == SP_ATTACHMENT_SKINNED_MESH) {
-			spSkinnedMeshAttachment* mesh = (spSkinnedMeshAttachment*)slot->attachment;
-			spSkinnedMeshAttachment_computeWorldVertices(mesh, slot, _worldVertices);
-			verticesCount = mesh->uvsCount;
-		} else
-			continue;
-		for (int ii = 0; ii < verticesCount; ii += 2) {
-			float x = _worldVertices[ii] * scaleX, y = _worldVertices[ii + 1] * scaleY;
-			minX = min(minX, x);
-			minY = min(minY, y);
-			maxX = max(maxX, x);
-			maxY = max(maxY, y);
-		}
-	}
+	float minX = min(_renderList->minX * scaleX, _renderList->maxX * scaleX);
+	float maxX = max(_renderList->minX * scaleX, _renderList->maxX * scaleX);
+	float minY = min(_renderList->minY * scaleY, _renderList->maxY * scaleY);
+	float maxY = max(_renderList->minY * scaleY, _renderList->maxY * scaleY);
 	Vec2 position = getPosition();
 	return Rect(position.x + minX, position.y + minY, maxX - minX, maxY - minY);
 }
@@ -337,16 +274,20 @@ Rect SkeletonRenderer::getBoundingBox () const {
 
 void SkeletonRenderer::updateWorldTransform () {
 	spSkeleton_updateWorldTransform(_skeleton);
+	invalidateRenderList();
 }
 
 void SkeletonRenderer::setToSetupPose () {
 	spSkeleton_setToSetupPose(_skeleton);
+	invalidateRenderList();
 }
 void SkeletonRenderer::setBonesToSetupPose () {
 	spSkeleton_setBonesToSetupPose(_skeleton);
+	invalidateRenderList();
 }
 void SkeletonRenderer::setSlotsToSetupPose () {
 	spSkeleton_setSlotsToSetupPose(_skeleton);
+	invalidateRenderList();
 }
 
 spBone* SkeletonRenderer::findBone (const std::string& boneName) const {
@@ -358,9 +299,11 @@ spSlot* SkeletonRenderer::findSlot (const std::string& slotName) const {
 }
 
 bool SkeletonRenderer::setSkin (const std::string& skinName) {
+	invalidateRenderList();
 	return spSkeleton_setSkinByName(_skeleton, skinName.empty() ? 0 : skinName.c_str()) ? true : false;
 }
 bool SkeletonRenderer::setSkin (const char* skinName) {
+	invalidateRenderList();
 	return spSkeleton_setSkinByName(_skeleton, skinName) ? true : false;
 }
 
@@ -368,9 +311,11 @@ spAttachment* SkeletonRenderer::getAttachment (const std::string& slotName, cons
 	return spSkeleton_getAttachmentForSlotName(_skeleton, slotName.c_str(), attachmentName.c_str());
 }
 bool SkeletonRenderer::setAttachment (const std::string& slotName, const std::string& attachmentName) {
+	invalidateRenderList();
 	return spSkeleton_setAttachment(_skeleton, slotName.c_str(), attachmentName.empty() ? 0 : attachmentName.c_str()) ? true : false;
 }
 bool SkeletonRenderer::setAttachment (const std::string& slotName, const char* attachmentName) {
+	invalidateRenderList();
 	return spSkeleton_setAttachment(_skeleton, slotName.c_str(), attachmentName) ? true : false;
 }
 
@@ -34,12 +34,12 @@
 
 #include <spine/spine.h>
 #include "cocos2d.h"
+#include <vector>
 
 namespace spine {
 
-class PolygonBatch;
-
-/** Draws a skeleton. */
+/** Draws a skeleton. Each batch of the skeleton's render list is submitted as a TrianglesCommand, so the renderer can draw
+ * consecutive skeletons and sprites that use the same texture, shader and blend function with one draw call. */
 class SkeletonRenderer: public cocos2d::Node, public cocos2d::BlendProtocol {
 public:
 	static SkeletonRenderer* createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData = false);
@@ -48,7 +48,8 @@ public:
 
 	virtual void update (float deltaTime) override;
 	virtual void draw (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags) override;
-	virtual void drawSkeleton (const cocos2d::Mat4& transform, uint32_t transformFlags);
+	/* Draws the debug slots and bones. Called from a CustomCommand queued after the skeleton's TrianglesCommands. */
+	virtual void drawDebug (const cocos2d::Mat4& transform, uint32_t transformFlags);
 	virtual cocos2d::Rect getBoundingBox () const override;
 	virtual void onEnter () override;
 	virtual void onExit () override;
@@ -113,16 +114,23 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
 	void setSkeletonData (spSkeletonData* skeletonData, bool ownsSkeletonData);
-	virtual cocos2d::Texture2D* getTexture (spRegionAttachment* attachment) const;
-	virtual cocos2d::Texture2D* getTexture (spMeshAttachment* attachment) const;
-	virtual cocos2d::Texture2D* getTexture (spSkinnedMeshAttachment* attachment) const;
+	/* Updates the render list from the skeleton's current world transform. UVs and indices are rebuilt only when the attachments or
+	 * draw order changed. */
+	void updateRenderList () const;
+	/* Marks the render list and the bounding box taken from it as stale. Called whenever the renderer changes the pose. */
+	void invalidateRenderList ();
 
 	bool _ownsSkeletonData;
 	spAtlas* _atlas;
-	cocos2d::CustomCommand _drawCommand;
+	/* The cache the skeleton data was acquired from, or null. */
+	spAssetCache* _assetCache;
+	std::vector<cocos2d::TrianglesCommand> _drawCommands;
+	cocos2d::CustomCommand _debugCommand;
 	cocos2d::BlendFunc _blendFunc;
-	PolygonBatch* _batch;
-	float* _worldVertices;
+	mutable spRenderList* _renderList;
+	/* The frame the render list was last updated in. getBoundingBox reuses it for the rest of that frame unless invalidated. */
+	mutable unsigned int _renderListFrame;
+	mutable bool _renderListValid;
 	bool _premultipliedAlpha;
 	spSkeleton* _skeleton;
 	float _timeScale;
@@ -31,6 +31,10 @@
 
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 USING_NS_CC;
 
@@ -54,3 +58,87 @@ char* _spUtil_readFile (const char* path, int* length) {
 	memcpy(bytes, data.getBytes(), *length);
 	return bytes;
 }
+
+namespace spine {
+
+void createImposterTextures (spImposter* imposter) {
+	for (int i = 0; i < imposter->pagesCount; ++i) {
+		spImposterPage* page = imposter->pages + i;
+		if (page->rendererObject) continue;
+		Texture2D* texture = new Texture2D();
+		texture->initWithData(page->pixels, page->width * page->height * 4, Texture2D::PixelFormat::RGBA8888, page->width,
+			page->height, Size((float)page->width, (float)page->height));
+		page->rendererObject = texture;
+	}
+}
+
+void disposeImposterTextures (spImposter* imposter) {
+	for (int i = 0; i < imposter->pagesCount; ++i) {
+		spImposterPage* page = imposter->pages + i;
+		if (!page->rendererObject) continue;
+		((Texture2D*)page->rendererObject)->release();
+		page->rendererObject = 0;
+	}
+}
+
+/**/
+
+static void* decodeAtlasPage (spLoadJob* job, spAtlasPage* page, const char* path) {
+	Image* image = new Image();
+	if (!image->initWithImageFile(path)) {
+		image->release();
+		return 0;
+	}
+	page->width = image->getWidth();
+	page->height = image->getHeight();
+	return image;
+}
+
+static void uploadAtlasPage (spLoadJob* job, spAtlasPage* page, void* image) {
+	char* path = _spAtlas_getTexturePath(page->atlas, page);
+	Texture2D* texture = Director::getInstance()->getTextureCache()->addImage((Image*)image, path);
+	FREE(path);
+	if (!texture) return;
+	texture->retain();
+	page->rendererObject = texture;
+}
+
+static void disposeAtlasImage (spLoadJob* job, void* image) {
+	((Image*)image)->release();
+}
+
+spLoadJob* createLoadJob (const char* atlasPath, const char* skeletonPath) {
+	spLoadJob* job = spLoadJob_create(atlasPath, skeletonPath);
+	job->decodePage = decodeAtlasPage;
+	job->uploadPage = uploadAtlasPage;
+	job->disposeImage = disposeAtlasImage;
+	job->parallelFor = parallelFor;
+	return job;
+}
+
+void parallelFor (int count, spParallelTask task, void* context) {
+	std::atomic<int> next(0);
+	auto run = [&]() {
+		for (int index; (index = next++) < count;)
+			task(context, index);
+	};
+	int threadsCount = std::min(count, (int)std::max(1u, std::thread::hardware_concurrency())) - 1;
+	std::vector<std::thread> threads;
+	threads.reserve(threadsCount);
+	for (int i = 0; i < threadsCount; ++i)
+		threads.emplace_back(run);
+	run();
+	for (auto& thread : threads)
+		thread.join();
+}
+
+spAssetCache* getAssetCache () {
+	static spAssetCache* cache = nullptr;
+	if (!cache) {
+		cache = spAssetCache_create();
+		cache->parallelFor = parallelFor;
+	}
+	return cache;
+}
+
+}
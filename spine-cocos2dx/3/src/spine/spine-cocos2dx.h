@@ -37,4 +37,27 @@
 #include <spine/SkeletonRenderer.h>
 #include <spine/SkeletonAnimation.h>
 
+namespace spine {
+
+/** Creates a texture from the pixels of each imposter page and sets it as the page's rendererObject. */
+void createImposterTextures (spImposter* imposter);
+/** Releases the textures created by createImposterTextures. Must be called before spImposter_dispose. */
+void disposeImposterTextures (spImposter* imposter);
+
+/** Creates a job that loads an atlas and skeleton data without blocking. spLoadJob_run decodes the page images and can be run on
+  * any thread, spLoadJob_update adds the textures to the texture cache and must be called on the GL thread, for example from a
+  * scheduled update. */
+spLoadJob* createLoadJob (const char* atlasPath, const char* skeletonPath);
+
+/** Calls the task on the calling thread and one std::thread per additional core. The asset cache and the jobs created here use it
+  * to read the animations of a skeleton file in parallel, it can also be set as the parallelFor of an spSkeletonJson. */
+void parallelFor (int count, spParallelTask task, void* context);
+
+/** Returns the cache shared by the skeletons created from files, so each skeleton data and atlas file is only read once. Call
+  * spAssetCache_preload to load assets ahead of time and spAssetCache_purge to free those no skeleton is using, for example after
+  * a scene change. Must only be used on the GL thread. */
+spAssetCache* getAssetCache ();
+
+}
+
 #endif /* SPINE_COCOS2DX_H_ */
@@ -36,10 +36,12 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
-
-#ifndef SPINE_MESH_VERTEX_COUNT_MAX
-#define SPINE_MESH_VERTEX_COUNT_MAX 1000
-#endif
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Thread.hpp>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
 
 using namespace sf;
 
@@ -65,13 +67,51 @@ char* _Util_readFile (const char* path, int* length){
 
 namespace spine {
 
+static RenderList* createRenderList () {
+	VertexFormat format;
+	format.stride = sizeof(Vertex);
+	format.positionOffset = offsetof(Vertex, position);
+	format.uvOffset = offsetof(Vertex, texCoords);
+	format.colorOffset = offsetof(Vertex, color);
+	format.color = VERTEX_COLOR_BYTES;
+	format.pixelUVs = true; // SFML texture coordinates are in pixels, cached per attachment by the render list.
+	format.triangleList = true; // SFML doesn't draw indexed vertices.
+	return RenderList_create(&format);
+}
+
+/* Returns the number of draw calls. */
+static int drawRenderList (RenderTarget& target, RenderStates states, const RenderList* renderList) {
+	const Vertex* vertices = (const Vertex*)renderList->vertices;
+	for (int i = 0; i < renderList->batchesCount; ++i) {
+		const RenderBatch* batch = renderList->batches + i;
+		switch (batch->blendMode) {
+		case BLEND_MODE_ADDITIVE:
+			states.blendMode = BlendAdd;
+			break;
+		case BLEND_MODE_MULTIPLY:
+			states.blendMode = BlendMultiply;
+			break;
+		case BLEND_MODE_SCREEN: // Unsupported, fall through.
+		default:
+			states.blendMode = BlendAlpha;
+		}
+		states.texture = (Texture*)batch->rendererObject;
+		target.draw(vertices + batch->firstVertex, batch->verticesCount, Triangles, states);
+	}
+	return renderList->batchesCount;
+}
+
+/**/
+
 SkeletonDrawable::SkeletonDrawable (SkeletonData* skeletonData, AnimationStateData* stateData) :
 				timeScale(1),
-				vertexArray(new VertexArray(Triangles, skeletonData->bonesCount * 4)),
-				worldVertices(0) {
-	Bone_setYDown(true);
-	worldVertices = MALLOC(float, SPINE_MESH_VERTEX_COUNT_MAX);
+				imposter(0),
+				imposterScale(0) {
 	skeleton = Skeleton_create(skeletonData);
+	skeleton->yDown = true;
+
+	renderList = createRenderList();
+	RenderList_reserveForSkeletonData(renderList, skeletonData, 1);
 
 	ownsAnimationStateData = stateData == 0;
 	if (ownsAnimationStateData) stateData = AnimationStateData_create(skeletonData);
@@ -80,8 +120,7 @@ SkeletonDrawable::SkeletonDrawable (SkeletonData* skeletonData, AnimationStateDa
 }
 
 SkeletonDrawable::~SkeletonDrawable () {
-	delete vertexArray;
-	FREE(worldVertices);
+	RenderList_dispose(renderList);
     if (ownsAnimationStateData) AnimationStateData_dispose(state->data);
 	AnimationState_dispose(state);
 	Skeleton_dispose(skeleton);
@@ -95,145 +134,241 @@ void SkeletonDrawable::update (float deltaTime) {
 }
 
 void SkeletonDrawable::draw (RenderTarget& target, RenderStates states) const {
-	vertexArray->clear();
+	if (imposter && drawImposter(target, states)) return;
+	RenderList_updateSkeleton(renderList, skeleton);
+	drawRenderList(target, states, renderList);
+}
 
-	sf::Vertex vertices[4];
-	sf::Vertex vertex;
-	for (int i = 0; i < skeleton->slotsCount; ++i) {
-		Slot* slot = skeleton->drawOrder[i];
-		Attachment* attachment = slot->attachment;
-		if (!attachment) continue;
+bool SkeletonDrawable::drawImposter (RenderTarget& target, RenderStates states) const {
+	const float* matrix = states.transform.getMatrix();
+	float scale = sqrtf(fabsf(matrix[0] * matrix[5] - matrix[1] * matrix[4]));
+	if (scale > imposterScale || !state->tracksCount || !state->tracks[0]) return false;
 
-		sf::BlendMode blend;
-		switch (slot->data->blendMode) {
-		case BLEND_MODE_ADDITIVE:
-			blend = BlendAdd;
-			break;
-		case BLEND_MODE_MULTIPLY:
-			blend = BlendMultiply;
-			break;
-		case BLEND_MODE_SCREEN: // Unsupported, fall through.
-		default:
-			blend = BlendAlpha;
-		}
-		if (states.blendMode != blend) {
-			target.draw(*vertexArray, states);
-			vertexArray->clear();
-			states.blendMode = blend;
-		}
+	TrackEntry* entry = state->tracks[0];
+	const ImposterFrame* frame = Imposter_getFrame(imposter, entry->animation, entry->time, entry->loop);
+	if (!frame) return false;
 
-		Texture* texture = 0;
-		if (attachment->type == ATTACHMENT_REGION) {
-			RegionAttachment* regionAttachment = (RegionAttachment*)attachment;
-			texture = (Texture*)((AtlasRegion*)regionAttachment->rendererObject)->page->rendererObject;
-			RegionAttachment_computeWorldVertices(regionAttachment, slot->bone, worldVertices);
-
-			Uint8 r = static_cast<Uint8>(skeleton->r * slot->r * 255);
-			Uint8 g = static_cast<Uint8>(skeleton->g * slot->g * 255);
-			Uint8 b = static_cast<Uint8>(skeleton->b * slot->b * 255);
-			Uint8 a = static_cast<Uint8>(skeleton->a * slot->a * 255);
-
-			Vector2u size = texture->getSize();
-			vertices[0].color.r = r;
-			vertices[0].color.g = g;
-			vertices[0].color.b = b;
-			vertices[0].color.a = a;
-			vertices[0].position.x = worldVertices[VERTEX_X1];
-			vertices[0].position.y = worldVertices[VERTEX_Y1];
-			vertices[0].texCoords.x = regionAttachment->uvs[VERTEX_X1] * size.x;
-			vertices[0].texCoords.y = regionAttachment->uvs[VERTEX_Y1] * size.y;
-
-			vertices[1].color.r = r;
-			vertices[1].color.g = g;
-			vertices[1].color.b = b;
-			vertices[1].color.a = a;
-			vertices[1].position.x = worldVertices[VERTEX_X2];
-			vertices[1].position.y = worldVertices[VERTEX_Y2];
-			vertices[1].texCoords.x = regionAttachment->uvs[VERTEX_X2] * size.x;
-			vertices[1].texCoords.y = regionAttachment->uvs[VERTEX_Y2] * size.y;
-
-			vertices[2].color.r = r;
-			vertices[2].color.g = g;
-			vertices[2].color.b = b;
-			vertices[2].color.a = a;
-			vertices[2].position.x = worldVertices[VERTEX_X3];
-			vertices[2].position.y = worldVertices[VERTEX_Y3];
-			vertices[2].texCoords.x = regionAttachment->uvs[VERTEX_X3] * size.x;
-			vertices[2].texCoords.y = regionAttachment->uvs[VERTEX_Y3] * size.y;
-
-			vertices[3].color.r = r;
-			vertices[3].color.g = g;
-			vertices[3].color.b = b;
-			vertices[3].color.a = a;
-			vertices[3].position.x = worldVertices[VERTEX_X4];
-			vertices[3].position.y = worldVertices[VERTEX_Y4];
-			vertices[3].texCoords.x = regionAttachment->uvs[VERTEX_X4] * size.x;
-			vertices[3].texCoords.y = regionAttachment->uvs[VERTEX_Y4] * size.y;
-
-			vertexArray->append(vertices[0]);
-			vertexArray->append(vertices[1]);
-			vertexArray->append(vertices[2]);
-			vertexArray->append(vertices[0]);
-			vertexArray->append(vertices[2]);
-			vertexArray->append(vertices[3]);
-
-		} else if (attachment->type == ATTACHMENT_MESH) {
-			MeshAttachment* mesh = (MeshAttachment*)attachment;
-			if (mesh->verticesCount > SPINE_MESH_VERTEX_COUNT_MAX) continue;
-			texture = (Texture*)((AtlasRegion*)mesh->rendererObject)->page->rendererObject;
-			MeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-
-			Uint8 r = static_cast<Uint8>(skeleton->r * slot->r * 255);
-			Uint8 g = static_cast<Uint8>(skeleton->g * slot->g * 255);
-			Uint8 b = static_cast<Uint8>(skeleton->b * slot->b * 255);
-			Uint8 a = static_cast<Uint8>(skeleton->a * slot->a * 255);
-			vertex.color.r = r;
-			vertex.color.g = g;
-			vertex.color.b = b;
-			vertex.color.a = a;
-
-			Vector2u size = texture->getSize();
-			for (int i = 0; i < mesh->trianglesCount; ++i) {
-				int index = mesh->triangles[i] << 1;
-				vertex.position.x = worldVertices[index];
-				vertex.position.y = worldVertices[index + 1];
-				vertex.texCoords.x = mesh->uvs[index] * size.x;
-				vertex.texCoords.y = mesh->uvs[index + 1] * size.y;
-				vertexArray->append(vertex);
-			}
-
-		} else if (attachment->type == ATTACHMENT_SKINNED_MESH) {
-			SkinnedMeshAttachment* mesh = (SkinnedMeshAttachment*)attachment;
-			if (mesh->uvsCount > SPINE_MESH_VERTEX_COUNT_MAX) continue;
-			texture = (Texture*)((AtlasRegion*)mesh->rendererObject)->page->rendererObject;
-			SkinnedMeshAttachment_computeWorldVertices(mesh, slot, worldVertices);
-
-			Uint8 r = static_cast<Uint8>(skeleton->r * slot->r * 255);
-			Uint8 g = static_cast<Uint8>(skeleton->g * slot->g * 255);
-			Uint8 b = static_cast<Uint8>(skeleton->b * slot->b * 255);
-			Uint8 a = static_cast<Uint8>(skeleton->a * slot->a * 255);
-			vertex.color.r = r;
-			vertex.color.g = g;
-			vertex.color.b = b;
-			vertex.color.a = a;
-
-			Vector2u size = texture->getSize();
-			for (int i = 0; i < mesh->trianglesCount; ++i) {
-				int index = mesh->triangles[i] << 1;
-				vertex.position.x = worldVertices[index];
-				vertex.position.y = worldVertices[index + 1];
-				vertex.texCoords.x = mesh->uvs[index] * size.x;
-				vertex.texCoords.y = mesh->uvs[index + 1] * size.y;
-				vertexArray->append(vertex);
-			}
-		}
+	float x = skeleton->x + frame->offsetX, y = skeleton->y + frame->offsetY;
+	float width = frame->width / imposter->scale, height = frame->height / imposter->scale;
+	Vertex corners[4];
+	corners[0].position = Vector2f(x, y);
+	corners[0].texCoords = Vector2f((float)frame->x, (float)frame->y);
+	corners[1].position = Vector2f(x + width, y);
+	corners[1].texCoords = Vector2f((float)(frame->x + frame->width), (float)frame->y);
+	corners[2].position = Vector2f(x + width, y + height);
+	corners[2].texCoords = Vector2f((float)(frame->x + frame->width), (float)(frame->y + frame->height));
+	corners[3].position = Vector2f(x, y + height);
+	corners[3].texCoords = Vector2f((float)frame->x, (float)(frame->y + frame->height));
+	Color color((Uint8)(skeleton->r * 255), (Uint8)(skeleton->g * 255), (Uint8)(skeleton->b * 255), (Uint8)(skeleton->a * 255));
 
-		if (texture) {
-			// SMFL doesn't handle batching for us, so we'll just force a single texture per skeleton.
-			states.texture = texture;
-		}
+	static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+	Vertex vertices[6];
+	for (int i = 0; i < 6; ++i) {
+		vertices[i] = corners[quadTriangles[i]];
+		vertices[i].color = color;
+	}
+	states.texture = (Texture*)imposter->pages[frame->page].rendererObject;
+	states.blendMode = BlendAlpha;
+	target.draw(vertices, 6, Triangles, states);
+	return true;
+}
+
+/**/
+
+SkeletonBatch::SkeletonBatch () :
+				renderList(createRenderList()),
+				drawCalls(0),
+				verticesCount(0) {
+}
+
+SkeletonBatch::~SkeletonBatch () {
+	RenderList_dispose(renderList);
+}
+
+void SkeletonBatch::add (const Skeleton* skeleton, const Transform& transform, float z) {
+	Entry entry;
+	entry.skeleton = skeleton;
+	entry.transform = transform;
+	entry.z = z;
+	entries.push_back(entry);
+}
+
+void SkeletonBatch::clear () {
+	entries.clear();
+	RenderList_clearUVCache(renderList);
+}
+
+void SkeletonBatch::draw (RenderTarget& target, RenderStates states) const {
+	std::stable_sort(entries.begin(), entries.end(), compareZ);
+
+	RenderList_clear(renderList);
+	for (size_t i = 0; i < entries.size(); ++i) {
+		const Entry& entry = entries[i];
+		int start = renderList->verticesCount;
+		RenderList_addSkeleton(renderList, entry.skeleton);
+		Vertex* vertices = (Vertex*)renderList->vertices;
+		for (int ii = start; ii < renderList->verticesCount; ++ii)
+			vertices[ii].position = entry.transform.transformPoint(vertices[ii].position);
+	}
+
+	drawCalls = drawRenderList(target, states, renderList);
+	verticesCount = renderList->verticesCount;
+}
+
+bool SkeletonBatch::compareZ (const Entry& a, const Entry& b) {
+	return a.z < b.z;
+}
+
+int SkeletonBatch::getDrawCalls () const {
+	return drawCalls;
+}
+
+int SkeletonBatch::getVerticesCount () const {
+	return verticesCount;
+}
+
+/**/
+
+/* The pixels of the last atlas page read by createImposter, kept while its animations are rendered. */
+struct ImposterPixels {
+	Image image;
+	AtlasPage* page;
+};
+
+static const unsigned char* getImposterPixels (void* context, AtlasPage* page) {
+	ImposterPixels* pixels = (ImposterPixels*)context;
+	if (page != pixels->page) {
+		pixels->image = ((Texture*)page->rendererObject)->copyToImage();
+		pixels->page = page;
+	}
+	return pixels->image.getPixelsPtr();
+}
+
+static void createImposterTextures (Imposter* imposter) {
+	for (int i = 0; i < imposter->pagesCount; ++i) {
+		ImposterPage* page = imposter->pages + i;
+		Texture* texture = new Texture();
+		texture->create(page->width, page->height);
+		texture->update(page->pixels);
+		texture->setSmooth(true);
+		page->rendererObject = texture;
+	}
+}
+
+Imposter* createImposter (Skeleton* skeleton, Animation** animations, int animationsCount, float framesPerSecond, float scale) {
+	Imposter* imposter = Imposter_create(framesPerSecond, scale);
+	ImposterPixels pixels;
+	pixels.page = 0;
+	for (int i = 0; i < animationsCount; ++i)
+		Imposter_addAnimation(imposter, skeleton, animations[i], getImposterPixels, &pixels);
+	createImposterTextures(imposter);
+	return imposter;
+}
+
+bool saveImposter (const Imposter* imposter, const char* path) {
+	int length;
+	unsigned char* data = Imposter_writeBinary(imposter, &length);
+	FILE* file = fopen(path, "wb");
+	bool written = file && fwrite(data, 1, length, file) == (size_t)length;
+	if (file && fclose(file)) written = false;
+	_free(data);
+	return written;
+}
+
+Imposter* loadImposter (const char* path, const SkeletonData* skeletonData) {
+	Imposter* imposter = Imposter_createFromFile(path, skeletonData);
+	if (imposter) createImposterTextures(imposter);
+	return imposter;
+}
+
+void disposeImposter (Imposter* imposter) {
+	for (int i = 0; i < imposter->pagesCount; ++i)
+		delete (Texture*)imposter->pages[i].rendererObject;
+	Imposter_dispose(imposter);
+}
+
+/**/
+
+static void* decodeAtlasPage (LoadJob* job, AtlasPage* page, const char* path) {
+	Image* image = new Image();
+	if (!image->loadFromFile(path)) {
+		delete image;
+		return 0;
+	}
+	Vector2u size = image->getSize();
+	page->width = size.x;
+	page->height = size.y;
+	return image;
+}
+
+static void uploadAtlasPage (LoadJob* job, AtlasPage* page, void* image) {
+	Texture* texture = new Texture();
+	if (!texture->loadFromImage(*(Image*)image)) {
+		delete texture;
+		return;
+	}
+	texture->setSmooth(true);
+	page->rendererObject = texture;
+}
+
+static void disposeAtlasImage (LoadJob* job, void* image) {
+	delete (Image*)image;
+}
+
+LoadJob* createLoadJob (const char* atlasPath, const char* skeletonPath) {
+	LoadJob* job = LoadJob_create(atlasPath, skeletonPath);
+	job->decodePage = decodeAtlasPage;
+	job->uploadPage = uploadAtlasPage;
+	job->disposeImage = disposeAtlasImage;
+	job->parallelFor = parallelFor;
+	return job;
+}
+
+/* Threads started by parallelFor, in addition to the calling thread. */
+static const int PARALLEL_THREADS = 3;
+
+struct ParallelWork {
+	ParallelTask task;
+	void* context;
+	int count;
+	volatile int next;
+};
+
+static void runParallelWork (ParallelWork* work) {
+	for (;;) {
+		int index = _spAtomic_get(&work->next);
+		if (index >= work->count) return;
+		if (_spAtomic_compareAndSet(&work->next, index, index + 1)) work->task(work->context, index);
+	}
+}
+
+void parallelFor (int count, ParallelTask task, void* context) {
+	ParallelWork work;
+	work.task = task;
+	work.context = context;
+	work.count = count;
+	work.next = 0;
+
+	sf::Thread* threads[PARALLEL_THREADS];
+	int threadsCount = std::min(count - 1, PARALLEL_THREADS);
+	for (int i = 0; i < threadsCount; ++i) {
+		threads[i] = new sf::Thread(&runParallelWork, &work);
+		threads[i]->launch();
+	}
+	runParallelWork(&work);
+	for (int i = 0; i < threadsCount; ++i) {
+		threads[i]->wait();
+		delete threads[i];
+	}
+}
+
+AssetCache* getAssetCache () {
+	static AssetCache* cache = 0;
+	if (!cache) {
+		cache = AssetCache_create();
+		cache->parallelFor = parallelFor;
 	}
-	target.draw(*vertexArray, states);
+	return cache;
 }
 
 } /* namespace spine */
@@ -36,6 +36,8 @@
 #include <spine/spine.h>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <vector>
 
 namespace spine {
 
@@ -44,7 +46,12 @@ public:
 	Skeleton* skeleton;
 	AnimationState* state;
 	float timeScale;
-	sf::VertexArray* vertexArray;
+	RenderList* renderList;
+
+	/** Drawn instead of the skeleton, showing the frame for track 0's animation and time, when the drawable is drawn with a scale
+	 * of at most imposterScale. May be 0. See createImposter. */
+	const Imposter* imposter;
+	float imposterScale;
 
 	SkeletonDrawable (SkeletonData* skeleton, AnimationStateData* stateData = 0);
 	~SkeletonDrawable ();
@@ -54,8 +61,68 @@ public:
 	virtual void draw (sf::RenderTarget& target, sf::RenderStates states) const;
 private:
 	bool ownsAnimationStateData;
-	float* worldVertices;
+
+	/* Returns false if the skeleton must be drawn instead. */
+	bool drawImposter (sf::RenderTarget& target, sf::RenderStates states) const;
+};
+
+/** Draws many skeletons with as few draw calls as possible. Skeletons are drawn in z order, then in the order they were added.
+ * Consecutive attachments that use the same texture and blend mode are drawn together, even across skeletons. */
+class SkeletonBatch: public sf::Drawable {
+public:
+	SkeletonBatch ();
+	~SkeletonBatch ();
+
+	/** Adds a skeleton to be drawn at its current world transform, which must be updated before the batch is drawn. The
+	 * skeleton must not be disposed until the batch is cleared. The batch caches the UVs of the attachments it draws, so the
+	 * skeleton data must not be disposed until the batch is cleared or destroyed. */
+	void add (const Skeleton* skeleton, const sf::Transform& transform = sf::Transform::Identity, float z = 0);
+	/** Removes all skeletons and discards the cached UVs. */
+	void clear ();
+
+	virtual void draw (sf::RenderTarget& target, sf::RenderStates states) const;
+
+	/** The number of draw calls and vertices submitted by the last draw. */
+	int getDrawCalls () const;
+	int getVerticesCount () const;
+
+private:
+	struct Entry {
+		const Skeleton* skeleton;
+		sf::Transform transform;
+		float z;
+	};
+	static bool compareZ (const Entry& a, const Entry& b);
+
+	mutable std::vector<Entry> entries;
+	RenderList* renderList;
+	mutable int drawCalls;
+	mutable int verticesCount;
 };
 
+/** Renders the animations of the skeleton into an imposter, using the textures of the skeleton's atlas. Each imposter page gets
+ * an sf::Texture as its rendererObject. The skeleton's pose is lost. Rendering reads the atlas textures back from the GPU and is
+ * slow, so save the imposter with saveImposter and load it with loadImposter afterward. */
+Imposter* createImposter (Skeleton* skeleton, Animation** animations, int animationsCount, float framesPerSecond, float scale);
+/** Writes the imposter with Imposter_writeBinary. Returns false if the file can't be written. */
+bool saveImposter (const Imposter* imposter, const char* path);
+/** Loads an imposter written by saveImposter for the skeleton data and creates its textures. Returns 0 if the file can't be read,
+ * is not an imposter or has animations the skeleton data doesn't. */
+Imposter* loadImposter (const char* path, const SkeletonData* skeletonData);
+/** Disposes of the imposter and its textures. */
+void disposeImposter (Imposter* imposter);
+
+/** Creates a job that loads an atlas and skeleton data without blocking. LoadJob_run decodes the page images into sf::Images and
+ * can be run on an sf::Thread, LoadJob_update creates the sf::Textures and must be called on the thread drawing. */
+LoadJob* createLoadJob (const char* atlasPath, const char* skeletonPath);
+
+/** Calls the task on the calling thread and a few sf::Threads. The AssetCache and LoadJobs created here use it to read the
+ * animations of a skeleton file in parallel, it can also be set as the parallelFor of a SkeletonJson. */
+void parallelFor (int count, ParallelTask task, void* context);
+
+/** Returns a cache that can be shared by all the skeletons drawn with SFML, so each skeleton data and atlas file is only read
+ * once. Must only be used on the thread drawing. */
+AssetCache* getAssetCache ();
+
 } /* namespace spine */
 #endif /* SPINE_SFML_H_ */